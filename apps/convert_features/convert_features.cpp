@@ -0,0 +1,87 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include <string>
+#include <vector>
+
+#include "database/list_dir.h"
+#include "features/feature_file.h"
+
+/**
+ * @brief      Replaces the extension of the file by ".bin" and puts it into
+ * the output folder.
+ */
+std::string binaryName(const std::string &filename,
+                       const std::string &outputFolder) {
+  std::string base = filename.substr(filename.find_last_of('/') + 1);
+  size_t dot = base.find_last_of('.');
+  if (dot != std::string::npos) {
+    base = base.substr(0, dot);
+  }
+  return outputFolder + base + ".bin";
+}
+
+int main(int argc, char const *argv[]) {
+  printf("====== Converting features to binary format ========\n");
+  if (argc < 3) {
+    printf(
+        "Not enough input parameters. Proper usage: path2folder "
+        "outputFolder [cnn|vgg] [float32]\n");
+    return 0;
+  }
+  std::string path2folder = argv[1];
+  std::string outputFolder = argv[2];
+  if (outputFolder.back() != '/') {
+    outputFolder += "/";
+  }
+  FeatureTextLayout layout = TEXT_WITH_DIMS;
+  if (argc > 3 && std::string(argv[3]) == "vgg") {
+    layout = TEXT_VALUES_ONLY;
+  }
+  FeatureDType dtype = FLOAT64;
+  if (argc > 4 && std::string(argv[4]) == "float32") {
+    dtype = FLOAT32;
+  }
+
+  std::vector<std::string> featureNames = listDir(path2folder);
+  fprintf(stderr, "[INFO] Converting %lu features \n", featureNames.size());
+  for (const std::string &name : featureNames) {
+    std::vector<double> values;
+    FeatureFileHeader header;
+    if (!loadFeatureValues(name, layout, &values, &header)) {
+      printf("[ERROR] Feature %s cannot be loaded\n", name.c_str());
+      return 1;
+    }
+    const int dims[3] = {static_cast<int>(header.dims[0]),
+                         static_cast<int>(header.dims[1]),
+                         static_cast<int>(header.dims[2])};
+    if (!saveBinaryFeature(binaryName(name, outputFolder), values, dims,
+                           dtype)) {
+      return 1;
+    }
+    fprintf(stderr, ".");
+  }
+  fprintf(stderr, "\n");
+  printf("Done.\n");
+  return 0;
+}
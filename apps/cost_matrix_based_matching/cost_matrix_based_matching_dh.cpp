@@ -27,6 +27,8 @@
 
 #include "database/cost_matrix_database.h"
 #include "database/idatabase.h"
+#include "database/sparse_cost_matrix_database.h"
+#include "database/tiled_cost_matrix_database.h"
 #include "online_localizer/ilocvisualizer.h"
 #include "online_localizer/online_localizer.h"
 #include "successor_manager/successor_manager.h"
@@ -52,8 +54,30 @@ int main(int argc, char *argv[]) {
   parser.print();
 
 
-  auto databasePtr = CostMatrixDatabase::Ptr(new CostMatrixDatabase);
-  databasePtr->loadFromTxt(parser.costMatrix);
+  OnlineDatabase::Ptr databasePtr = nullptr;
+  CostMatrixDatabase::Ptr fullMatrixPtr = nullptr;
+  if (TiledCostMatrix::isTiledCostMatrix(parser.costMatrix)) {
+    // matrices larger than the RAM are read tile by tile
+    auto tiledPtr = TiledCostMatrixDatabase::Ptr(new TiledCostMatrixDatabase);
+    if (!tiledPtr->loadFromFile(parser.costMatrix)) {
+      exit(EXIT_FAILURE);
+    }
+    databasePtr = tiledPtr;
+  } else if (SparseCostMatrix::isSparseCostMatrix(parser.costMatrix)) {
+    // only the plausible matches are stored
+    auto sparsePtr =
+        SparseCostMatrixDatabase::Ptr(new SparseCostMatrixDatabase);
+    if (!sparsePtr->loadFromFile(parser.costMatrix)) {
+      exit(EXIT_FAILURE);
+    }
+    databasePtr = sparsePtr;
+  } else {
+    fullMatrixPtr = CostMatrixDatabase::Ptr(new CostMatrixDatabase);
+    if (!fullMatrixPtr->loadFromFile(parser.costMatrix)) {
+      exit(EXIT_FAILURE);
+    }
+    databasePtr = fullMatrixPtr;
+  }
   // to obtain the features, when needed
   databasePtr->setQuFeaturesFolder(parser.path2qu);
   databasePtr->setBufferSize(parser.bufferSize);
@@ -74,10 +98,13 @@ int main(int argc, char *argv[]) {
   successorManagerPtr->setSimilarPlaces(parser.simPlaces);
   successorManagerPtr->setRelocalizer(relocalizerPtr);
 
-  // set the visualizer
-  auto visPtr = FullMatrixVisualizer::Ptr(new FullMatrixVisualizer);
-  visPtr->setOutImageName(parser.costOutputName);
-  visPtr->setDatabase(databasePtr);
+  // set the visualizer. Only a matrix that fits in the RAM can be shown
+  FullMatrixVisualizer::Ptr visPtr = nullptr;
+  if (fullMatrixPtr) {
+    visPtr = FullMatrixVisualizer::Ptr(new FullMatrixVisualizer);
+    visPtr->setOutImageName(parser.costOutputName);
+    visPtr->setDatabase(fullMatrixPtr);
+  }
 
   // create localizer and run it
   OnlineLocalizer localizer;
@@ -85,7 +112,10 @@ int main(int argc, char *argv[]) {
   localizer.setSuccessorManager(successorManagerPtr);
   localizer.setExpansionRate(parser.expansionRate);
   localizer.setNonMatchingCost(parser.nonMatchCost);
-  localizer.setVisualizer(visPtr);
+  localizer.setAdaptiveFanOut(parser.adaptiveFanOut);
+  if (visPtr) {
+    localizer.setVisualizer(visPtr);
+  }
   localizer.run();
 
   std::string pathFile = "matched_path.txt";
@@ -30,14 +30,32 @@
 #include <opencv2/highgui/highgui.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 
+#include "database/cost_matrix_file.h"
 #include "database/list_dir.h"
+#include "database/sparse_cost_matrix.h"
+#include "features/dot_kernels.h"
+#include "features/feature_archive.h"
 #include "features/feature_buffer.h"
 #include "features/feature_factory.h"
+#include "features/feature_view.h"
 #include "features/ifeature.h"
 #include "tools/config_parser/config_parser.h"
 
 FeatureBuffer loadFeatures(const std::string &path2folder,
                            const FeatureFactory &factory) {
+  if (FeatureArchive::isArchive(path2folder)) {
+    auto archive = std::make_shared<FeatureArchive>();
+    if (!archive->open(path2folder)) {
+      exit(EXIT_FAILURE);
+    }
+    FeatureBuffer buffer;
+    buffer.setBufferSize(archive->size());
+    for (int i = 0; i < archive->size(); ++i) {
+      buffer.addFeature(i, std::make_shared<FeatureView>(archive, i));
+    }
+    printf("Features were mapped from the archive %s\n", path2folder.c_str());
+    return buffer;
+  }
   std::vector<std::string> featureNames = listDir(path2folder);
   FeatureBuffer buffer;
   buffer.setBufferSize(featureNames.size());
@@ -81,11 +99,12 @@ int main(int argc, char const *argv[]) {
   FeatureBuffer quFeatures = loadFeatures(config.path2qu, factory);
   FeatureBuffer refFeatures = loadFeatures(config.path2ref, factory);
 
-  int querySize = quFeatures.bufferSize;
-  int refSize = refFeatures.bufferSize;
+  int querySize = quFeatures.size();
+  int refSize = refFeatures.size();
 
   cv::Mat scores(querySize, refSize, CV_32FC1);
-  printf("Computing similarity matrix..\n");
+  printf("Computing similarity matrix with the %s kernel..\n",
+         dotKernelName(activeDotKernel()));
   for (int r = 0; r < querySize; ++r) {
     auto rowFeaturePtr = quFeatures.getFeature(r);
     for (int c = 0; c < refSize; ++c) {
@@ -106,13 +125,48 @@ int main(int argc, char const *argv[]) {
 
   std::string cost_png = "cost_matrix" + std::to_string(querySize) + "_" +
                          std::to_string(refSize) + ".png";
-  std::ofstream out(outputCostName);
-  out << scores.rows << " " << scores.cols << "\n";
-  for (int r = 0; r < scores.rows; ++r) {
-    for (int c = 0; c < scores.cols; ++c) {
-      out << scores.at<float>(r, c) << " ";
+  auto endsWith = [&outputCostName](const std::string &ext) {
+    return outputCostName.size() >= ext.size() &&
+           outputCostName.compare(outputCostName.size() - ext.size(),
+                                  ext.size(), ext) == 0;
+  };
+  if (endsWith(".npy")) {
+    saveCostMatrixNpy(outputCostName, scores.ptr<float>(0), scores.rows,
+                      scores.cols);
+  } else if (endsWith(".csr")) {
+    SparseCostMatrixBuilder builder(scores.cols, config.sparseThreshold,
+                                    config.sparseFallbackCost);
+    for (int r = 0; r < scores.rows; ++r) {
+      builder.addRow(scores.ptr<float>(r));
+    }
+    builder.save(outputCostName);
+    printf("[INFO] %zu of %d cells are stored\n", builder.nonZeros(),
+           scores.rows * scores.cols);
+  } else if (endsWith(".bin")) {
+    CostDType dtype = COST_FLOAT32;
+    if (config.costType == "float16") {
+      dtype = COST_FLOAT16;
+    } else if (config.costType == "uint8") {
+      dtype = COST_UINT8;
+    } else if (config.costType == "uint16") {
+      dtype = COST_UINT16;
+    } else if (config.costType != "float32") {
+      printf("[ERROR] Unknown costType %s\n", config.costType.c_str());
+      return 0;
+    }
+    CostScaling scaling =
+        config.costScaling == "global" ? COST_GLOBAL : COST_PER_ROW;
+    saveCostMatrix(outputCostName, scores.ptr<float>(0), scores.rows,
+                   scores.cols, dtype, scaling);
+  } else {
+    std::ofstream out(outputCostName);
+    out << scores.rows << " " << scores.cols << "\n";
+    for (int r = 0; r < scores.rows; ++r) {
+      for (int c = 0; c < scores.cols; ++c) {
+        out << scores.at<float>(r, c) << " ";
+      }
+      out << "\n";
     }
-    out << "\n";
   }
   printf("The matrix was saved to the file %s\n", outputCostName.c_str());
 
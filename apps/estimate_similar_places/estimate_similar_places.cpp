@@ -27,6 +27,7 @@
 #include <limits>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "database/list_dir.h"
@@ -34,6 +35,7 @@
 #include "features/ifeature.h"
 #include "features/cnn_feature_mean.h"
 #include "features/vgg_feature_mean.h"
+#include "successor_manager/similar_places.h"
 // #include "relocalizers/lsh_cv_hashing.h"
 
 std::vector<iBinarizableFeature::Ptr> readFeatures(
@@ -75,7 +77,7 @@ int main(int argc, char const *argv[]) {
   if (argc < 4) {
     printf("[ERROR] Not enough input parameters\n");
     printf(
-        "Proper usage: ./estimate_similar_places path2ref outputFile(.txt) "
+        "Proper usage: ./estimate_similar_places path2ref outputFile(.txt|.bin) "
         "nonMatchCost\n");
     return 1;
   }
@@ -84,10 +86,17 @@ int main(int argc, char const *argv[]) {
   float nonMatchCost = atof(argv[3]);
   std::vector<iBinarizableFeature::Ptr> featurePtrs = readFeatures(path2ref);
 
-  std::ofstream out(outputFile);
-  if (!out) {
-    printf("[ERROR} File %s cannot be opened\n", outputFile.c_str());
-    return 1;
+  // the binary similar places are written at the end
+  bool binary = outputFile.size() > 4 &&
+                outputFile.compare(outputFile.size() - 4, 4, ".bin") == 0;
+  std::vector<std::pair<int, int> > pairs;
+  std::ofstream out;
+  if (!binary) {
+    out.open(outputFile);
+    if (!out) {
+      printf("[ERROR} File %s cannot be opened\n", outputFile.c_str());
+      return 1;
+    }
   }
 
   // outputting scores for thr debugging
@@ -109,11 +118,23 @@ int main(int argc, char const *argv[]) {
         // accept match
         std::cout<< "\n" << i << " " << j << " " << cost <<std::endl;
 
-        out << i << " " << j << std::endl;
+        if (binary) {
+          pairs.push_back(std::make_pair(i, j));
+        } else {
+          out << i << " " << j << std::endl;
+        }
       }
     }
   }
   outScore.close();
-  out.close();
+  if (binary) {
+    SimilarPlaces simPlaces;
+    simPlaces.build(pairs);
+    if (!simPlaces.save(outputFile)) {
+      return 1;
+    }
+  } else {
+    out.close();
+  }
   return 0;
 }
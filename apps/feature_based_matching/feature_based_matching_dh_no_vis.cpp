@@ -50,11 +50,21 @@ int main(int argc, char *argv[]) {
   online_database.setRefFeaturesFolder(parser.path2ref);
   online_database.setQuFeaturesFolder(parser.path2qu);
   online_database.setBufferSize(parser.bufferSize);
+  online_database.setBufferMemory(size_t(parser.bufferMemory) << 20);
+  online_database.setPrefetching(parser.prefetch);
   online_database.setFeatureType(
       FeatureFactory::FeatureType::Cnn_Feature);
       //[VGG] uncomment this to use vgg features
       // FeatureFactory::FeatureType::Vgg_Feature);
+  // uncomment to keep the features in less memory. Costs near the
+  // nonMatchCost are then recomputed exactly
+  // online_database.setStorageType(FeatureFactory::StorageType::Int8);
+  // online_database.setExactRescoring(parser.nonMatchCost, 0.05);
 
+  if (!parser.costCache.empty()) {
+    // reuses the costs computed by the previous runs
+    online_database.setCostCache(parser.costCache);
+  }
   if (!online_database.isSet()) {
     printf("[ERROR] database is not set completely\n");
     return false;
@@ -79,6 +89,12 @@ int main(int argc, char *argv[]) {
   localizer.setSuccessorManager(successorManagerPtr);
   localizer.setExpansionRate(parser.expansionRate);  // expand everything
   localizer.setNonMatchingCost(parser.nonMatchCost);
+  localizer.setAdaptiveFanOut(parser.adaptiveFanOut);
+  if (parser.expansionThreads > 1) {
+    // computes the successor costs of each query image in parallel
+    successorManagerPtr->setNumThreads(parser.expansionThreads);
+    localizer.setRowBatching(true);
+  }
 
   localizer.run();
   localizer.printPath(parser.pathFile);
@@ -82,11 +82,17 @@ int main(int argc, char *argv[]) {
   online_database.setRefFeaturesFolder(parser.path2ref);
   online_database.setQuFeaturesFolder(parser.path2qu);
   online_database.setBufferSize(parser.bufferSize);
+  online_database.setBufferMemory(size_t(parser.bufferMemory) << 20);
+  online_database.setPrefetching(parser.prefetch);
   // online_database.setFeatureType(FeatureFactory::FeatureType::Cnn_Feature_Mean);
   online_database.setFeatureType(FeatureFactory::FeatureType::Cnn_Feature_Mean);
   // [VGG] Uncomment this to use vgg features
   // FeatureFactory::FeatureType::Vgg_Feature_Mean);
 
+  if (!parser.costCache.empty()) {
+    // reuses the costs computed by the previous runs
+    online_database.setCostCache(parser.costCache);
+  }
   if (!online_database.isSet()) {
     printf("[ERROR] database is not set completely\n");
     return false;
@@ -139,6 +145,12 @@ int main(int argc, char *argv[]) {
   localizer.setSuccessorManager(successorManagerPtr);
   localizer.setExpansionRate(parser.expansionRate);  // expand everything
   localizer.setNonMatchingCost(parser.nonMatchCost);
+  localizer.setAdaptiveFanOut(parser.adaptiveFanOut);
+  if (parser.expansionThreads > 1) {
+    // computes the successor costs of each query image in parallel
+    successorManagerPtr->setNumThreads(parser.expansionThreads);
+    localizer.setRowBatching(true);
+  }
   if (visualizer->isReady()) {
     localizer.setVisualizer(visPtr);
   }
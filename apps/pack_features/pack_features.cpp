@@ -0,0 +1,88 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include <string>
+#include <vector>
+
+#include "database/list_dir.h"
+#include "features/cnn_feature.h"
+#include "features/feature_archive.h"
+#include "features/feature_factory.h"
+#include "features/vgg_feature.h"
+
+int main(int argc, char const *argv[]) {
+  printf("====== Packing features into an archive ========\n");
+  if (argc < 3) {
+    printf(
+        "Not enough input parameters. Proper usage: path2folder "
+        "archive.bin [cnn|vgg|cnn_mean|vgg_mean]\n");
+    return 0;
+  }
+  std::string path2folder = argv[1];
+  std::string archiveName = argv[2];
+  FeatureFactory factory;
+  factory.setFeatureType(FeatureFactory::FeatureType::Cnn_Feature);
+  if (argc > 3) {
+    std::string type = argv[3];
+    if (type == "vgg") {
+      factory.setFeatureType(FeatureFactory::FeatureType::Vgg_Feature);
+    } else if (type == "cnn_mean") {
+      factory.setFeatureType(FeatureFactory::FeatureType::Cnn_Feature_Mean);
+    } else if (type == "vgg_mean") {
+      factory.setFeatureType(FeatureFactory::FeatureType::Vgg_Feature_Mean);
+    }
+  }
+
+  std::vector<std::string> featureNames = listDir(path2folder);
+  FeatureArchiveWriter writer;
+  if (!writer.open(archiveName, featureNames.size(), factory.featureType())) {
+    return 1;
+  }
+  fprintf(stderr, "[INFO] Packing %lu features \n", featureNames.size());
+  for (const std::string &name : featureNames) {
+    iFeature::Ptr featurePtr = factory.createFeature();
+    featurePtr->loadFromFile(name);
+    // the binarized features are stored as well, they are used for
+    // relocalization
+    const std::vector<double> *dim = nullptr;
+    const BitCode *bits = nullptr;
+    if (auto cnn = std::dynamic_pointer_cast<CnnFeature>(featurePtr)) {
+      dim = &cnn->dim;
+      bits = &cnn->bits;
+    } else if (auto vgg = std::dynamic_pointer_cast<VggFeature>(featurePtr)) {
+      dim = &vgg->dim;
+      bits = &vgg->bits;
+    }
+    if (!dim || !writer.add(*dim, bits)) {
+      printf("[ERROR] Feature %s cannot be packed\n", name.c_str());
+      return 1;
+    }
+    fprintf(stderr, ".");
+  }
+  fprintf(stderr, "\n");
+  if (!writer.close()) {
+    return 1;
+  }
+  printf("The archive was saved to %s\n", archiveName.c_str());
+  return 0;
+}
@@ -0,0 +1,53 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include <stdlib.h>
+#include <string>
+
+#include "database/cost_matrix_file.h"
+#include "database/tiled_cost_matrix.h"
+
+int main(int argc, char const *argv[]) {
+  printf("====== Converting cost matrix into tiles ========\n");
+  if (argc < 3) {
+    printf(
+        "Not enough input parameters. Proper usage: matrix.bin|matrix.npy "
+        "output.tiles [tileSize=256]\n");
+    return 0;
+  }
+  std::string inputName = argv[1];
+  std::string outputName = argv[2];
+  int tileSize = argc > 3 ? atoi(argv[3]) : 256;
+
+  CostMatrixFile matrix;
+  if (!matrix.open(inputName)) {
+    return 1;
+  }
+  printf("The matrix has %d rows and %d cols\n", matrix.rows(),
+         matrix.cols());
+  if (!saveTiledCostMatrix(matrix, outputName, tileSize)) {
+    return 1;
+  }
+  printf("The tiles were saved to the file %s\n", outputName.c_str());
+  return 0;
+}
@@ -0,0 +1,104 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include "database/list_dir.h"
+#include "features/cnn_feature.h"
+#include "features/feature_factory.h"
+#include "features/product_quantizer.h"
+#include "features/vgg_feature.h"
+
+std::vector<double> loadValues(const std::string &name,
+                               const FeatureFactory &factory) {
+  iFeature::Ptr featurePtr = factory.createFeature();
+  featurePtr->loadFromFile(name);
+  if (auto cnn = std::dynamic_pointer_cast<CnnFeature>(featurePtr)) {
+    return cnn->dim;
+  }
+  if (auto vgg = std::dynamic_pointer_cast<VggFeature>(featurePtr)) {
+    return vgg->dim;
+  }
+  printf("[ERROR] Feature %s cannot be quantized\n", name.c_str());
+  exit(EXIT_FAILURE);
+}
+
+int main(int argc, char const *argv[]) {
+  printf("====== Training product quantizer for references ========\n");
+  if (argc < 3) {
+    printf(
+        "Not enough input parameters. Proper usage: path2refFolder "
+        "output.pq [numSubspaces=32] [numCentroids=256] "
+        "[maxTrainSamples=2000] [cnn|vgg]\n");
+    return 0;
+  }
+  std::string path2folder = argv[1];
+  std::string outputName = argv[2];
+  int numSubspaces = argc > 3 ? atoi(argv[3]) : 32;
+  int numCentroids = argc > 4 ? atoi(argv[4]) : 256;
+  int maxTrainSamples = argc > 5 ? atoi(argv[5]) : 2000;
+  FeatureFactory factory;
+  factory.setFeatureType(FeatureFactory::FeatureType::Cnn_Feature);
+  if (argc > 6 && std::string(argv[6]) == "vgg") {
+    factory.setFeatureType(FeatureFactory::FeatureType::Vgg_Feature);
+  }
+
+  ProductQuantizer quantizer;
+  if (!quantizer.setParams(numSubspaces, numCentroids)) {
+    return 1;
+  }
+  std::vector<std::string> featureNames = listDir(path2folder);
+  if (featureNames.empty() || maxTrainSamples < 1) {
+    printf("[ERROR] No features for training\n");
+    return 1;
+  }
+  // features evenly spread over the sequence are used for training
+  size_t step = featureNames.size() / maxTrainSamples + 1;
+  std::vector<std::vector<double> > samples;
+  for (size_t i = 0; i < featureNames.size(); i += step) {
+    samples.push_back(loadValues(featureNames[i], factory));
+    fprintf(stderr, ".");
+  }
+  fprintf(stderr, "\n[INFO] Training on %lu features\n", samples.size());
+  if (!quantizer.train(samples)) {
+    return 1;
+  }
+  samples.clear();
+
+  PqReferenceStore store;
+  store.setQuantizer(quantizer);
+  fprintf(stderr, "[INFO] Encoding %lu features \n", featureNames.size());
+  for (const std::string &name : featureNames) {
+    store.add(loadValues(name, factory));
+    fprintf(stderr, ".");
+  }
+  fprintf(stderr, "\n");
+  if (!store.save(outputName)) {
+    return 1;
+  }
+  printf("The references were saved to %s, %lu bytes per reference\n",
+         outputName.c_str(), store.bytesPerReference());
+  return 0;
+}
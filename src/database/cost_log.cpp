@@ -0,0 +1,187 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include "database/cost_log.h"
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+namespace {
+bool lessKey(const CostLogRecord &a, const CostLogRecord &b) {
+  return a.quId < b.quId || (a.quId == b.quId && a.refId < b.refId);
+}
+}  // namespace
+
+uint64_t hashBytes(const void *data, size_t size, uint64_t hash) {
+  const uint8_t *bytes = static_cast<const uint8_t *>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+CostLog::~CostLog() { flush(); }
+
+bool CostLog::open(const std::string &filename, uint64_t fingerprint) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  flushLocked();
+  _out.close();
+  _filename = filename;
+  _fingerprint = fingerprint;
+  _loaded.clear();
+
+  bool damaged = false;
+  std::vector<CostLogRecord> records;
+  bool valid = readRecords(&records, &damaged);
+  size_t recordCount = records.size();
+  _loaded.swap(records);
+  deduplicate(&_loaded);
+  if (!valid || damaged || recordCount > 2 * _loaded.size()) {
+    if (!valid) {
+      printf("[INFO][CostLog] Starting a new cost log %s\n", filename.c_str());
+    }
+    if (!writeLog(_loaded)) {
+      return false;
+    }
+  }
+  printf("[INFO][CostLog] Loaded %zu costs from %s\n", _loaded.size(),
+         filename.c_str());
+  _out.open(filename, std::ios::binary | std::ios::app);
+  if (!_out) {
+    printf("[ERROR][CostLog] The file cannot be opened %s\n",
+           filename.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool CostLog::readRecords(std::vector<CostLogRecord> *records,
+                          bool *damaged) const {
+  std::ifstream in(_filename, std::ios::binary);
+  CostLogHeader header;
+  if (!in || !in.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+      memcmp(header.magic, kCostLogMagic, sizeof(header.magic)) != 0 ||
+      header.version != kCostLogVersion ||
+      header.fingerprint != _fingerprint) {
+    return false;
+  }
+  CostLogRecord record;
+  while (in.read(reinterpret_cast<char *>(&record), sizeof(record))) {
+    records->push_back(record);
+  }
+  // a part of a record, the last write was interrupted
+  *damaged = in.gcount() != 0;
+  return true;
+}
+
+void CostLog::deduplicate(std::vector<CostLogRecord> *records) {
+  std::stable_sort(records->begin(), records->end(), lessKey);
+  size_t kept = 0;
+  for (size_t i = 0; i < records->size(); ++i) {
+    bool last = i + 1 == records->size() ||
+                lessKey((*records)[i], (*records)[i + 1]);
+    if (last) {
+      (*records)[kept++] = (*records)[i];
+    }
+  }
+  records->resize(kept);
+}
+
+bool CostLog::writeLog(const std::vector<CostLogRecord> &records) const {
+  // written next to the log and renamed, so the log is never half written
+  std::string tmpName = _filename + ".tmp";
+  std::ofstream out(tmpName, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    printf("[ERROR][CostLog] The file cannot be opened %s\n", tmpName.c_str());
+    return false;
+  }
+  CostLogHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kCostLogMagic, sizeof(kCostLogMagic));
+  header.version = kCostLogVersion;
+  header.fingerprint = _fingerprint;
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char *>(records.data()),
+            records.size() * sizeof(CostLogRecord));
+  out.close();
+  if (!out || rename(tmpName.c_str(), _filename.c_str()) != 0) {
+    printf("[ERROR][CostLog] The file cannot be written %s\n",
+           _filename.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool CostLog::find(int quId, int refId, double *cost) const {
+  CostLogRecord key = {quId, refId, 0.0};
+  auto found = std::lower_bound(_loaded.begin(), _loaded.end(), key, lessKey);
+  if (found == _loaded.end() || found->quId != quId ||
+      found->refId != refId) {
+    return false;
+  }
+  *cost = found->cost;
+  return true;
+}
+
+void CostLog::append(int quId, int refId, double cost) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (!_out.is_open()) {
+    return;
+  }
+  _pending.push_back({quId, refId, cost});
+  if (_pending.size() >= kBlockSize) {
+    flushLocked();
+  }
+}
+
+void CostLog::flush() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  flushLocked();
+}
+
+void CostLog::flushLocked() {
+  if (_pending.empty() || !_out.is_open()) {
+    return;
+  }
+  _out.write(reinterpret_cast<const char *>(_pending.data()),
+             _pending.size() * sizeof(CostLogRecord));
+  _out.flush();
+  _pending.clear();
+}
+
+bool CostLog::compact() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (!_out.is_open()) {
+    return false;
+  }
+  flushLocked();
+  _out.close();
+  bool damaged = false;
+  std::vector<CostLogRecord> records;
+  readRecords(&records, &damaged);
+  deduplicate(&records);
+  bool written = writeLog(records);
+  _out.open(_filename, std::ios::binary | std::ios::app);
+  return written && static_cast<bool>(_out);
+}
@@ -0,0 +1,123 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#ifndef SRC_DATABASE_COST_LOG_H_
+#define SRC_DATABASE_COST_LOG_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Cost log layout: a 64 byte CostLogHeader followed by CostLogRecord
+ * entries in the order they were computed. A cost may appear more than once,
+ * the last record wins.
+ */
+struct CostLogHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t reserved0;
+  // fingerprint of the matched feature sets, see CostLog::open
+  uint64_t fingerprint;
+  uint64_t reserved[5];
+};
+
+struct CostLogRecord {
+  int32_t quId;
+  int32_t refId;
+  double cost;
+};
+
+const char kCostLogMagic[8] = {'V', 'P', 'R', 'C', 'L', 'O', 'G', '\0'};
+const uint32_t kCostLogVersion = 1;
+
+/** FNV-1a hash of the bytes, continues from `hash` **/
+uint64_t hashBytes(const void *data, size_t size,
+                   uint64_t hash = 14695981039346656037ULL);
+
+/**
+ * @brief      Persistent cache of the computed costs, so the features do not
+ * have to be matched again when the same sequences are matched with other
+ * parameters. The costs of the previous runs are loaded on opening, the new
+ * costs are appended to the log. Appending is thread-safe.
+ */
+class CostLog {
+ public:
+  using Ptr = std::shared_ptr<CostLog>;
+  using ConstPtr = std::shared_ptr<const CostLog>;
+
+  CostLog() {}
+  /** writes the pending costs **/
+  ~CostLog();
+  CostLog(const CostLog &) = delete;
+  CostLog &operator=(const CostLog &) = delete;
+
+  /**
+   * @brief      Loads the costs from the log. A log written for other
+   * features (a different fingerprint) is started anew. The log is compacted
+   * if most of its records are duplicates or if its end is damaged.
+   *
+   * @param[in]  filename     The filename
+   * @param[in]  fingerprint  Identifies the matched features
+   *
+   * @return     false if the log cannot be written.
+   */
+  bool open(const std::string &filename, uint64_t fingerprint);
+  /** looks up a cost loaded on opening **/
+  bool find(int quId, int refId, double *cost) const;
+  /** appends a new cost, the costs are written in blocks **/
+  void append(int quId, int refId, double cost);
+  /** writes the pending costs to the file **/
+  void flush();
+  /** rewrites the log with the last record of every cost **/
+  bool compact();
+
+  /** number of costs loaded on opening **/
+  size_t loadedCount() const { return _loaded.size(); }
+
+ private:
+  static const size_t kBlockSize = 4096;
+
+  /** reads the records, returns false if the fingerprint is different **/
+  bool readRecords(std::vector<CostLogRecord> *records,
+                   bool *damaged) const;
+  /** sorts the records and keeps the last one of every cost **/
+  static void deduplicate(std::vector<CostLogRecord> *records);
+  bool writeLog(const std::vector<CostLogRecord> &records) const;
+  void flushLocked();
+
+  std::string _filename;
+  uint64_t _fingerprint = 0;
+  // sorted by (quId, refId), not modified after opening
+  std::vector<CostLogRecord> _loaded;
+
+  std::mutex _mutex;
+  std::vector<CostLogRecord> _pending;
+  std::ofstream _out;
+};
+
+#endif  // SRC_DATABASE_COST_LOG_H_
@@ -22,11 +22,98 @@
 **/
 
 #include "cost_matrix_database.h"
+#include <algorithm>
 #include <fstream>
 #include <limits>
 
 CostMatrixDatabase::CostMatrixDatabase() {}
 
+void CostMatrixDatabase::resize(int rows, int cols) {
+  _rows = rows;
+  _cols = cols;
+  _storage = COST_FLOAT32;
+  _costs.assign(size_t(rows) * cols, 0.0);
+  _file = nullptr;
+  _floats = nullptr;
+  _codes8 = nullptr;
+  _codes16 = nullptr;
+  _codeCosts.clear();
+}
+
+void CostMatrixDatabase::setMapped(const CostMatrixFile::Ptr &file) {
+  resize(0, 0);
+  _costs.shrink_to_fit();
+  _rows = file->rows();
+  _cols = file->cols();
+  _storage = file->dtype();
+  _file = file;
+  if (_storage == COST_FLOAT32) {
+    _floats = file->floatData();
+    return;
+  }
+  if (_storage == COST_FLOAT16 || _storage == COST_UINT16) {
+    _codes16 = static_cast<const uint16_t *>(file->data());
+    return;
+  }
+  _codes8 = static_cast<const uint8_t *>(file->data());
+  int tables = file->scaling() == COST_PER_ROW ? _rows : 1;
+  _codeCostsRow = file->scaling() == COST_PER_ROW ? 256 : 0;
+  _codeCosts.resize(size_t(tables) * 256);
+  for (int t = 0; t < tables; ++t) {
+    for (int code = 0; code < 256; ++code) {
+      _codeCosts[size_t(t) * 256 + code] =
+          similarityToCost(file->offset(t) + file->scale(t) * code);
+    }
+  }
+}
+
+bool CostMatrixDatabase::loadFromFile(const std::string &filename) {
+  if (!CostMatrixFile::isCostMatrixFile(filename)) {
+    loadFromTxt(filename);
+    return !_costs.empty();
+  }
+  auto filePtr = std::make_shared<CostMatrixFile>();
+  if (!filePtr->open(filename)) {
+    return false;
+  }
+  const CostMatrixFile &file = *filePtr;
+  printf("[INFO][CostMatrixDatabase] The matrix has %d rows and %d cols\n",
+         file.rows(), file.cols());
+  setMapped(filePtr);
+  printf("[INFO][CostMatrixDatabase] Matrix was mapped\n");
+  return true;
+}
+
+void CostMatrixDatabase::setCosts(const cv::Mat &costs) {
+  resize(costs.rows, costs.cols);
+  for (int r = 0; r < _rows; ++r) {
+    for (int c = 0; c < _cols; ++c) {
+      _costs[size_t(r) * _cols + c] = similarityToCost(costs.at<float>(r, c));
+    }
+  }
+}
+
+cv::Mat CostMatrixDatabase::getCosts() const {
+  cv::Mat costs(_rows, _cols, CV_32FC1);
+  for (int r = 0; r < _rows; ++r) {
+    for (int c = 0; c < _cols; ++c) {
+      double cost = getCostUnchecked(r, c);
+      costs.at<float>(r, c) =
+          cost == std::numeric_limits<double>::max() ? 0.f : 1. / cost;
+    }
+  }
+  return costs;
+}
+
+void CostMatrixDatabase::readTxtValues(std::ifstream *in) {
+  for (size_t i = 0; i < _costs.size(); ++i) {
+    float value;
+    *in >> value;
+    _costs[i] = similarityToCost(value);
+  }
+  printf("[INFO][CostMatrixDatabase] Matrix was read\n");
+}
+
 void CostMatrixDatabase::loadFromTxt(const std::string &filename) {
   std::ifstream in(filename.c_str());
   if (!in) {
@@ -38,20 +125,8 @@ void CostMatrixDatabase::loadFromTxt(const std::string &filename) {
   in >> rows >> cols;
   printf("[INFO][CostMatrixDatabase] The matrix has %d rows and %d cols\n",
          rows, cols);
-  // the only solution that works to reserve space for the Mat. If you know
-  // better working way please let me know.
-  cv::Mat tmp(rows, cols, CV_32FC1);
-  _costs = tmp;
-
-  for (int r = 0; r < rows; ++r) {
-    for (int c = 0; c < cols; ++c) {
-      float value;
-      in >> value;
-      _costs.at<float>(r, c) = value;
-    }
-  }
-  printf("[INFO][CostMatrixDatabase] Matrix was read\n");
-  in.close();
+  resize(rows, cols);
+  readTxtValues(&in);
 }
 
 void CostMatrixDatabase::loadFromTxt(const std::string &filename, int rows,
@@ -64,35 +139,39 @@ void CostMatrixDatabase::loadFromTxt(const std::string &filename, int rows,
   }
   printf("[INFO][CostMatrixDatabase] The matrix has %d rows and %d cols\n",
          rows, cols);
-  // the only solution that works to reserve space for the Mat. If you know
-  // better working way please let me know.
-  cv::Mat tmp(rows, cols, CV_32FC1);
-  _costs = tmp;
-
-  for (int r = 0; r < rows; ++r) {
-    for (int c = 0; c < cols; ++c) {
-      float value;
-      in >> value;
-      _costs.at<float>(r, c) = value;
-    }
-  }
-  printf("[INFO][CostMatrixDatabase] Matrix was read\n");
-  in.close();
+  resize(rows, cols);
+  readTxtValues(&in);
 }
 
-int CostMatrixDatabase::refSize() { return _costs.cols; }
+int CostMatrixDatabase::refSize() { return _cols; }
+
 double CostMatrixDatabase::getCost(int quId, int refId) {
-  if (quId >= _costs.rows || quId < 0) {
+  if (quId >= _rows || quId < 0) {
     printf("[ERROR][CostMatrixDatabase] Invalid query index %d\n", quId);
     return -1;
   }
-  if (refId >= _costs.cols || refId < 0) {
+  if (refId >= _cols || refId < 0) {
     printf("[ERROR][CostMatrixDatabase] Invalid query index %d\n", refId);
     return -1;
   }
-  double value = _costs.at<float>(quId, refId);
-  if (value < 1e-09) {
-    return std::numeric_limits<double>::max();
+  return getCostUnchecked(quId, refId);
+}
+
+void CostMatrixDatabase::getCosts(int quId, const int *refIds, int count,
+                                  double *costs) {
+  if (quId >= _rows || quId < 0) {
+    printf("[ERROR][CostMatrixDatabase] Invalid query index %d\n", quId);
+    std::fill(costs, costs + count, -1.0);
+    return;
+  }
+  for (int i = 0; i < count; ++i) {
+    int refId = refIds[i];
+    // one comparison also catches the negative ids
+    if (static_cast<unsigned>(refId) >= static_cast<unsigned>(_cols)) {
+      printf("[ERROR][CostMatrixDatabase] Invalid query index %d\n", refId);
+      costs[i] = -1;
+      continue;
+    }
+    costs[i] = getCostUnchecked(quId, refId);
   }
-  return 1. / value;
 }
@@ -25,7 +25,11 @@
 #ifndef SRC_DATABASE_COST_MATRIX_DATABASE_H_
 #define SRC_DATABASE_COST_MATRIX_DATABASE_H_
 
+#include <fstream>
+#include <limits>
 #include <string>
+#include <vector>
+#include "database/cost_matrix_file.h"
 #include "database/online_database.h"
 
 #include <opencv2/core/core.hpp>
@@ -33,7 +37,11 @@
 #include <opencv2/imgproc/imgproc.hpp>
 
 /**
- * @brief      Class for cost matrix database. Stores costs as matrix.
+ * @brief      Class for cost matrix database. Stores costs as matrix. The
+ * similarities of text matrices are transformed into the costs once on
+ * loading, so accessing a cost is a single read. Binary and .npy matrices
+ * stay in the memory mapped file and are transformed on access, so only the
+ * pages of the rows the search touches are read.
  */
 class CostMatrixDatabase : public OnlineDatabase {
  public:
@@ -44,9 +52,41 @@ class CostMatrixDatabase : public OnlineDatabase {
   ~CostMatrixDatabase() {}
 
   int refSize() override;
-  /** gets the original cost and transforms it 1/cost **/
+  /** returns the cost 1/similarity. Checks the indices **/
   double getCost(int quId, int refId) override;
+  /** the same as getCost, but the indices are not checked **/
+  double getCostUnchecked(int quId, int refId) const {
+    size_t pos = size_t(quId) * _cols + refId;
+    if (!_file) {
+      return _costs[pos];
+    }
+    switch (_storage) {
+      case COST_FLOAT32:
+        return similarityToCost(_floats[pos]);
+      case COST_FLOAT16:
+        return similarityToCost(halfToFloat(_codes16[pos]));
+      case COST_UINT8:
+        // costs of all 256 codes of the row are precomputed
+        return _codeCosts[_codeCostsRow * quId + _codes8[pos]];
+      default:
+        return similarityToCost(_file->offset(quId) +
+                                _file->scale(quId) * _codes16[pos]);
+    }
+  }
+  /** reads the costs from one row of the matrix **/
+  void getCosts(int quId, const int *refIds, int count,
+                double *costs) override;
 
+  /**
+   * @brief      Loads the matrix from a binary cost matrix or a .npy file
+   * (see cost_matrix_file.h), which are read through a memory mapping. Any
+   * other file is read with loadFromTxt.
+   *
+   * @param[in]  filename  The filename
+   *
+   * @return     false if the file cannot be read.
+   */
+  bool loadFromFile(const std::string &filename);
   /**
    * @brief      Loads a from txt. Expects specific format: First line should
    * contain number of rows and cols
@@ -63,17 +103,46 @@ class CostMatrixDatabase : public OnlineDatabase {
    */
   void loadFromTxt(const std::string &filename, int rows, int cols);
 
-  void setCosts(const cv::Mat &costs) { costs.copyTo(_costs); }
-  /** returns original costs. Use for visualization and testing only **/
-  cv::Mat getCosts() const { return _costs; }
-
- private:
+  /** sets the similarities, format cv::CV_32FC1 **/
+  void setCosts(const cv::Mat &costs);
   /**
-   * Costs are read in format cv::CV_32FC1
+   * @brief      returns original similarities, restored from the costs. Use
+   * for visualization and testing only
    */
-  cv::Mat _costs;
+  cv::Mat getCosts() const;
+
+ private:
+  /** transforms the similarity into the cost 1/similarity **/
+  static double similarityToCost(double value) {
+    if (value < 1e-09) {
+      return std::numeric_limits<double>::max();
+    }
+    return 1. / value;
+  }
+  /** keeps the values in the mapping **/
+  void setMapped(const CostMatrixFile::Ptr &file);
+  void resize(int rows, int cols);
+  /** reads the remaining values of the text file **/
+  void readTxtValues(std::ifstream *in);
+
+  int _rows = 0;
+  int _cols = 0;
+  // row-major costs of text matrices, ready to be returned
+  std::vector<double> _costs;
+
+  // mapped matrices, the type of the stored values
+  CostMatrixFile::Ptr _file = nullptr;
+  CostDType _storage = COST_FLOAT32;
+  const float *_floats = nullptr;
+  const uint8_t *_codes8 = nullptr;
+  // float16 values or uint16 codes
+  const uint16_t *_codes16 = nullptr;
+  // uint8 codes: the costs of the 256 codes, per row or global
+  std::vector<double> _codeCosts;
+  size_t _codeCostsRow = 0;
 };
 
-/** can store only those matrix that fit in the RAM **/
+/** can store only those matrix that fit in the RAM. For bigger ones use
+ * TiledCostMatrixDatabase **/
 
 #endif  // SRC_DATABASE_COST_MATRIX_DATABASE_H_
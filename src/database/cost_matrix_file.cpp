@@ -0,0 +1,401 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include "database/cost_matrix_file.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+namespace {
+const char kNpyMagic[6] = {'\x93', 'N', 'U', 'M', 'P', 'Y'};
+const uint64_t kCostMatrixAlignment = 64;
+
+/** the matrix is indexed with ints **/
+bool validDims(uint64_t rows, uint64_t cols) {
+  const uint64_t kMax = std::numeric_limits<int>::max();
+  return rows > 0 && cols > 0 && rows <= kMax && cols <= kMax;
+}
+
+/** offset of the values in a binary file, rows are checked by validDims **/
+uint64_t valuesOffset(uint64_t rows, CostScaling scaling) {
+  uint64_t offset = sizeof(CostMatrixHeader);
+  if (scaling == COST_PER_ROW) {
+    offset += rows * 2 * sizeof(float);
+  }
+  return (offset + kCostMatrixAlignment - 1) / kCostMatrixAlignment *
+         kCostMatrixAlignment;
+}
+
+/** the range [min, max] of the values, mapped to codes 0..levels-1 **/
+void quantizationRange(const float *values, size_t size, int levels,
+                       float *scale, float *offset) {
+  float minValue = values[0], maxValue = values[0];
+  for (size_t i = 1; i < size; ++i) {
+    minValue = std::min(minValue, values[i]);
+    maxValue = std::max(maxValue, values[i]);
+  }
+  *offset = minValue;
+  *scale = maxValue > minValue ? (maxValue - minValue) / (levels - 1) : 1.f;
+}
+
+/** returns the text after `'key':` in the npy header dictionary **/
+std::string npyValue(const std::string &header, const std::string &key) {
+  size_t pos = header.find("'" + key + "':");
+  if (pos == std::string::npos) {
+    return "";
+  }
+  pos = header.find_first_not_of(' ', pos + key.size() + 3);
+  if (pos == std::string::npos) {
+    return "";
+  }
+  size_t end = header[pos] == '(' ? header.find(')', pos) + 1
+                                  : header.find_first_of(",}", pos);
+  return header.substr(pos, end - pos);
+}
+}  // namespace
+
+float halfToFloat(uint16_t value) {
+  uint32_t sign = uint32_t(value & 0x8000) << 16;
+  uint32_t exp = (value >> 10) & 0x1f;
+  uint32_t mant = value & 0x3ff;
+  uint32_t bits;
+  if (exp == 0) {
+    if (mant == 0) {
+      bits = sign;
+    } else {
+      // subnormal, normalize it
+      exp = 127 - 15 + 1;
+      while ((mant & 0x400) == 0) {
+        mant <<= 1;
+        exp--;
+      }
+      bits = sign | (exp << 23) | ((mant & 0x3ff) << 13);
+    }
+  } else if (exp == 31) {
+    bits = sign | 0x7f800000 | (mant << 13);
+  } else {
+    bits = sign | ((exp + 112) << 23) | (mant << 13);
+  }
+  float result;
+  memcpy(&result, &bits, sizeof(result));
+  return result;
+}
+
+uint16_t floatToHalf(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  uint16_t sign = (bits >> 16) & 0x8000;
+  uint32_t absBits = bits & 0x7fffffff;
+  if (absBits > 0x7f800000) {
+    return sign | 0x7e00;  // NaN
+  }
+  if (absBits >= 0x477ff000) {
+    // rounds to infinity
+    return sign | 0x7c00;
+  }
+  if (absBits < 0x38800000) {
+    // subnormal half, the rounding mode is round to nearest even
+    return sign | static_cast<uint16_t>(nearbyintf(fabsf(value) * 16777216.f));
+  }
+  uint32_t half = (((absBits >> 23) - 112) << 10) | ((absBits >> 13) & 0x3ff);
+  uint32_t rest = absBits & 0x1fff;
+  if (rest > 0x1000 || (rest == 0x1000 && (half & 1))) {
+    half++;
+  }
+  return sign | static_cast<uint16_t>(half);
+}
+
+bool CostMatrixFile::isCostMatrixFile(const std::string &filename) {
+  std::ifstream in(filename, std::ios::binary);
+  char magic[8];
+  if (!in || !in.read(magic, sizeof(magic))) {
+    return false;
+  }
+  return memcmp(magic, kCostMatrixMagic, sizeof(kCostMatrixMagic)) == 0 ||
+         memcmp(magic, kNpyMagic, sizeof(kNpyMagic)) == 0;
+}
+
+bool CostMatrixFile::open(const std::string &filename) {
+  _filename = filename;
+  if (!_file.open(filename)) {
+    printf("[ERROR][CostMatrixFile] The file cannot be opened %s\n",
+           filename.c_str());
+    return false;
+  }
+  bool parsed;
+  if (_file.size() >= sizeof(kNpyMagic) &&
+      memcmp(_file.data(), kNpyMagic, sizeof(kNpyMagic)) == 0) {
+    parsed = parseNpy();
+  } else {
+    parsed = parseBinary();
+  }
+  if (!parsed) {
+    _file.close();
+    return false;
+  }
+  // both are at most INT_MAX, so the product fits
+  uint64_t count = uint64_t(_rows) * uint64_t(_cols);
+  uint64_t available = _file.size() - (_values - _file.data());
+  if (count > available / costValueSize(_dtype)) {
+    printf("[ERROR][CostMatrixFile] The file %s is truncated\n",
+           filename.c_str());
+    _file.close();
+    return false;
+  }
+  return true;
+}
+
+size_t costValueSize(CostDType dtype) {
+  switch (dtype) {
+    case COST_FLOAT32:
+      return sizeof(float);
+    case COST_UINT8:
+      return sizeof(uint8_t);
+    default:
+      return sizeof(uint16_t);
+  }
+}
+
+float CostMatrixFile::at(int row, int col) const {
+  size_t pos = size_t(row) * _cols + col;
+  switch (_dtype) {
+    case COST_FLOAT32:
+      return reinterpret_cast<const float *>(_values)[pos];
+    case COST_FLOAT16:
+      return halfToFloat(reinterpret_cast<const uint16_t *>(_values)[pos]);
+    case COST_UINT8:
+      return offset(row) + scale(row) * _values[pos];
+    default:
+      return offset(row) +
+             scale(row) * reinterpret_cast<const uint16_t *>(_values)[pos];
+  }
+}
+
+bool CostMatrixFile::parseBinary() {
+  CostMatrixHeader &header = _header;
+  if (_file.size() < sizeof(header)) {
+    printf("[ERROR][CostMatrixFile] %s is not a cost matrix\n",
+           _filename.c_str());
+    return false;
+  }
+  memcpy(&header, _file.data(), sizeof(header));
+  if (memcmp(header.magic, kCostMatrixMagic, sizeof(header.magic)) != 0 ||
+      header.version != kCostMatrixVersion) {
+    printf("[ERROR][CostMatrixFile] %s is not a cost matrix\n",
+           _filename.c_str());
+    return false;
+  }
+  if (header.dtype > COST_UINT16) {
+    printf("[ERROR][CostMatrixFile] Unknown value type %u\n", header.dtype);
+    return false;
+  }
+  if (header.scaling > COST_PER_ROW) {
+    printf("[ERROR][CostMatrixFile] Unknown scaling %u\n", header.scaling);
+    return false;
+  }
+  _dtype = static_cast<CostDType>(header.dtype);
+  _scaling = isQuantized(_dtype) ? static_cast<CostScaling>(header.scaling)
+                                 : COST_GLOBAL;
+  if (!validDims(header.rows, header.cols)) {
+    printf("[ERROR][CostMatrixFile] Invalid matrix size in %s\n",
+           _filename.c_str());
+    return false;
+  }
+  _rows = header.rows;
+  _cols = header.cols;
+  uint64_t offset = valuesOffset(header.rows, _scaling);
+  if (offset > _file.size()) {
+    printf("[ERROR][CostMatrixFile] The file %s is truncated\n",
+           _filename.c_str());
+    return false;
+  }
+  _rowScales = reinterpret_cast<const float *>(_file.data() + sizeof(header));
+  _values = _file.data() + offset;
+  return true;
+}
+
+bool CostMatrixFile::parseNpy() {
+  const uint8_t *data = _file.data();
+  if (_file.size() < 10) {
+    return false;
+  }
+  int major = data[6];
+  size_t headerLength, offset;
+  if (major == 1) {
+    headerLength = data[8] | (data[9] << 8);
+    offset = 10;
+  } else {
+    uint32_t length;
+    memcpy(&length, data + 8, sizeof(length));
+    headerLength = length;
+    offset = 12;
+  }
+  if (offset + headerLength > _file.size()) {
+    return false;
+  }
+  std::string header(reinterpret_cast<const char *>(data) + offset,
+                     headerLength);
+  std::string descr = npyValue(header, "descr");
+  memset(&_header, 0, sizeof(_header));
+  _scaling = COST_GLOBAL;
+  if (descr == "'<f4'") {
+    _dtype = COST_FLOAT32;
+  } else if (descr == "'<f2'") {
+    _dtype = COST_FLOAT16;
+  } else {
+    printf("[ERROR][CostMatrixFile] Unsupported npy type %s, use float32\n",
+           descr.c_str());
+    return false;
+  }
+  if (npyValue(header, "fortran_order") != "False") {
+    printf("[ERROR][CostMatrixFile] Only C ordered npy arrays are supported\n");
+    return false;
+  }
+  long rows = 0, cols = 0;
+  if (sscanf(npyValue(header, "shape").c_str(), "(%ld, %ld)", &rows, &cols) !=
+      2) {
+    printf("[ERROR][CostMatrixFile] The npy array should be 2 dimensional\n");
+    return false;
+  }
+  if (rows <= 0 || cols <= 0 || !validDims(rows, cols)) {
+    printf("[ERROR][CostMatrixFile] Invalid size %ld x %ld of %s\n", rows,
+           cols, _filename.c_str());
+    return false;
+  }
+  _rows = rows;
+  _cols = cols;
+  _values = data + offset + headerLength;
+  return true;
+}
+
+const float *CostMatrixFile::floatData() const {
+  if (_dtype != COST_FLOAT32) {
+    return nullptr;
+  }
+  return reinterpret_cast<const float *>(_values);
+}
+
+bool saveCostMatrix(const std::string &filename, const float *costs, int rows,
+                    int cols, CostDType dtype, CostScaling scaling) {
+  std::ofstream out(filename, std::ios::binary);
+  if (!out) {
+    printf("[ERROR][CostMatrixFile] The file cannot be opened %s\n",
+           filename.c_str());
+    return false;
+  }
+  CostMatrixHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kCostMatrixMagic, sizeof(kCostMatrixMagic));
+  header.version = kCostMatrixVersion;
+  header.dtype = dtype;
+  header.rows = rows;
+  header.cols = cols;
+  if (!isQuantized(dtype)) {
+    scaling = COST_GLOBAL;
+  }
+  header.scaling = scaling;
+  int levels = dtype == COST_UINT8 ? 256 : 65536;
+  size_t size = size_t(rows) * cols;
+  // scale and offset of every row
+  std::vector<float> rowScales(2 * rows);
+  if (isQuantized(dtype) && size > 0) {
+    if (scaling == COST_GLOBAL) {
+      quantizationRange(costs, size, levels, &header.scale, &header.offset);
+    } else {
+      for (int r = 0; r < rows; ++r) {
+        quantizationRange(costs + size_t(r) * cols, cols, levels,
+                          &rowScales[2 * r], &rowScales[2 * r + 1]);
+      }
+    }
+  }
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  if (scaling == COST_PER_ROW) {
+    out.write(reinterpret_cast<const char *>(rowScales.data()),
+              rowScales.size() * sizeof(float));
+  }
+  uint64_t written = sizeof(header) + (scaling == COST_PER_ROW
+                                           ? rowScales.size() * sizeof(float)
+                                           : 0);
+  std::vector<char> padding(valuesOffset(rows, scaling) - written, 0);
+  out.write(padding.data(), padding.size());
+
+  if (dtype == COST_FLOAT32) {
+    out.write(reinterpret_cast<const char *>(costs), size * sizeof(float));
+    return static_cast<bool>(out);
+  }
+  std::vector<uint8_t> row(cols * costValueSize(dtype));
+  uint8_t *codes8 = row.data();
+  uint16_t *codes16 = reinterpret_cast<uint16_t *>(row.data());
+  for (int r = 0; r < rows; ++r) {
+    const float *values = costs + size_t(r) * cols;
+    float scale = scaling == COST_PER_ROW ? rowScales[2 * r] : header.scale;
+    float offset =
+        scaling == COST_PER_ROW ? rowScales[2 * r + 1] : header.offset;
+    for (int c = 0; c < cols; ++c) {
+      if (dtype == COST_FLOAT16) {
+        codes16[c] = floatToHalf(values[c]);
+        continue;
+      }
+      long code = lrintf((values[c] - offset) / scale);
+      code = std::max(0L, std::min(long(levels - 1), code));
+      if (dtype == COST_UINT8) {
+        codes8[c] = code;
+      } else {
+        codes16[c] = code;
+      }
+    }
+    out.write(reinterpret_cast<const char *>(row.data()), row.size());
+  }
+  return static_cast<bool>(out);
+}
+
+bool saveCostMatrixNpy(const std::string &filename, const float *costs,
+                       int rows, int cols) {
+  std::ofstream out(filename, std::ios::binary);
+  if (!out) {
+    printf("[ERROR][CostMatrixFile] The file cannot be opened %s\n",
+           filename.c_str());
+    return false;
+  }
+  std::string header = "{'descr': '<f4', 'fortran_order': False, 'shape': (" +
+                       std::to_string(rows) + ", " + std::to_string(cols) +
+                       "), }";
+  // the data should start at a multiple of 64 bytes
+  size_t total = 10 + header.size() + 1;
+  header.append((64 - total % 64) % 64, ' ');
+  header.push_back('\n');
+  uint16_t length = header.size();
+  out.write(kNpyMagic, sizeof(kNpyMagic));
+  out.put(1);
+  out.put(0);
+  out.put(length & 0xff);
+  out.put(length >> 8);
+  out.write(header.data(), header.size());
+  out.write(reinterpret_cast<const char *>(costs),
+            size_t(rows) * cols * sizeof(float));
+  return static_cast<bool>(out);
+}
@@ -0,0 +1,145 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#ifndef SRC_DATABASE_COST_MATRIX_FILE_H_
+#define SRC_DATABASE_COST_MATRIX_FILE_H_
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include "tools/mapped_file/mapped_file.h"
+
+/**
+ * Binary cost matrix format. A file starts with a 64 byte CostMatrixHeader
+ * that is followed by `rows` x `cols` values of type `dtype` in row-major,
+ * native (little endian) byte order.
+ * Quantized values are decoded as offset + scale * code. With COST_PER_ROW
+ * scaling, the header is followed by `rows` pairs of float (scale, offset)
+ * and the codes start at the next 64 byte aligned offset.
+ */
+enum CostDType {
+  COST_FLOAT32 = 0,
+  COST_FLOAT16 = 1,
+  COST_UINT8 = 2,
+  COST_UINT16 = 3
+};
+enum CostScaling { COST_GLOBAL = 0, COST_PER_ROW = 1 };
+
+struct CostMatrixHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t dtype;
+  uint64_t rows;
+  uint64_t cols;
+  // quantization parameters, only used for the integer types
+  uint32_t scaling;
+  float scale;
+  float offset;
+  uint32_t reserved0;
+  uint64_t reserved[2];
+};
+
+const char kCostMatrixMagic[8] = {'V', 'P', 'R', 'C', 'O', 'S', 'T', '\0'};
+const uint32_t kCostMatrixVersion = 1;
+
+float halfToFloat(uint16_t value);
+/** rounds to the nearest half precision value **/
+uint16_t floatToHalf(float value);
+
+/** true for the quantized types **/
+inline bool isQuantized(CostDType dtype) {
+  return dtype == COST_UINT8 || dtype == COST_UINT16;
+}
+
+/**
+ * @brief      Read-only access to a cost matrix stored in the binary format
+ * or in a numpy .npy file ('<f4' or '<f2', C order, 2 dimensions). The file
+ * is memory mapped, only the pages of the accessed rows are read from disk.
+ */
+class CostMatrixFile {
+ public:
+  using Ptr = std::shared_ptr<CostMatrixFile>;
+  using ConstPtr = std::shared_ptr<const CostMatrixFile>;
+
+  /** checks if the file is a binary or .npy cost matrix **/
+  static bool isCostMatrixFile(const std::string &filename);
+
+  bool open(const std::string &filename);
+  int rows() const { return _rows; }
+  int cols() const { return _cols; }
+  CostDType dtype() const { return _dtype; }
+  CostScaling scaling() const { return _scaling; }
+
+  /** row-major values. Only for COST_FLOAT32, nullptr otherwise **/
+  const float *floatData() const;
+  /** row-major raw values: floats, halfs or codes depending on dtype **/
+  const void *data() const { return _values; }
+  /** decoding parameters of the quantized row, value = offset + scale * code **/
+  float scale(int row) const {
+    return _scaling == COST_PER_ROW ? _rowScales[2 * row] : _header.scale;
+  }
+  float offset(int row) const {
+    return _scaling == COST_PER_ROW ? _rowScales[2 * row + 1] : _header.offset;
+  }
+  /** decoded value of any type **/
+  float at(int row, int col) const;
+
+ private:
+  bool parseBinary();
+  bool parseNpy();
+
+  MappedFile _file;
+  std::string _filename;
+  CostMatrixHeader _header;
+  const uint8_t *_values = nullptr;
+  const float *_rowScales = nullptr;
+  int _rows = 0;
+  int _cols = 0;
+  CostDType _dtype = COST_FLOAT32;
+  CostScaling _scaling = COST_GLOBAL;
+};
+
+size_t costValueSize(CostDType dtype);
+
+/**
+ * @brief      Saves the row-major costs in the binary format. The integer
+ * types map the range [min, max] of the matrix (or of every row) linearly to
+ * all codes.
+ *
+ * @param[in]  filename  The filename
+ * @param[in]  costs     The costs
+ * @param[in]  rows      The rows
+ * @param[in]  cols      The cols
+ * @param[in]  dtype     The stored type
+ * @param[in]  scaling   The quantization range, only for the integer types
+ *
+ * @return     false if the file cannot be written.
+ */
+bool saveCostMatrix(const std::string &filename, const float *costs, int rows,
+                    int cols, CostDType dtype = COST_FLOAT32,
+                    CostScaling scaling = COST_PER_ROW);
+/** saves the row-major costs as a float32 .npy file **/
+bool saveCostMatrixNpy(const std::string &filename, const float *costs,
+                       int rows, int cols);
+
+#endif  // SRC_DATABASE_COST_MATRIX_FILE_H_
@@ -0,0 +1,160 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include "database/feature_cache.h"
+#include <algorithm>
+
+FeatureCache::FeatureCache(int shards) { reset(shards); }
+
+FeatureCache::FeatureCache(const FeatureCache &other)
+    : _bufferSize(other._bufferSize), _memoryBudget(other._memoryBudget) {
+  reset(other._shards.size());
+}
+
+FeatureCache &FeatureCache::operator=(const FeatureCache &other) {
+  if (this != &other) {
+    _bufferSize = other._bufferSize;
+    _memoryBudget = other._memoryBudget;
+    reset(other._shards.size());
+  }
+  return *this;
+}
+
+void FeatureCache::reset(int shards) {
+  _shards.clear();
+  for (int i = 0; i < std::max(1, shards); ++i) {
+    _shards.emplace_back(new Shard);
+  }
+  _usedShards = _shards.size();
+  setBufferSize(_bufferSize);
+}
+
+void FeatureCache::setBufferSize(int size) {
+  _bufferSize = size;
+  int shards = _shards.size();
+  // a buffer smaller than the number of shards uses fewer shards, so that
+  // every used shard keeps a feature and the total stays within the size
+  int usedShards = size > 0 ? std::min(size, shards) : shards;
+  if (usedShards != _usedShards) {
+    // the ids move to other shards, the cached features are dropped
+    for (auto &shard : _shards) {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      shard->buffer = FeatureBuffer();
+    }
+    _usedShards = usedShards;
+  }
+  for (int i = 0; i < shards; ++i) {
+    std::lock_guard<std::mutex> lock(_shards[i]->mutex);
+    _shards[i]->buffer.setBufferSize(
+        size < 0 ? size : splitLimit(size, i, usedShards));
+  }
+  setMemoryBudget(_memoryBudget);
+}
+
+void FeatureCache::setMemoryBudget(size_t bytes) {
+  _memoryBudget = bytes;
+  for (int i = 0; i < static_cast<int>(_shards.size()); ++i) {
+    std::lock_guard<std::mutex> lock(_shards[i]->mutex);
+    // at least a byte, 0 would mean no limit
+    size_t budget = bytes > 0 ? std::max<size_t>(
+                                    1, splitLimit(bytes, i, _usedShards))
+                              : 0;
+    _shards[i]->buffer.setMemoryBudget(budget);
+  }
+}
+
+size_t FeatureCache::splitLimit(size_t total, int shard, int usedShards) {
+  if (shard >= usedShards) {
+    return 0;
+  }
+  // the first shards take the remainder, so the limits add up to the total
+  return total / usedShards + (size_t(shard) < total % usedShards ? 1 : 0);
+}
+
+iFeature::ConstPtr FeatureCache::getFeature(int id, const Loader &loader) {
+  Shard &shard = shardOf(id);
+  std::unique_lock<std::mutex> lock(shard.mutex);
+  while (shard.loading.count(id) > 0) {
+    shard.loaded.wait(lock);
+  }
+  iFeature::ConstPtr feature = shard.buffer.getFeature(id);
+  if (feature) {
+    return feature;
+  }
+  shard.loading.insert(id);
+  lock.unlock();
+  feature = loader(id);
+  lock.lock();
+  shard.buffer.addFeature(id, feature);
+  shard.loading.erase(id);
+  shard.loaded.notify_all();
+  return feature;
+}
+
+bool FeatureCache::prefetch(int id, const Loader &loader) {
+  Shard &shard = shardOf(id);
+  std::unique_lock<std::mutex> lock(shard.mutex);
+  if (shard.loading.count(id) > 0 || shard.buffer.inBuffer(id)) {
+    return false;
+  }
+  shard.loading.insert(id);
+  lock.unlock();
+  iFeature::ConstPtr feature = loader(id);
+  lock.lock();
+  shard.buffer.addFeature(id, feature);
+  shard.loading.erase(id);
+  shard.loaded.notify_all();
+  return true;
+}
+
+void FeatureCache::setPinned(const std::vector<int> &ids) {
+  std::vector<std::vector<int>> shardIds(_shards.size());
+  for (int id : ids) {
+    shardIds[id % _usedShards].push_back(id);
+  }
+  for (size_t i = 0; i < _shards.size(); ++i) {
+    std::lock_guard<std::mutex> lock(_shards[i]->mutex);
+    _shards[i]->buffer.setPinned(shardIds[i]);
+  }
+}
+
+FeatureBuffer::Stats FeatureCache::stats() const {
+  FeatureBuffer::Stats total;
+  for (const auto &shard : _shards) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    const FeatureBuffer::Stats &stats = shard->buffer.stats();
+    total.hits += stats.hits;
+    total.misses += stats.misses;
+    total.evictions += stats.evictions;
+  }
+  return total;
+}
+
+int FeatureCache::size() const {
+  int size = 0;
+  for (const auto &shard : _shards) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    size += shard->buffer.size();
+  }
+  return size;
+}
@@ -0,0 +1,102 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#ifndef SRC_DATABASE_FEATURE_CACHE_H_
+#define SRC_DATABASE_FEATURE_CACHE_H_
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+#include "features/feature_buffer.h"
+
+/**
+ * @brief      Thread-safe feature buffer. The ids are split over shards, every
+ * shard is a FeatureBuffer with its own lock, so threads working on
+ * different features rarely wait for each other. A feature is loaded only
+ * once: threads asking for a feature that is being loaded wait for it.
+ */
+class FeatureCache {
+ public:
+  using Ptr = std::shared_ptr<FeatureCache>;
+  using ConstPtr = std::shared_ptr<const FeatureCache>;
+  /** loads the feature with the given id. Called without holding a lock **/
+  using Loader = std::function<iFeature::ConstPtr(int)>;
+
+  static const int kDefaultShards = 16;
+
+  explicit FeatureCache(int shards = kDefaultShards);
+  /** copies the limits, not the features **/
+  FeatureCache(const FeatureCache &other);
+  FeatureCache &operator=(const FeatureCache &other);
+
+  /**
+   * maximal number of features over all the shards. A smaller size than the
+   * number of shards uses only `size` shards. Drops the cached features if
+   * the number of used shards changes. -1 for no limit
+   */
+  void setBufferSize(int size);
+  /** maximal memory in bytes, split over the shards. 0 for no limit **/
+  void setMemoryBudget(size_t bytes);
+
+  /** returns the cached feature, loads it on a miss **/
+  iFeature::ConstPtr getFeature(int id, const Loader &loader);
+  /**
+   * @brief      Loads the feature, if it is neither cached nor being loaded.
+   * Does not count as a hit or a miss.
+   *
+   * @return     true if the feature was loaded.
+   */
+  bool prefetch(int id, const Loader &loader);
+  /** see FeatureBuffer::setPinned **/
+  void setPinned(const std::vector<int> &ids);
+
+  /** statistics of all the shards **/
+  FeatureBuffer::Stats stats() const;
+  int size() const;
+
+ private:
+  struct Shard {
+    std::mutex mutex;
+    // signals that a feature was added to the buffer
+    std::condition_variable loaded;
+    FeatureBuffer buffer;
+    std::unordered_set<int> loading;
+  };
+
+  Shard &shardOf(int id) const { return *_shards[id % _usedShards]; }
+  /** creates the shards and applies the limits **/
+  void reset(int shards);
+  /** part of the limit of the shard, 0 for the unused shards **/
+  static size_t splitLimit(size_t total, int shard, int usedShards);
+
+  int _bufferSize = -1;
+  size_t _memoryBudget = 0;
+  std::vector<std::unique_ptr<Shard>> _shards;
+  // the ids are split over the first _usedShards shards
+  int _usedShards = 1;
+};
+
+#endif  // SRC_DATABASE_FEATURE_CACHE_H_
@@ -0,0 +1,81 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include "database/feature_prefetcher.h"
+
+FeaturePrefetcher::FeaturePrefetcher(FeatureCache *cache,
+                                     const FeatureCache::Loader &loader)
+    : _cache(cache), _loader(loader) {
+  _worker = std::thread(&FeaturePrefetcher::run, this);
+}
+
+FeaturePrefetcher::~FeaturePrefetcher() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stop = true;
+    _pending.clear();
+  }
+  _requested.notify_all();
+  _worker.join();
+}
+
+void FeaturePrefetcher::request(const std::vector<int> &ids) {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    // the old requests are stale, the search has moved on
+    _pending.assign(ids.begin(), ids.end());
+  }
+  _requested.notify_one();
+}
+
+void FeaturePrefetcher::add(const std::vector<int> &ids) {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _pending.insert(_pending.end(), ids.begin(), ids.end());
+  }
+  _requested.notify_one();
+}
+
+int FeaturePrefetcher::prefetchedCount() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _prefetchedCount;
+}
+
+void FeaturePrefetcher::run() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (true) {
+    _requested.wait(lock, [this] { return _stop || !_pending.empty(); });
+    if (_stop) {
+      return;
+    }
+    int id = _pending.front();
+    _pending.pop_front();
+    lock.unlock();
+    // the cache makes sure a feature is not loaded twice
+    bool loaded = _cache->prefetch(id, _loader);
+    lock.lock();
+    if (loaded) {
+      ++_prefetchedCount;
+    }
+  }
+}
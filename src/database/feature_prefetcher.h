@@ -0,0 +1,69 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#ifndef SRC_DATABASE_FEATURE_PREFETCHER_H_
+#define SRC_DATABASE_FEATURE_PREFETCHER_H_
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "database/feature_cache.h"
+
+/**
+ * @brief      Loads features into a FeatureCache on a background thread.
+ */
+class FeaturePrefetcher {
+ public:
+  using Ptr = std::shared_ptr<FeaturePrefetcher>;
+  using ConstPtr = std::shared_ptr<const FeaturePrefetcher>;
+
+  FeaturePrefetcher(FeatureCache *cache, const FeatureCache::Loader &loader);
+  /** stops the background thread, pending requests are dropped **/
+  ~FeaturePrefetcher();
+
+  /** replaces the pending requests with the ids, in this order **/
+  void request(const std::vector<int> &ids);
+  /** adds the ids to the end of the pending requests **/
+  void add(const std::vector<int> &ids);
+  /** number of features loaded by the background thread **/
+  int prefetchedCount() const;
+
+ private:
+  void run();
+
+  FeatureCache *_cache;
+  FeatureCache::Loader _loader;
+
+  mutable std::mutex _mutex;
+  // signals new requests or stopping
+  std::condition_variable _requested;
+  std::deque<int> _pending;
+  int _prefetchedCount = 0;
+  bool _stop = false;
+  std::thread _worker;
+};
+
+#endif  // SRC_DATABASE_FEATURE_PREFETCHER_H_
@@ -46,6 +46,38 @@ class iDatabase {
    * @return     The cost.
    */
   virtual double getCost(int quId, int refId) = 0;
+  /**
+   * @brief      Gets the costs of one query to several references. Databases
+   * override it when a batch is cheaper than separate getCost calls.
+   *
+   * @param[in]  quId    The qu identifier
+   * @param[in]  refIds  The reference identifiers
+   * @param[in]  count   The number of references
+   * @param[out] costs   The costs, `count` values
+   */
+  virtual void getCosts(int quId, const int *refIds, int count,
+                        double *costs) {
+    for (int i = 0; i < count; ++i) {
+      costs[i] = getCost(quId, refIds[i]);
+    }
+  }
+  /**
+   * @brief      Hint that the search is currently expanding the query quId
+   * around the reference refId. Databases may use it to keep these costs
+   * cheap to access. Does nothing by default.
+   *
+   * @param[in]  quId    The qu identifier
+   * @param[in]  refId   The reference identifier
+   * @param[in]  radius  The number of references on each side of refId
+   */
+  virtual void setSearchFocus(int quId, int refId, int radius) {}
+  /** Hint that these references are likely to be matched soon. **/
+  virtual void prefetchRefs(const std::vector<int> &refIds) {}
+  /**
+   * @brief      True if the costs may be requested from several threads at
+   * once and do not depend on the order of the requests.
+   */
+  virtual bool isThreadSafe() const { return false; }
 
   virtual ~iDatabase() {}
 };
@@ -23,16 +23,82 @@
 
 
 #include "database/online_database.h"
+#include <math.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <algorithm>
 #include <fstream>
 #include <limits>
 #include <string>
 #include <vector>
 #include "database/list_dir.h"
+#include "features/feature_view.h"
 #include "tools/timer/timer.h"
 
 using std::string;
 using std::vector;
 
+MatchMap::MatchMap(int retention, int rowCapacity)
+    : _rowCapacity(rowCapacity), _newestQuId(-1) {
+  setRetention(retention);
+}
+
+MatchMap::MatchMap(const MatchMap &other) : _newestQuId(-1) {
+  copyFrom(other);
+}
+
+MatchMap &MatchMap::operator=(const MatchMap &other) {
+  if (this != &other) {
+    copyFrom(other);
+  }
+  return *this;
+}
+
+void MatchMap::copyFrom(const MatchMap &other) {
+  _retention = other._retention;
+  _rowCapacity = other._rowCapacity;
+  allocate();
+  for (size_t i = 0; i < kShards * _shardSize; ++i) {
+    _slots[i].key.store(other._slots[i].key.load());
+    _slots[i].value.store(other._slots[i].value.load());
+  }
+  _newestQuId.store(other._newestQuId.load());
+  _droppedCount.store(other._droppedCount.load());
+}
+
+void MatchMap::setRetention(int retention) {
+  if (retention < 1) {
+    printf("[ERROR][MatchMap] Retention should be at least 1 row\n");
+    exit(EXIT_FAILURE);
+  }
+  _retention = retention;
+  allocate();
+}
+
+void MatchMap::allocate() {
+  size_t slots = std::max(size_t(_retention) * _rowCapacity,
+                          static_cast<size_t>(kShards));
+  _shardSize = (slots + kShards - 1) / kShards;
+  _slots.reset(new Slot[kShards * _shardSize]);
+  for (size_t i = 0; i < kShards * _shardSize; ++i) {
+    _slots[i].key.store(kEmpty, std::memory_order_relaxed);
+    _slots[i].value.store(0, std::memory_order_relaxed);
+  }
+  _shardMutexes.reset(new std::mutex[kShards]);
+  _newestQuId.store(-1);
+  _droppedCount.store(0);
+}
+
+void MatchMap::locate(uint64_t key, size_t *shard, size_t *start) const {
+  // splitmix64 finalizer, the neighbouring keys end up far apart
+  uint64_t hash = key + 0x9e3779b97f4a7c15ULL;
+  hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+  hash ^= hash >> 31;
+  *shard = hash % kShards;
+  *start = (hash / kShards) % _shardSize;
+}
+
 /**
  * @brief      Gets the match cost.
  *
@@ -41,24 +107,135 @@ using std::vector;
  *
  * @return     The match cost. return -1 if cost is not found
  */
-double MatchMap::getMatchCost(int quId, int refId) {
-  auto row_iter = _matches.find(quId);
-  if (row_iter != _matches.end()) {
-    // found
-    auto el_iter = row_iter->second.find(refId);
-    if (el_iter != row_iter->second.end()) {
-      return el_iter->second;
+double MatchMap::getMatchCost(int quId, int refId) const {
+  if (quId < 0 || refId < 0 || isStale(quId)) {
+    return -1.0;
+  }
+  uint64_t key = packKey(quId, refId);
+  size_t shard, start;
+  locate(key, &shard, &start);
+  const Slot *slots = &_slots[shard * _shardSize];
+  for (int probe = 0; probe < kMaxProbes; ++probe) {
+    const Slot &slot = slots[(start + probe) % _shardSize];
+    uint64_t found = slot.key.load(std::memory_order_acquire);
+    if (found == kEmpty) {
+      return -1.0;
     }
+    if (found != key) {
+      continue;
+    }
+    uint64_t bits = slot.value.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.key.load(std::memory_order_relaxed) != key) {
+      // the slot was overwritten while reading
+      return -1.0;
+    }
+    double cost;
+    memcpy(&cost, &bits, sizeof(cost));
+    return cost;
   }
   return -1.0;
 }
 
+void MatchMap::addMatchCost(int quId, int refId, double cost) {
+  if (quId < 0 || refId < 0) {
+    return;
+  }
+  int newest = _newestQuId.load();
+  while (quId > newest && !_newestQuId.compare_exchange_weak(newest, quId)) {
+  }
+  if (isStale(quId)) {
+    return;
+  }
+  uint64_t key = packKey(quId, refId);
+  size_t shard, start;
+  locate(key, &shard, &start);
+  Slot *slots = &_slots[shard * _shardSize];
+  std::lock_guard<std::mutex> lock(_shardMutexes[shard]);
+  // the key itself, otherwise the first free or stale slot
+  Slot *target = nullptr;
+  for (int probe = 0; probe < kMaxProbes; ++probe) {
+    Slot &slot = slots[(start + probe) % _shardSize];
+    uint64_t found = slot.key.load(std::memory_order_relaxed);
+    if (found == key) {
+      target = &slot;
+      break;
+    }
+    bool free = found == kEmpty || isStale(keyQuId(found));
+    if (free && !target) {
+      target = &slot;
+    }
+    if (found == kEmpty) {
+      break;
+    }
+  }
+  if (!target) {
+    // the shard is crowded, the cost is computed again when requested
+    _droppedCount++;
+    return;
+  }
+  uint64_t bits;
+  memcpy(&bits, &cost, sizeof(bits));
+  // the readers check the key before and after reading the value
+  target->key.store(kBusy, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  target->value.store(bits, std::memory_order_relaxed);
+  target->key.store(key, std::memory_order_release);
+}
+
+size_t MatchMap::memorySize() const {
+  return kShards * _shardSize * sizeof(Slot);
+}
+
+namespace {
+/** returns nullptr if the path is not a feature archive **/
+FeatureArchive::ConstPtr openArchive(const std::string &path) {
+  if (!FeatureArchive::isArchive(path)) {
+    return nullptr;
+  }
+  auto archive = std::make_shared<FeatureArchive>();
+  if (!archive->open(path)) {
+    exit(EXIT_FAILURE);
+  }
+  return archive;
+}
+}  // namespace
+
+OnlineDatabase::OnlineDatabase(const OnlineDatabase &other)
+    : iDatabase(other),
+      _matchMap(other._matchMap),
+      _quFeaturesNames(other.lockedQueryNames()),
+      _refFeaturesNames(other._refFeaturesNames),
+      _quArchive(other._quArchive),
+      _refArchive(other._refArchive),
+      _featureFactory(other._featureFactory),
+      _refCache(other._refCache),
+      _quCache(other._quCache),
+      _prefetchAhead(other._prefetchAhead),
+      _nonMatchCost(other._nonMatchCost),
+      _rescoreMargin(other._rescoreMargin),
+      _rescoredCount(other._rescoredCount.load()),
+      _costLog(other._costLog),
+      _quStreamed(other._quStreamed),
+      _quDropped(other._quDropped),
+      _quStreaming(other._quStreaming),
+      _quCount(other._quCount.load()) {}
+
+int OnlineDatabase::refSize() {
+  if (_refArchive) {
+    return _refArchive->size();
+  }
+  return _refFeaturesNames.size();
+}
+
+int OnlineDatabase::quSize() const { return _quCount.load(); }
+
 bool OnlineDatabase::isSet() const {
-  if (_quFeaturesNames.empty()) {
+  if (quSize() == 0) {
     printf("[ERROR][OnlineDatabase] Query features are not set\n");
     return false;
   }
-  if (_refFeaturesNames.empty()) {
+  if (_refFeaturesNames.empty() && !_refArchive) {
     printf("[ERROR][OnlineDatabase] Reference features are not set\n");
     return false;
   }
@@ -75,27 +252,290 @@ double OnlineDatabase::getCost(int quId, int refId) {
   //     "[DEBUG][OnlineDatabase] Matching costs for features %d - %d will be "
   //     "computed.\n",
   //     quId, refId);
-  cost = computeMatchCost(quId, refId);
+  if (quId < 0 || quId >= quSize()) {
+    printf("[ERROR][OnlineDatabase] Feature %d is out of range\n", quId);
+    exit(EXIT_FAILURE);
+  }
+  if (refId < 0 || refId >= refSize()) {
+    printf("[ERROR][OnlineDatabase] Feature %d is out of range\n", refId);
+    exit(EXIT_FAILURE);
+  }
+  iFeature::ConstPtr quFeaturePtr = nullptr;
+  cost = lookupOrComputeCost(&quFeaturePtr, quId, refId);
   _matchMap.addMatchCost(quId, refId, cost);
   return cost;
 }
 
+double OnlineDatabase::lookupOrComputeCost(iFeature::ConstPtr *quFeaturePtr,
+                                           int quId, int refId) {
+  double cost;
+  if (_costLog && _costLog->find(quId, refId, &cost)) {
+    return cost;
+  }
+  if (!*quFeaturePtr) {
+    *quFeaturePtr = getQueryFeature(quId);
+  }
+  cost = computeMatchCost(*quFeaturePtr, quId, refId);
+  if (_costLog) {
+    _costLog->append(quId, refId, cost);
+  }
+  return cost;
+}
+
+void OnlineDatabase::getCosts(int quId, const int *refIds, int count,
+                              double *costs) {
+  if (quId < 0 || quId >= quSize()) {
+    printf("[ERROR][OnlineDatabase] Feature %d is out of range\n", quId);
+    exit(EXIT_FAILURE);
+  }
+  int refs = refSize();
+  // the query feature is only fetched once, and only if some cost has to be
+  // computed
+  iFeature::ConstPtr quFeaturePtr = nullptr;
+  for (int i = 0; i < count; ++i) {
+    int refId = refIds[i];
+    costs[i] = _matchMap.getMatchCost(quId, refId);
+    if (costs[i] > -1.0) {
+      continue;
+    }
+    if (refId < 0 || refId >= refs) {
+      printf("[ERROR][OnlineDatabase] Feature %d is out of range\n", refId);
+      exit(EXIT_FAILURE);
+    }
+    costs[i] = lookupOrComputeCost(&quFeaturePtr, quId, refId);
+    _matchMap.addMatchCost(quId, refId, costs[i]);
+  }
+}
+
 void OnlineDatabase::setQuFeaturesFolder(const std::string &path2folder) {
+  std::lock_guard<std::mutex> lock(_queryMutex);
+  _quArchive = openArchive(path2folder);
+  _quFeaturesNames.clear();
+  _quStreamed.clear();
+  _quDropped = 0;
+  _quStreaming = false;
+  if (_quArchive) {
+    _quCount = _quArchive->size();
+    return;
+  }
   _quFeaturesNames = listDir(path2folder);
+  _quStreamed.resize(_quFeaturesNames.size());
+  _quCount = _quFeaturesNames.size();
+}
+
+int OnlineDatabase::addQueryFeature(const iFeature::ConstPtr &feature) {
+  if (!feature) {
+    printf("[ERROR][OnlineDatabase] The query feature is not set\n");
+    return -1;
+  }
+  return appendQuery("", feature);
+}
+
+int OnlineDatabase::addQueryFeature(const std::string &path) {
+  return appendQuery(path, nullptr);
+}
+
+int OnlineDatabase::appendQuery(const std::string &path,
+                                const iFeature::ConstPtr &feature) {
+  std::lock_guard<std::mutex> lock(_queryMutex);
+  if (_quArchive) {
+    printf("[ERROR][OnlineDatabase] Queries cannot be added to an archive\n");
+    return -1;
+  }
+  // the fingerprint of the cost cache cannot tell the streams apart
+  if (_costLog) {
+    printf(
+        "[WARNING][OnlineDatabase] The cost cache is disabled for streamed "
+        "queries\n");
+    _costLog = nullptr;
+  }
+  _quStreaming = true;
+  int quId = _quFeaturesNames.size();
+  _quFeaturesNames.push_back(path);
+  _quStreamed.push_back(feature);
+  _quCount = quId + 1;
+  return quId;
+}
+
+void OnlineDatabase::dropQueryFeatures(int quId) {
+  std::lock_guard<std::mutex> lock(_queryMutex);
+  quId = std::min<int>(quId, _quStreamed.size());
+  for (; _quDropped < quId; ++_quDropped) {
+    _quStreamed[_quDropped] = nullptr;
+  }
 }
 void OnlineDatabase::setRefFeaturesFolder(const std::string &path2folder) {
-  _refFeaturesNames = listDir(path2folder);
+  _refArchive = openArchive(path2folder);
+  _refFeaturesNames.clear();
+  if (!_refArchive) {
+    _refFeaturesNames = listDir(path2folder);
+  }
 }
 
 void OnlineDatabase::setBufferSize(int size) {
-  _refBuff.setBufferSize(size);
-  _quBuff.setBufferSize(size);
+  _refCache.setBufferSize(size);
+  _quCache.setBufferSize(size);
+}
+
+void OnlineDatabase::setBufferMemory(size_t bytes) {
+  _refCache.setMemoryBudget(bytes);
+  _quCache.setMemoryBudget(bytes);
+}
+
+void OnlineDatabase::setPrefetching(int queryAhead) {
+  _prefetchAhead = queryAhead;
+}
+
+void OnlineDatabase::startPrefetching() {
+  if (_prefetchAhead <= 0 || _quPrefetcher || _refPrefetcher) {
+    return;
+  }
+  // views from archives are cheap, only the files are worth prefetching
+  if (!_quArchive) {
+    _quPrefetcher = std::make_shared<FeaturePrefetcher>(
+        &_quCache, [this](int id) { return loadQueryFeature(id); });
+  }
+  // a database without reference features (e.g. product quantized) has
+  // nothing to prefetch
+  if (!_refArchive && !_refFeaturesNames.empty()) {
+    _refPrefetcher = std::make_shared<FeaturePrefetcher>(
+        &_refCache, [this](int id) { return loadRefFeature(id); });
+  }
+}
+
+void OnlineDatabase::setSearchFocus(int quId, int refId, int radius) {
+  std::lock_guard<std::mutex> lock(_prefetchMutex);
+  startPrefetching();
+  std::vector<int> window;
+  int first = std::max(0, refId - radius);
+  int last = std::min(refSize() - 1, refId + radius);
+  // closest references first
+  window.push_back(refId);
+  for (int d = 1; d <= radius; ++d) {
+    if (refId + d <= last) {
+      window.push_back(refId + d);
+    }
+    if (refId - d >= first) {
+      window.push_back(refId - d);
+    }
+  }
+  _refCache.setPinned(window);
+  if (_refPrefetcher) {
+    _refPrefetcher->request(window);
+  }
+  if (_quPrefetcher) {
+    std::vector<int> queries;
+    for (int id = quId; id < std::min(quSize(), quId + _prefetchAhead + 1);
+         ++id) {
+      queries.push_back(id);
+    }
+    _quPrefetcher->request(queries);
+  }
+}
+
+void OnlineDatabase::prefetchRefs(const std::vector<int> &refIds) {
+  std::lock_guard<std::mutex> lock(_prefetchMutex);
+  if (!_refPrefetcher) {
+    return;
+  }
+  std::vector<int> valid;
+  for (int id : refIds) {
+    if (id >= 0 && id < refSize()) {
+      valid.push_back(id);
+    }
+  }
+  _refPrefetcher->add(valid);
+}
+
+FeatureBuffer::Stats OnlineDatabase::refBufferStats() const {
+  return _refCache.stats();
+}
+
+FeatureBuffer::Stats OnlineDatabase::quBufferStats() const {
+  return _quCache.stats();
+}
+
+int OnlineDatabase::prefetchedCount() const {
+  std::lock_guard<std::mutex> lock(_prefetchMutex);
+  int count = 0;
+  if (_quPrefetcher) {
+    count += _quPrefetcher->prefetchedCount();
+  }
+  if (_refPrefetcher) {
+    count += _refPrefetcher->prefetchedCount();
+  }
+  return count;
 }
 
 void OnlineDatabase::setFeatureType(FeatureFactory::FeatureType type) {
   _featureFactory.setFeatureType(type);
 }
 
+void OnlineDatabase::setStorageType(FeatureFactory::StorageType type) {
+  _featureFactory.setStorageType(type);
+}
+
+void OnlineDatabase::setExactRescoring(double nonMatchCost, double margin) {
+  _nonMatchCost = nonMatchCost;
+  _rescoreMargin = margin;
+}
+
+bool OnlineDatabase::setCostCache(const std::string &filename) {
+  bool streaming;
+  {
+    std::lock_guard<std::mutex> lock(_queryMutex);
+    streaming = _quStreaming;
+  }
+  if (streaming) {
+    printf(
+        "[ERROR][OnlineDatabase] The cost cache is not available for streamed "
+        "queries\n");
+    _costLog = nullptr;
+    return false;
+  }
+  auto costLog = std::make_shared<CostLog>();
+  if (!costLog->open(filename, fingerprint())) {
+    _costLog = nullptr;
+    return false;
+  }
+  _costLog = costLog;
+  return true;
+}
+
+void OnlineDatabase::flushCostCache() {
+  if (_costLog) {
+    _costLog->flush();
+  }
+}
+
+uint64_t OnlineDatabase::fingerprint() const {
+  uint64_t hash = hashBytes(nullptr, 0);
+  auto hashFile = [&hash](const std::string &name) {
+    hash = hashBytes(name.data(), name.size(), hash);
+    // a changed feature file has a different size or modification time
+    struct stat info;
+    if (stat(name.c_str(), &info) == 0) {
+      int64_t values[2] = {int64_t(info.st_size), int64_t(info.st_mtime)};
+      hash = hashBytes(values, sizeof(values), hash);
+    }
+  };
+  for (const auto &names : {lockedQueryNames(), _refFeaturesNames}) {
+    uint64_t count = names.size();
+    hash = hashBytes(&count, sizeof(count), hash);
+    for (const std::string &name : names) {
+      hashFile(name);
+    }
+  }
+  for (const auto &archive : {_quArchive, _refArchive}) {
+    hashFile(archive ? archive->filename() : "");
+  }
+  int types[2] = {_featureFactory.featureType(),
+                  _featureFactory.storageType()};
+  hash = hashBytes(types, sizeof(types), hash);
+  double rescoring[2] = {_nonMatchCost, _rescoreMargin};
+  return hashBytes(rescoring, sizeof(rescoring), hash);
+}
+
 // use for tests / visualization only
 const MatchMap &OnlineDatabase::getMatchMap() const { return _matchMap; }
 
@@ -103,67 +543,119 @@ double OnlineDatabase::computeMatchCost(int quId, int refId) {
   // The next 2 lines are the same. Just wanted to get rid of the int-size_t
   // comparison warning
   // if (quId < 0 || quId >= _quFeaturesNames.size()) {
-  if (quId < 0 || quId >= (int)_quFeaturesNames.size()) {
+  if (quId < 0 || quId >= quSize()) {
     printf("[ERROR][OnlineDatabase] Feature %d is out of range\n", quId);
     exit(EXIT_FAILURE);
   }
-  if (refId < 0 || refId >= (int)_refFeaturesNames.size()) {
+  if (refId < 0 || refId >= refSize()) {
     printf("[ERROR][OnlineDatabase] Feature %d is out of range\n", refId);
     exit(EXIT_FAILURE);
   }
 
-  iFeature::ConstPtr quFeaturePtr = nullptr;
-  iFeature::ConstPtr refFeaturePtr = nullptr;
-  if (_quBuff.inBuffer(quId)) {
-    quFeaturePtr = _quBuff.getFeature(quId);
-  } else {
-    // We cannot directly set const pointers, so set them through a proxy.
-    auto tempFeaturePtr = _featureFactory.createFeature();
-    tempFeaturePtr->loadFromFile( _quFeaturesNames[quId]);
-    quFeaturePtr = tempFeaturePtr;
-    _quBuff.addFeature(quId, quFeaturePtr);
-  }
-
-  if (_refBuff.inBuffer(refId)) {
-    refFeaturePtr = _refBuff.getFeature(refId);
-  } else {
-    // We cannot directly set const pointers, so set them through a proxy.
-    auto tempFeaturePtr = _featureFactory.createFeature();
-    tempFeaturePtr->loadFromFile(_refFeaturesNames[refId]);
-    refFeaturePtr = tempFeaturePtr;
-    _refBuff.addFeature(refId, refFeaturePtr);
+  return computeMatchCost(getQueryFeature(quId), quId, refId);
+}
+
+double OnlineDatabase::computeMatchCost(const iFeature::ConstPtr &quFeaturePtr,
+                                        int quId, int refId) {
+  iFeature::ConstPtr refFeaturePtr = getRefFeature(refId);
+
+  double score = quFeaturePtr->computeSimilarityScore(refFeaturePtr);
+  double cost = quFeaturePtr->score2cost(score);
+
+  bool lossy = _featureFactory.storageType() != FeatureFactory::Float64;
+  bool fromFolders = !_quArchive && !_refArchive;
+  // the features added in memory cannot be loaded exactly
+  if (lossy && fromFolders && _rescoreMargin > 0 &&
+      fabs(cost - _nonMatchCost) < _rescoreMargin &&
+      !getQuFeatureName(quId).empty()) {
+    cost = computeExactCost(quId, refId);
+    ++_rescoredCount;
   }
+  return cost;
+}
 
+double OnlineDatabase::computeExactCost(int quId, int refId) const {
+  FeatureFactory exactFactory = _featureFactory;
+  exactFactory.setStorageType(FeatureFactory::Float64);
+  auto quFeaturePtr = exactFactory.createFeature();
+  auto refFeaturePtr = exactFactory.createFeature();
+  quFeaturePtr->loadFromFile(getQuFeatureName(quId));
+  refFeaturePtr->loadFromFile(_refFeaturesNames[refId]);
   double score = quFeaturePtr->computeSimilarityScore(refFeaturePtr);
   return quFeaturePtr->score2cost(score);
 }
 
 std::string OnlineDatabase::getQuFeatureName(int id) const {
-  if (id < 0 || id >= (int)_quFeaturesNames.size()) {
+  if (id < 0 || id >= quSize()) {
     printf("[WARNING][OnlineDatabase] No such feature exists\n");
     return "";
   }
+  if (_quArchive) {
+    return _quArchive->filename() + ":" + std::to_string(id);
+  }
+  std::lock_guard<std::mutex> lock(_queryMutex);
   return _quFeaturesNames[id];
 }
 
+std::vector<std::string> OnlineDatabase::lockedQueryNames() const {
+  std::lock_guard<std::mutex> lock(_queryMutex);
+  return _quFeaturesNames;
+}
+
 std::string OnlineDatabase::getRefFeatureName(int id) const {
-  if (id < 0 || id >= (int)_refFeaturesNames.size()) {
+  int size = _refArchive ? _refArchive->size() : _refFeaturesNames.size();
+  if (id < 0 || id >= size) {
     printf("[WARNING][OnlineDatabase] No such feature exists\n");
     return "";
   }
+  if (_refArchive) {
+    return _refArchive->filename() + ":" + std::to_string(id);
+  }
   return _refFeaturesNames[id];
 }
 
 iFeature::ConstPtr OnlineDatabase::getQueryFeature(int quId) {
-  iFeature::ConstPtr quFeaturePtr = nullptr;
-  if (_quBuff.inBuffer(quId)) {
-    quFeaturePtr = _quBuff.getFeature(quId);
-  } else {
-    // We cannot directly set const pointers, so set them through a proxy.
-    auto tempFeaturePtr = _featureFactory.createFeature();
-    tempFeaturePtr->loadFromFile(_quFeaturesNames[quId]);
-    quFeaturePtr = tempFeaturePtr;
-    _quBuff.addFeature(quId, quFeaturePtr);
-  }
-  return quFeaturePtr;
+  return _quCache.getFeature(
+      quId, [this](int id) { return loadQueryFeature(id); });
+}
+
+iFeature::ConstPtr OnlineDatabase::getRefFeature(int refId) {
+  if (_refArchive) {
+    // creating a view is only pointer arithmetic, no need to buffer it
+    return std::make_shared<FeatureView>(_refArchive, refId);
+  }
+  return _refCache.getFeature(
+      refId, [this](int id) { return loadRefFeature(id); });
+}
+
+iFeature::ConstPtr OnlineDatabase::loadQueryFeature(int quId) const {
+  if (_quArchive) {
+    // query features need the bits for relocalization
+    return std::make_shared<FeatureView>(_quArchive, quId, true);
+  }
+  std::string name;
+  {
+    std::lock_guard<std::mutex> lock(_queryMutex);
+    if (_quStreamed[quId]) {
+      return _quStreamed[quId];
+    }
+    name = _quFeaturesNames[quId];
+  }
+  if (name.empty()) {
+    printf(
+        "[ERROR][OnlineDatabase] Query feature %d was dropped, its row should "
+        "not be expanded any more\n",
+        quId);
+    exit(EXIT_FAILURE);
+  }
+  // We cannot directly set const pointers, so set them through a proxy.
+  auto tempFeaturePtr = _featureFactory.createFeature();
+  tempFeaturePtr->loadFromFile(name);
+  return tempFeaturePtr;
+}
+
+iFeature::ConstPtr OnlineDatabase::loadRefFeature(int refId) const {
+  auto tempFeaturePtr = _featureFactory.createFeature();
+  tempFeaturePtr->loadFromFile(_refFeaturesNames[refId]);
+  return tempFeaturePtr;
 }
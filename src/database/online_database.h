@@ -25,47 +25,205 @@
 #ifndef SRC_DATABASE_ONLINE_DATABASE_H_
 #define SRC_DATABASE_ONLINE_DATABASE_H_
 
-#include <string>
+#include <stdint.h>
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <unordered_map>
 #include <vector>
 #include "features/feature_buffer.h"
+#include "database/cost_log.h"
+#include "database/feature_cache.h"
+#include "database/feature_prefetcher.h"
 #include "database/idatabase.h"
+#include "features/feature_archive.h"
 #include "features/feature_factory.h"
 
 /**
- * @brief      Container for storing computed feature matches
+ * @brief      Container for storing computed feature matches. Keeps only the
+ * costs of the most recent query rows. Safe to use from several threads: the
+ * costs are stored in a fixed-size hash table split into shards. Writers lock
+ * one shard, readers do not lock at all. If the probed slots of a shard are
+ * full, the cost is not stored.
+ *
+ * The table replaces the dense per-row storage. It holds `retention *
+ * rowCapacity` costs in total, so a single row, e.g. of a relocalization, may
+ * take more than rowCapacity costs. Costs are dropped once the kept rows fill
+ * about two thirds of the table. With the defaults that is a relocalization
+ * over 1024 candidates for more than 100 query images in a row.
  */
 class MatchMap {
  public:
-  MatchMap() {}
-  double getMatchCost(int quId, int refId);
-  void addMatchCost(int quId, int refId, double cost) {
-    _matches[quId][refId] = cost;
+  static const int kDefaultRetention = 256;
+  static const int kDefaultRowCapacity = 1024;
+
+  /**
+   * @param[in]  retention    The number of recent query rows which costs are
+   * kept
+   * @param[in]  rowCapacity  The number of costs reserved per row
+   */
+  explicit MatchMap(int retention = kDefaultRetention,
+                    int rowCapacity = kDefaultRowCapacity);
+  /** copying is not safe while other threads add costs **/
+  MatchMap(const MatchMap &other);
+  MatchMap &operator=(const MatchMap &other);
+
+  /** returns -1 if the cost is not found **/
+  double getMatchCost(int quId, int refId) const;
+  /**
+   * @brief      Stores the cost. The costs of the query ids up to
+   * newestQuId - retention are dropped, also the ones added later.
+   */
+  void addMatchCost(int quId, int refId, double cost);
+  /** changes the number of kept rows. Removes all costs, not thread-safe **/
+  void setRetention(int retention);
+  int retention() const { return _retention; }
+  /** memory used by the table in bytes **/
+  size_t memorySize() const;
+  /**
+   * number of costs that were not stored, because all the probed slots were
+   * taken. These costs are computed again when requested.
+   */
+  size_t droppedCount() const { return _droppedCount.load(); }
+
+ private:
+  static const int kShards = 64;
+  static const int kMaxProbes = 32;
+  static const uint64_t kEmpty = ~uint64_t(0);
+  // the slot is being written
+  static const uint64_t kBusy = ~uint64_t(0) - 1;
+
+  struct Slot {
+    std::atomic<uint64_t> key;
+    // bits of the double cost
+    std::atomic<uint64_t> value;
+  };
+
+  static uint64_t packKey(int quId, int refId) {
+    return (uint64_t(quId) << 32) | uint32_t(refId);
+  }
+  static int keyQuId(uint64_t key) { return key >> 32; }
+  bool isStale(int quId) const {
+    return quId <= _newestQuId.load(std::memory_order_relaxed) - _retention;
   }
-  std::unordered_map<int, std::unordered_map<int, double> > _matches;
+  /** first slot of the key and the shard, the probes stay in the shard **/
+  void locate(uint64_t key, size_t *shard, size_t *start) const;
+  /** allocates an empty table **/
+  void allocate();
+  void copyFrom(const MatchMap &other);
+
+  int _retention = kDefaultRetention;
+  int _rowCapacity = kDefaultRowCapacity;
+  size_t _shardSize = 0;
+  std::unique_ptr<Slot[]> _slots;
+  std::unique_ptr<std::mutex[]> _shardMutexes;
+  std::atomic<int> _newestQuId;
+  std::atomic<size_t> _droppedCount{0};
 };
 
 /**
  * @brief      Database for loading and matching features. Saves the computed matching costs.
+ * Features are read either from a folder with one file per feature or from a
+ * single FeatureArchive.
+ * Once set up, the costs can be queried from several threads. The setters
+ * are not thread-safe.
  */
 class OnlineDatabase : public iDatabase {
  public:
   using Ptr = std::shared_ptr<OnlineDatabase>;
   using ConstPtr = std::shared_ptr<const OnlineDatabase>;
 
+  OnlineDatabase() {}
+  /** copies the settings and the costs, not the features and the threads **/
+  OnlineDatabase(const OnlineDatabase &other);
+  OnlineDatabase &operator=(const OnlineDatabase &) = delete;
+
 
-  int refSize() override { return _refFeaturesNames.size(); }
+  int refSize() override;
   double getCost(int quId, int refId) override;
+  void getCosts(int quId, const int *refIds, int count,
+                double *costs) override;
+  bool isThreadSafe() const override { return true; }
 
+  /** path2folder can also point to a feature archive **/
   void setQuFeaturesFolder(const std::string &path2folder);
+  /** path2folder can also point to a feature archive **/
   void setRefFeaturesFolder(const std::string &path2folder);
+  /**
+   * @brief      Appends a query feature kept in memory, for the queries that
+   * arrive one by one. The feature is kept until dropQueryFeatures releases
+   * its row. Not available for query archives. The streamed queries have no
+   * stable names, so the cost cache is disabled.
+   *
+   * @return     The id of the query, -1 on error.
+   */
+  int addQueryFeature(const iFeature::ConstPtr &feature);
+  /** appends a query feature file, see addQueryFeature **/
+  int addQueryFeature(const std::string &path);
+  /**
+   * @brief      Releases the features added by addQueryFeature for the rows
+   * before quId. Call it only for the rows the search does not expand any
+   * more, their costs cannot be computed afterwards.
+   */
+  void dropQueryFeatures(int quId);
   void setBufferSize(int size);
+  /** limits the memory of each feature buffer in bytes. 0 for no limit **/
+  void setBufferMemory(size_t bytes);
+  /**
+   * @brief      Pins the reference features in [refId - radius, refId +
+   * radius] in the buffer, so they are not evicted while the search is
+   * around refId.
+   */
+  void setSearchFocus(int quId, int refId, int radius) override;
+  /** loads these references in the background, if prefetching is enabled **/
+  void prefetchRefs(const std::vector<int> &refIds) override;
+  /**
+   * @brief      Enables loading the features on background threads: the next
+   * `queryAhead` query features and the references around the search focus.
+   * The threads start with the first search focus.
+   *
+   * @param[in]  queryAhead  The number of query features to load ahead. 0
+   * disables prefetching
+   */
+  void setPrefetching(int queryAhead);
+  /** number of features loaded by the background threads **/
+  int prefetchedCount() const;
+  FeatureBuffer::Stats refBufferStats() const;
+  FeatureBuffer::Stats quBufferStats() const;
+  /** number of computed costs that did not fit into the match map **/
+  size_t droppedCostCount() const { return _matchMap.droppedCount(); }
   void setFeatureType(FeatureFactory::FeatureType type);
+  void setStorageType(FeatureFactory::StorageType type);
+  /**
+   * @brief      Float32 and Int8 storage may move a cost from one side of
+   * nonMatchCost to the other. Costs closer than `margin` to the
+   * nonMatchCost are recomputed with exactly loaded features. Only used for
+   * the features read from folders.
+   *
+   * @param[in]  nonMatchCost  The non match cost
+   * @param[in]  margin        The margin. 0 disables re-scoring
+   */
+  void setExactRescoring(double nonMatchCost, double margin);
+  /**
+   * @brief      Keeps the computed costs in a log file, which is reused by
+   * the next runs on the same features. Call it after the features, the
+   * feature type, the storage type and the re-scoring are set: the log is
+   * only reused if they did not change. Not available for streamed queries.
+   *
+   * @return     false if the log cannot be written.
+   */
+  bool setCostCache(const std::string &filename);
+  /** writes the costs computed so far to the cost cache **/
+  void flushCostCache();
+  /** number of costs that were recomputed exactly **/
+  int rescoredCount() const { return _rescoredCount.load(); }
 
   // use for tests / visualization only
   const MatchMap &getMatchMap() const;
   void setMatchMap(const MatchMap &matchMap) { _matchMap = matchMap; }
+  /** number of recent query rows which costs are kept **/
+  void setCostRetention(int rows) { _matchMap.setRetention(rows); }
   bool isSet() const;
   double computeMatchCost(int quId, int refId);
 
@@ -76,10 +234,55 @@ class OnlineDatabase : public iDatabase {
  protected:
   MatchMap _matchMap;
   std::vector<std::string> _quFeaturesNames, _refFeaturesNames;
+  FeatureArchive::ConstPtr _quArchive = nullptr, _refArchive = nullptr;
   FeatureFactory _featureFactory;
 
+  /** number of query features, also the streamed ones **/
+  int quSize() const;
+
  private:
-  FeatureBuffer _refBuff, _quBuff;
+  iFeature::ConstPtr getRefFeature(int refId);
+  /** computeMatchCost with the already fetched query feature **/
+  double computeMatchCost(const iFeature::ConstPtr &quFeaturePtr, int quId,
+                          int refId);
+  iFeature::ConstPtr loadQueryFeature(int quId) const;
+  iFeature::ConstPtr loadRefFeature(int refId) const;
+  /** copy of the query names **/
+  std::vector<std::string> lockedQueryNames() const;
+  int appendQuery(const std::string &path, const iFeature::ConstPtr &feature);
+  void startPrefetching();
+  /** identifies the features and the way they are matched **/
+  uint64_t fingerprint() const;
+  /**
+   * @brief      Takes the cost from the cost cache or computes it. The query
+   * feature is fetched into quFeaturePtr only if it is needed.
+   */
+  double lookupOrComputeCost(iFeature::ConstPtr *quFeaturePtr, int quId,
+                             int refId);
+  double computeExactCost(int quId, int refId) const;
+
+  FeatureCache _refCache, _quCache;
+  int _prefetchAhead = 0;
+  // guards the creation of the prefetchers
+  mutable std::mutex _prefetchMutex;
+  // declared after the caches, so the threads stop before they are deleted
+  FeaturePrefetcher::Ptr _quPrefetcher = nullptr, _refPrefetcher = nullptr;
+  double _nonMatchCost = 0.0;
+  double _rescoreMargin = 0.0;
+  std::atomic<int> _rescoredCount{0};
+  // shared by the copies of the database
+  CostLog::Ptr _costLog = nullptr;
+
+  // guards the query names and the streamed features, which grow while the
+  // queries arrive
+  mutable std::mutex _queryMutex;
+  // features added by addQueryFeature, nullptr for the files
+  std::vector<iFeature::ConstPtr> _quStreamed;
+  // the streamed features of the rows before it were released
+  int _quDropped = 0;
+  // the queries were added by addQueryFeature
+  bool _quStreaming = false;
+  std::atomic<int> _quCount{0};
 };
 
 #endif  // SRC_DATABASE_ONLINE_DATABASE_H_
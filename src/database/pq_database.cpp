@@ -0,0 +1,144 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include "database/pq_database.h"
+#include <math.h>
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include "features/cnn_feature.h"
+#include "features/dot_kernels.h"
+#include "features/feature_view.h"
+#include "features/vgg_feature.h"
+
+bool PqDatabase::loadReferences(const std::string &filename) {
+  _tableQuId = -1;
+  _rerankQuId = -1;
+  _rerankIds.clear();
+  return _store.load(filename);
+}
+
+int PqDatabase::refSize() { return _store.size(); }
+
+double PqDatabase::getCost(int quId, int refId) {
+  if (quId < 0 || quId >= quSize()) {
+    printf("[ERROR][PqDatabase] Invalid query index %d\n", quId);
+    return -1;
+  }
+  if (refId < 0 || refId >= _store.size()) {
+    printf("[ERROR][PqDatabase] Invalid reference index %d\n", refId);
+    return -1;
+  }
+  double cost = _matchMap.getMatchCost(quId, refId);
+  if (cost > -1.0) {
+    // cost was found
+    return cost;
+  }
+  cost = computePqCost(quId, refId);
+  bool exactRefsSet = _refArchive || !_refFeaturesNames.empty();
+  if (_rerankCandidates > 0 && exactRefsSet && _rerankQuId != quId) {
+    updateCandidates();
+  }
+  if (std::binary_search(_rerankIds.begin(), _rerankIds.end(), refId)) {
+    cost = computeMatchCost(quId, refId);
+    ++_rerankedCount;
+  }
+  _matchMap.addMatchCost(quId, refId, cost);
+  return cost;
+}
+
+void PqDatabase::updateTable(int quId) {
+  iFeature::ConstPtr featurePtr = getQueryFeature(quId);
+  const double *values = nullptr;
+  size_t size = 0;
+  if (const auto cnn = dynamic_cast<const CnnFeature *>(featurePtr.get())) {
+    values = cnn->dim.data();
+    size = cnn->dim.size();
+  } else if (const auto vgg =
+                 dynamic_cast<const VggFeature *>(featurePtr.get())) {
+    values = vgg->dim.data();
+    size = vgg->dim.size();
+  } else if (const auto view =
+                 dynamic_cast<const FeatureView *>(featurePtr.get())) {
+    values = view->data();
+    size = view->size();
+  }
+  if (!values) {
+    printf(
+        "[ERROR][PqDatabase] Only dense float64 query features can be "
+        "matched\n");
+    exit(EXIT_FAILURE);
+  }
+  if (static_cast<int>(size) != _store.quantizer().dimension()) {
+    printf("[ERROR][PqDatabase] Query has %lu values, references have %d\n",
+           size, _store.quantizer().dimension());
+    exit(EXIT_FAILURE);
+  }
+  _store.quantizer().computeTable(values, &_table);
+  _tableQuNorm = sqrt(dotProduct(values, values, size));
+  _tableQuFeature = featurePtr;
+  _tableQuId = quId;
+  _rerankQuId = -1;
+  _rerankIds.clear();
+}
+
+void PqDatabase::updateCandidates() {
+  // a whole row of scores takes numSubspaces lookups per reference, much
+  // less than the table itself. The costs decrease with the score, ties are
+  // broken by the id
+  _rerankScores.resize(_store.size());
+  for (int refId = 0; refId < _store.size(); ++refId) {
+    _rerankScores[refId] = std::make_pair(-tableScore(refId), refId);
+  }
+  size_t count = std::min<size_t>(_rerankCandidates, _rerankScores.size());
+  std::nth_element(_rerankScores.begin(), _rerankScores.begin() + count,
+                   _rerankScores.end());
+  _rerankIds.clear();
+  for (size_t i = 0; i < count; ++i) {
+    _rerankIds.push_back(_rerankScores[i].second);
+  }
+  // sorted for the binary search of every requested cost
+  std::sort(_rerankIds.begin(), _rerankIds.end());
+  _rerankQuId = _tableQuId;
+}
+
+double PqDatabase::tableScore(int refId) const {
+  double prod = _store.quantizer().innerProduct(_table, _store.code(refId));
+  return prod / (_tableQuNorm * _store.norm(refId));
+}
+
+double PqDatabase::computePqCost(int quId, int refId) {
+  if (refId < 0 || refId >= _store.size()) {
+    printf("[ERROR][PqDatabase] Feature %d is out of range\n", refId);
+    exit(EXIT_FAILURE);
+  }
+  if (quId < 0 || quId >= quSize()) {
+    printf("[ERROR][PqDatabase] Feature %d is out of range\n", quId);
+    exit(EXIT_FAILURE);
+  }
+  // queries are processed one after another, so one table is enough
+  if (quId != _tableQuId) {
+    updateTable(quId);
+  }
+  return _tableQuFeature->score2cost(tableScore(refId));
+}
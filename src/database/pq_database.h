@@ -0,0 +1,93 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#ifndef SRC_DATABASE_PQ_DATABASE_H_
+#define SRC_DATABASE_PQ_DATABASE_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+#include "database/online_database.h"
+#include "features/product_quantizer.h"
+
+/**
+ * @brief      Database with product quantized reference features. The query
+ * features are loaded as in OnlineDatabase, the references are only kept as
+ * codes (created by the train_pq app). For every query a table with the
+ * inner products of its parts and the centroids is computed once, then every
+ * cost takes numSubspaces table lookups.
+ */
+class PqDatabase : public OnlineDatabase {
+ public:
+  using Ptr = std::shared_ptr<PqDatabase>;
+  using ConstPtr = std::shared_ptr<const PqDatabase>;
+
+  int refSize() override;
+  double getCost(int quId, int refId) override;
+  /** every cost is a table lookup, no need for the feature based batch **/
+  void getCosts(int quId, const int *refIds, int count,
+                double *costs) override {
+    iDatabase::getCosts(quId, refIds, count, costs);
+  }
+  /** the lookup table is shared by all the requests **/
+  bool isThreadSafe() const override { return false; }
+
+  bool loadReferences(const std::string &filename);
+  /**
+   * @brief      The costs of the `candidates` references with the best
+   * approximate scores of a query are recomputed with the exact reference
+   * features. The candidates are selected among all the references once per
+   * query, so the costs do not depend on the order of requests. The
+   * reference features should be set with setRefFeaturesFolder.
+   *
+   * @param[in]  candidates  The number of candidates. 0 disables re-ranking
+   */
+  void setExactRerank(int candidates) { _rerankCandidates = candidates; }
+  /** number of costs that were recomputed exactly **/
+  int rerankedCount() const { return _rerankedCount; }
+  /** cost approximated with the codes only **/
+  double computePqCost(int quId, int refId);
+
+ private:
+  void updateTable(int quId);
+  /** selects the re-ranked references of the query of the table **/
+  void updateCandidates();
+  /** approximate score of the reference from the current table **/
+  double tableScore(int refId) const;
+
+  PqReferenceStore _store;
+  int _tableQuId = -1;
+  std::vector<float> _table;
+  double _tableQuNorm = 0.0;
+  iFeature::ConstPtr _tableQuFeature = nullptr;
+
+  // sorted ids of the references re-ranked for the query _rerankQuId
+  std::vector<int> _rerankIds;
+  int _rerankQuId = -1;
+  // (-score, refId) of the whole row, reused between the queries
+  std::vector<std::pair<double, int> > _rerankScores;
+  int _rerankCandidates = 0;
+  int _rerankedCount = 0;
+};
+
+#endif  // SRC_DATABASE_PQ_DATABASE_H_
@@ -0,0 +1,168 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include "database/sparse_cost_matrix.h"
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <fstream>
+#include <limits>
+
+bool SparseCostMatrix::isSparseCostMatrix(const std::string &filename) {
+  std::ifstream in(filename, std::ios::binary);
+  char magic[sizeof(kSparseCostMatrixMagic)];
+  if (!in || !in.read(magic, sizeof(magic))) {
+    return false;
+  }
+  return memcmp(magic, kSparseCostMatrixMagic, sizeof(magic)) == 0;
+}
+
+bool SparseCostMatrix::open(const std::string &filename) {
+  if (!_file.open(filename)) {
+    printf("[ERROR][SparseCostMatrix] The file cannot be opened %s\n",
+           filename.c_str());
+    return false;
+  }
+  if (_file.size() < sizeof(_header)) {
+    printf("[ERROR][SparseCostMatrix] %s is not a sparse cost matrix\n",
+           filename.c_str());
+    _file.close();
+    return false;
+  }
+  memcpy(&_header, _file.data(), sizeof(_header));
+  if (memcmp(_header.magic, kSparseCostMatrixMagic, sizeof(_header.magic)) !=
+          0 ||
+      _header.version != kSparseCostMatrixVersion) {
+    printf("[ERROR][SparseCostMatrix] %s is not a sparse cost matrix\n",
+           filename.c_str());
+    _file.close();
+    return false;
+  }
+  // the matrix is indexed with ints
+  const uint64_t kMaxSize = std::numeric_limits<int>::max();
+  if (_header.rows > kMaxSize || _header.cols > kMaxSize) {
+    printf("[ERROR][SparseCostMatrix] Invalid matrix size in %s\n",
+           filename.c_str());
+    _file.close();
+    return false;
+  }
+  // compared by division, so that no sum of the sizes can overflow
+  uint64_t rowStartsSize = (_header.rows + 1) * sizeof(uint64_t);
+  uint64_t entrySize = sizeof(uint32_t) + sizeof(float);
+  if (_file.size() - sizeof(_header) < rowStartsSize ||
+      _header.nonZeros >
+          (_file.size() - sizeof(_header) - rowStartsSize) / entrySize) {
+    printf("[ERROR][SparseCostMatrix] The file %s is truncated\n",
+           filename.c_str());
+    _file.close();
+    return false;
+  }
+  const uint8_t *data = _file.data() + sizeof(_header);
+  _rowStarts = reinterpret_cast<const uint64_t *>(data);
+  data += rowStartsSize;
+  _colIds = reinterpret_cast<const uint32_t *>(data);
+  data += _header.nonZeros * sizeof(uint32_t);
+  _values = reinterpret_cast<const float *>(data);
+  if (!isValid()) {
+    printf("[ERROR][SparseCostMatrix] The file %s is corrupted\n",
+           filename.c_str());
+    _file.close();
+    return false;
+  }
+  return true;
+}
+
+bool SparseCostMatrix::isValid() const {
+  const uint64_t *rowStartsEnd = _rowStarts + _header.rows + 1;
+  if (_rowStarts[0] != 0 || _rowStarts[_header.rows] != _header.nonZeros ||
+      !std::is_sorted(_rowStarts, rowStartsEnd)) {
+    return false;
+  }
+  // find() needs increasing column ids in every row
+  for (uint64_t r = 0; r < _header.rows; ++r) {
+    for (uint64_t i = _rowStarts[r]; i < _rowStarts[r + 1]; ++i) {
+      if (_colIds[i] >= _header.cols ||
+          (i > _rowStarts[r] && _colIds[i] <= _colIds[i - 1])) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool SparseCostMatrix::find(int row, int col, float *value) const {
+  const uint32_t *begin = _colIds + rowBegin(row);
+  const uint32_t *end = _colIds + rowEnd(row);
+  const uint32_t *found = std::lower_bound(begin, end, uint32_t(col));
+  if (found == end || *found != uint32_t(col)) {
+    return false;
+  }
+  *value = _values[found - _colIds];
+  return true;
+}
+
+SparseCostMatrixBuilder::SparseCostMatrixBuilder(int cols, float threshold,
+                                                 float fallbackCost)
+    : _cols(cols), _threshold(threshold), _fallbackCost(fallbackCost) {
+  if (_fallbackCost <= 0) {
+    // the lowest cost a cell that is not stored can have
+    _fallbackCost = threshold > 1e-9 ? 1.f / threshold : 1e9f;
+  }
+  _rowStarts.push_back(0);
+}
+
+void SparseCostMatrixBuilder::addRow(const float *similarities) {
+  for (int c = 0; c < _cols; ++c) {
+    if (similarities[c] >= _threshold) {
+      _colIds.push_back(c);
+      _values.push_back(similarities[c]);
+    }
+  }
+  _rowStarts.push_back(_colIds.size());
+}
+
+bool SparseCostMatrixBuilder::save(const std::string &filename) const {
+  std::ofstream out(filename, std::ios::binary);
+  if (!out) {
+    printf("[ERROR][SparseCostMatrix] The file cannot be opened %s\n",
+           filename.c_str());
+    return false;
+  }
+  SparseCostMatrixHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kSparseCostMatrixMagic, sizeof(kSparseCostMatrixMagic));
+  header.version = kSparseCostMatrixVersion;
+  header.rows = rows();
+  header.cols = _cols;
+  header.nonZeros = _colIds.size();
+  header.threshold = _threshold;
+  header.fallbackCost = _fallbackCost;
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char *>(_rowStarts.data()),
+            _rowStarts.size() * sizeof(uint64_t));
+  out.write(reinterpret_cast<const char *>(_colIds.data()),
+            _colIds.size() * sizeof(uint32_t));
+  out.write(reinterpret_cast<const char *>(_values.data()),
+            _values.size() * sizeof(float));
+  return static_cast<bool>(out);
+}
@@ -0,0 +1,126 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#ifndef SRC_DATABASE_SPARSE_COST_MATRIX_H_
+#define SRC_DATABASE_SPARSE_COST_MATRIX_H_
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "tools/mapped_file/mapped_file.h"
+
+/**
+ * Sparse cost matrix layout (CSR): a 64 byte SparseCostMatrixHeader followed
+ * by `rows + 1` uint64 row starts, `nonZeros` uint32 column indices and
+ * `nonZeros` float32 similarities. The columns of every row are sorted.
+ * Only the similarities that are at least `threshold` are stored, all the
+ * other cells have the cost `fallbackCost`.
+ */
+struct SparseCostMatrixHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t reserved0;
+  uint64_t rows;
+  uint64_t cols;
+  uint64_t nonZeros;
+  float threshold;
+  float fallbackCost;
+  uint64_t reserved[2];
+};
+
+const char kSparseCostMatrixMagic[8] = {'V', 'P', 'R', 'S', 'P', 'A', 'R',
+                                        '\0'};
+const uint32_t kSparseCostMatrixVersion = 1;
+
+/**
+ * @brief      Read-only access to a memory mapped sparse cost matrix.
+ */
+class SparseCostMatrix {
+ public:
+  using Ptr = std::shared_ptr<SparseCostMatrix>;
+  using ConstPtr = std::shared_ptr<const SparseCostMatrix>;
+
+  static bool isSparseCostMatrix(const std::string &filename);
+
+  bool open(const std::string &filename);
+  int rows() const { return _header.rows; }
+  int cols() const { return _header.cols; }
+  size_t nonZeros() const { return _header.nonZeros; }
+  float threshold() const { return _header.threshold; }
+  float fallbackCost() const { return _header.fallbackCost; }
+
+  /** stored cells of the row are [rowBegin(row), rowEnd(row)) **/
+  uint64_t rowBegin(int row) const { return _rowStarts[row]; }
+  uint64_t rowEnd(int row) const { return _rowStarts[row + 1]; }
+  const uint32_t *colIds() const { return _colIds; }
+  const float *values() const { return _values; }
+
+  /**
+   * @brief      Finds the stored similarity.
+   *
+   * @return     false if the cell is not stored.
+   */
+  bool find(int row, int col, float *value) const;
+
+ private:
+  /** checks the row starts and the column ids of the mapped file **/
+  bool isValid() const;
+
+  MappedFile _file;
+  SparseCostMatrixHeader _header = SparseCostMatrixHeader();
+  const uint64_t *_rowStarts = nullptr;
+  const uint32_t *_colIds = nullptr;
+  const float *_values = nullptr;
+};
+
+/**
+ * @brief      Builds the sparse matrix row by row. Only the stored cells are
+ * kept in memory.
+ */
+class SparseCostMatrixBuilder {
+ public:
+  /**
+   * @param[in]  threshold     The smallest similarity that is stored
+   * @param[in]  fallbackCost  The cost of the cells that are not stored. If
+   * not positive, 1 / threshold is used.
+   */
+  SparseCostMatrixBuilder(int cols, float threshold, float fallbackCost = -1);
+
+  /** adds the similarities of the next row **/
+  void addRow(const float *similarities);
+  int rows() const { return static_cast<int>(_rowStarts.size()) - 1; }
+  size_t nonZeros() const { return _colIds.size(); }
+
+  bool save(const std::string &filename) const;
+
+ private:
+  int _cols;
+  float _threshold;
+  float _fallbackCost;
+  std::vector<uint64_t> _rowStarts;
+  std::vector<uint32_t> _colIds;
+  std::vector<float> _values;
+};
+
+#endif  // SRC_DATABASE_SPARSE_COST_MATRIX_H_
@@ -0,0 +1,106 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include "database/sparse_cost_matrix_database.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+double valueToCost(double value) {
+  if (value < 1e-09) {
+    return std::numeric_limits<double>::max();
+  }
+  return 1. / value;
+}
+}  // namespace
+
+bool SparseCostMatrixDatabase::loadFromFile(const std::string &filename) {
+  auto matrixPtr = std::make_shared<SparseCostMatrix>();
+  if (!matrixPtr->open(filename)) {
+    return false;
+  }
+  _matrix = matrixPtr;
+  _fallbackCost = _matrix->fallbackCost();
+  printf(
+      "[INFO][SparseCostMatrixDatabase] The matrix has %d rows and %d cols, "
+      "%zu cells are stored\n",
+      _matrix->rows(), _matrix->cols(), _matrix->nonZeros());
+  return true;
+}
+
+int SparseCostMatrixDatabase::refSize() {
+  return _matrix ? _matrix->cols() : 0;
+}
+
+double SparseCostMatrixDatabase::getCost(int quId, int refId) {
+  if (!_matrix || quId >= _matrix->rows() || quId < 0) {
+    printf("[ERROR][SparseCostMatrixDatabase] Invalid query index %d\n", quId);
+    return -1;
+  }
+  if (refId >= _matrix->cols() || refId < 0) {
+    printf("[ERROR][SparseCostMatrixDatabase] Invalid query index %d\n",
+           refId);
+    return -1;
+  }
+  float value;
+  if (!_matrix->find(quId, refId, &value)) {
+    return _fallbackCost;
+  }
+  return valueToCost(value);
+}
+
+void SparseCostMatrixDatabase::getCosts(int quId, const int *refIds,
+                                        int count, double *costs) {
+  if (!_matrix || quId >= _matrix->rows() || quId < 0) {
+    printf("[ERROR][SparseCostMatrixDatabase] Invalid query index %d\n", quId);
+    std::fill(costs, costs + count, -1.0);
+    return;
+  }
+  const uint32_t *rowBegin = _matrix->colIds() + _matrix->rowBegin(quId);
+  const uint32_t *rowEnd = _matrix->colIds() + _matrix->rowEnd(quId);
+  const float *values = _matrix->values();
+  // the successors come in increasing order, so the search continues from
+  // the previous position
+  const uint32_t *pos = rowBegin;
+  int prevRefId = -1;
+  for (int i = 0; i < count; ++i) {
+    int refId = refIds[i];
+    if (static_cast<unsigned>(refId) >=
+        static_cast<unsigned>(_matrix->cols())) {
+      printf("[ERROR][SparseCostMatrixDatabase] Invalid query index %d\n",
+             refId);
+      costs[i] = -1;
+      continue;
+    }
+    if (refId < prevRefId) {
+      pos = rowBegin;
+    }
+    prevRefId = refId;
+    pos = std::lower_bound(pos, rowEnd, uint32_t(refId));
+    if (pos != rowEnd && *pos == uint32_t(refId)) {
+      costs[i] = valueToCost(values[pos - _matrix->colIds()]);
+    } else {
+      costs[i] = _fallbackCost;
+    }
+  }
+}
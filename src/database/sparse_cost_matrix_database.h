@@ -0,0 +1,58 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#ifndef SRC_DATABASE_SPARSE_COST_MATRIX_DATABASE_H_
+#define SRC_DATABASE_SPARSE_COST_MATRIX_DATABASE_H_
+
+#include <string>
+#include "database/online_database.h"
+#include "database/sparse_cost_matrix.h"
+
+/**
+ * @brief      Cost matrix database that keeps only the plausible matches
+ * (see SparseCostMatrix). The memory grows with the number of stored cells,
+ * not with the matrix size. The cells that are not stored have a constant
+ * fallback cost.
+ */
+class SparseCostMatrixDatabase : public OnlineDatabase {
+ public:
+  using Ptr = std::shared_ptr<SparseCostMatrixDatabase>;
+  using ConstPtr = std::shared_ptr<const SparseCostMatrixDatabase>;
+
+  bool loadFromFile(const std::string &filename);
+  /** overrides the fallback cost stored in the file **/
+  void setFallbackCost(double cost) { _fallbackCost = cost; }
+  double fallbackCost() const { return _fallbackCost; }
+
+  int refSize() override;
+  /** gets the stored similarity and transforms it 1/similarity **/
+  double getCost(int quId, int refId) override;
+  void getCosts(int quId, const int *refIds, int count,
+                double *costs) override;
+
+ private:
+  SparseCostMatrix::Ptr _matrix = nullptr;
+  double _fallbackCost = -1;
+};
+
+#endif  // SRC_DATABASE_SPARSE_COST_MATRIX_DATABASE_H_
@@ -0,0 +1,230 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include "database/tiled_cost_matrix.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <fstream>
+#include <limits>
+
+TiledCostMatrix::~TiledCostMatrix() {
+  if (_fd >= 0) {
+    close(_fd);
+  }
+}
+
+bool TiledCostMatrix::isTiledCostMatrix(const std::string &filename) {
+  std::ifstream in(filename, std::ios::binary);
+  char magic[sizeof(kTiledCostMatrixMagic)];
+  if (!in || !in.read(magic, sizeof(magic))) {
+    return false;
+  }
+  return memcmp(magic, kTiledCostMatrixMagic, sizeof(magic)) == 0;
+}
+
+bool TiledCostMatrix::open(const std::string &filename) {
+  if (_fd >= 0) {
+    close(_fd);
+  }
+  _tiles.clear();
+  _lru.clear();
+  _lastKey = -1;
+  _lastTile = nullptr;
+  _filename = filename;
+  _fd = ::open(filename.c_str(), O_RDONLY);
+  if (_fd < 0) {
+    printf("[ERROR][TiledCostMatrix] The file cannot be opened %s\n",
+           filename.c_str());
+    return false;
+  }
+  if (pread(_fd, &_header, sizeof(_header), 0) != sizeof(_header) ||
+      memcmp(_header.magic, kTiledCostMatrixMagic, sizeof(_header.magic)) !=
+          0 ||
+      _header.version != kTiledCostMatrixVersion || _header.tileSize == 0) {
+    printf("[ERROR][TiledCostMatrix] %s is not a tiled cost matrix\n",
+           filename.c_str());
+    close(_fd);
+    _fd = -1;
+    return false;
+  }
+  // the matrix is indexed with ints
+  const uint64_t kMaxSize = std::numeric_limits<int>::max();
+  if (_header.rows > kMaxSize || _header.cols > kMaxSize) {
+    printf("[ERROR][TiledCostMatrix] Invalid matrix size in %s\n",
+           filename.c_str());
+    close(_fd);
+    _fd = -1;
+    return false;
+  }
+  _tileRows = (_header.rows + _header.tileSize - 1) / _header.tileSize;
+  _tileCols = (_header.cols + _header.tileSize - 1) / _header.tileSize;
+  // all tiles are stored, compared by division so nothing overflows
+  struct stat info;
+  uint64_t tileValues = uint64_t(_header.tileSize) * _header.tileSize;
+  uint64_t available = 0;
+  if (fstat(_fd, &info) == 0 && uint64_t(info.st_size) >= sizeof(_header)) {
+    available = (info.st_size - sizeof(_header)) / sizeof(float);
+  }
+  if (tileValues > available ||
+      uint64_t(_tileRows) * _tileCols > available / tileValues) {
+    printf("[ERROR][TiledCostMatrix] The file %s is truncated\n",
+           filename.c_str());
+    close(_fd);
+    _fd = -1;
+    return false;
+  }
+  // the accesses are random from the OS point of view
+  posix_fadvise(_fd, 0, 0, POSIX_FADV_RANDOM);
+  return true;
+}
+
+void TiledCostMatrix::setCacheSize(int tiles) {
+  _cacheSize = std::max(1, tiles);
+  while (static_cast<int>(_tiles.size()) > _cacheSize) {
+    _tiles.erase(_lru.back());
+    _lru.pop_back();
+    _stats.evictions++;
+  }
+  _lastKey = -1;
+  _lastTile = nullptr;
+}
+
+uint64_t TiledCostMatrix::tileOffset(int64_t key) const {
+  uint64_t tileBytes =
+      uint64_t(_header.tileSize) * _header.tileSize * sizeof(float);
+  return sizeof(TiledCostMatrixHeader) + key * tileBytes;
+}
+
+const float *TiledCostMatrix::getTile(int tileRow, int tileCol) {
+  int64_t key = tileKey(tileRow, tileCol);
+  if (key == _lastKey) {
+    _stats.hits++;
+    return _lastTile;
+  }
+  auto found = _tiles.find(key);
+  if (found == _tiles.end()) {
+    _stats.misses++;
+    _lastTile = loadTile(key);
+  } else {
+    _stats.hits++;
+    _lru.splice(_lru.begin(), _lru, found->second.position);
+    _lastTile = found->second.values.data();
+  }
+  _lastKey = key;
+  return _lastTile;
+}
+
+const float *TiledCostMatrix::loadTile(int64_t key) {
+  Tile *tile;
+  if (static_cast<int>(_tiles.size()) >= _cacheSize) {
+    // reuse the memory of the least recently used tile
+    int64_t oldKey = _lru.back();
+    _lru.pop_back();
+    auto old = _tiles.find(oldKey);
+    std::vector<float> values;
+    values.swap(old->second.values);
+    _tiles.erase(old);
+    _stats.evictions++;
+    tile = &_tiles[key];
+    tile->values.swap(values);
+  } else {
+    tile = &_tiles[key];
+  }
+  size_t tileValues = size_t(_header.tileSize) * _header.tileSize;
+  tile->values.resize(tileValues);
+  _lru.push_front(key);
+  tile->position = _lru.begin();
+
+  char *dst = reinterpret_cast<char *>(tile->values.data());
+  size_t bytes = tileValues * sizeof(float);
+  uint64_t offset = tileOffset(key);
+  while (bytes > 0) {
+    ssize_t read = pread(_fd, dst, bytes, offset);
+    if (read <= 0) {
+      printf("[ERROR][TiledCostMatrix] Cannot read a tile from %s\n",
+             _filename.c_str());
+      exit(EXIT_FAILURE);
+    }
+    dst += read;
+    bytes -= read;
+    offset += read;
+  }
+  return tile->values.data();
+}
+
+void TiledCostMatrix::readAhead(int tileRow, int tileCol) const {
+  if (tileRow < 0 || tileRow >= _tileRows || tileCol < 0 ||
+      tileCol >= _tileCols) {
+    return;
+  }
+  int64_t key = tileKey(tileRow, tileCol);
+  if (_tiles.count(key) > 0) {
+    return;
+  }
+  uint64_t tileBytes =
+      uint64_t(_header.tileSize) * _header.tileSize * sizeof(float);
+  posix_fadvise(_fd, tileOffset(key), tileBytes, POSIX_FADV_WILLNEED);
+}
+
+bool saveTiledCostMatrix(const CostMatrixFile &matrix,
+                         const std::string &filename, int tileSize) {
+  if (tileSize < 1) {
+    printf("[ERROR][TiledCostMatrix] Invalid tile size %d\n", tileSize);
+    return false;
+  }
+  std::ofstream out(filename, std::ios::binary);
+  if (!out) {
+    printf("[ERROR][TiledCostMatrix] The file cannot be opened %s\n",
+           filename.c_str());
+    return false;
+  }
+  TiledCostMatrixHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kTiledCostMatrixMagic, sizeof(kTiledCostMatrixMagic));
+  header.version = kTiledCostMatrixVersion;
+  header.tileSize = tileSize;
+  header.rows = matrix.rows();
+  header.cols = matrix.cols();
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+  int tileCols = (matrix.cols() + tileSize - 1) / tileSize;
+  std::vector<float> tileRow(size_t(tileCols) * tileSize * tileSize);
+  for (int r0 = 0; r0 < matrix.rows(); r0 += tileSize) {
+    std::fill(tileRow.begin(), tileRow.end(), 0.f);
+    int rows = std::min(tileSize, matrix.rows() - r0);
+    for (int r = 0; r < rows; ++r) {
+      for (int c = 0; c < matrix.cols(); ++c) {
+        size_t tile = c / tileSize;
+        tileRow[(tile * tileSize + r) * tileSize + c % tileSize] =
+            matrix.at(r0 + r, c);
+      }
+    }
+    out.write(reinterpret_cast<const char *>(tileRow.data()),
+              tileRow.size() * sizeof(float));
+  }
+  return static_cast<bool>(out);
+}
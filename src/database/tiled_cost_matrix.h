@@ -0,0 +1,144 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#ifndef SRC_DATABASE_TILED_COST_MATRIX_H_
+#define SRC_DATABASE_TILED_COST_MATRIX_H_
+
+#include <stdint.h>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "database/cost_matrix_file.h"
+
+/**
+ * Tiled cost matrix layout: a 64 byte TiledCostMatrixHeader followed by the
+ * float32 tiles of `tileSize` x `tileSize` values. The tiles are stored row
+ * by row, every tile is row-major. The tiles at the right and bottom border
+ * are padded with zeros, so every tile has the same size.
+ */
+struct TiledCostMatrixHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t tileSize;
+  uint64_t rows;
+  uint64_t cols;
+  uint64_t reserved[5];
+};
+
+const char kTiledCostMatrixMagic[8] = {'V', 'P', 'R', 'T', 'I', 'L', 'E',
+                                       '\0'};
+const uint32_t kTiledCostMatrixVersion = 1;
+
+/**
+ * @brief      Reads a tiled cost matrix that does not need to fit in the RAM.
+ * Only a bounded number of tiles is kept, the least recently used tile is
+ * dropped first.
+ */
+class TiledCostMatrix {
+ public:
+  using Ptr = std::shared_ptr<TiledCostMatrix>;
+  using ConstPtr = std::shared_ptr<const TiledCostMatrix>;
+
+  struct Stats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+  };
+
+  TiledCostMatrix() {}
+  ~TiledCostMatrix();
+  TiledCostMatrix(const TiledCostMatrix &) = delete;
+  TiledCostMatrix &operator=(const TiledCostMatrix &) = delete;
+
+  static bool isTiledCostMatrix(const std::string &filename);
+
+  bool open(const std::string &filename);
+  /** maximal number of tiles kept in memory **/
+  void setCacheSize(int tiles);
+
+  int rows() const { return _header.rows; }
+  int cols() const { return _header.cols; }
+  int tileSize() const { return _header.tileSize; }
+
+  float at(int row, int col) {
+    int tileSize = _header.tileSize;
+    const float *tile = getTile(row / tileSize, col / tileSize);
+    return tile[(row % tileSize) * tileSize + col % tileSize];
+  }
+  /**
+   * @brief      Returns the tile values, row-major. The pointer is valid
+   * until the next tile is loaded.
+   */
+  const float *getTile(int tileRow, int tileCol);
+  /**
+   * @brief      Asks the OS to read the tile in the background. Does not
+   * change the cache.
+   */
+  void readAhead(int tileRow, int tileCol) const;
+
+  const Stats &stats() const { return _stats; }
+
+ private:
+  struct Tile {
+    std::vector<float> values;
+    std::list<int64_t>::iterator position;
+  };
+
+  int64_t tileKey(int tileRow, int tileCol) const {
+    return int64_t(tileRow) * _tileCols + tileCol;
+  }
+  uint64_t tileOffset(int64_t key) const;
+  const float *loadTile(int64_t key);
+
+  int _fd = -1;
+  std::string _filename;
+  TiledCostMatrixHeader _header;
+  int _tileRows = 0;
+  int _tileCols = 0;
+  int _cacheSize = 64;
+
+  std::unordered_map<int64_t, Tile> _tiles;
+  // most recently used tiles in front
+  std::list<int64_t> _lru;
+  // the last accessed tile, most accesses hit it
+  int64_t _lastKey = -1;
+  const float *_lastTile = nullptr;
+  Stats _stats;
+};
+
+/**
+ * @brief      Converts a cost matrix into the tiled layout. Reads one row of
+ * tiles at a time, so the matrix does not need to fit in the RAM.
+ *
+ * @param[in]  matrix    The mapped cost matrix
+ * @param[in]  filename  The output filename
+ * @param[in]  tileSize  The tile size
+ *
+ * @return     false if the file cannot be written.
+ */
+bool saveTiledCostMatrix(const CostMatrixFile &matrix,
+                         const std::string &filename, int tileSize = 256);
+
+#endif  // SRC_DATABASE_TILED_COST_MATRIX_H_
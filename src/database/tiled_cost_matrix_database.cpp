@@ -0,0 +1,93 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include "database/tiled_cost_matrix_database.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+double valueToCost(double value) {
+  if (value < 1e-09) {
+    return std::numeric_limits<double>::max();
+  }
+  return 1. / value;
+}
+}  // namespace
+
+bool TiledCostMatrixDatabase::loadFromFile(const std::string &filename) {
+  if (!_matrix.open(filename)) {
+    return false;
+  }
+  printf("[INFO][TiledCostMatrixDatabase] The matrix has %d rows and %d cols\n",
+         _matrix.rows(), _matrix.cols());
+  _lastFocusQuId = -1;
+  _lastFocusRefId = -1;
+  return true;
+}
+
+int TiledCostMatrixDatabase::refSize() { return _matrix.cols(); }
+
+double TiledCostMatrixDatabase::getCost(int quId, int refId) {
+  if (quId >= _matrix.rows() || quId < 0) {
+    printf("[ERROR][TiledCostMatrixDatabase] Invalid query index %d\n", quId);
+    return -1;
+  }
+  if (refId >= _matrix.cols() || refId < 0) {
+    printf("[ERROR][TiledCostMatrixDatabase] Invalid query index %d\n",
+           refId);
+    return -1;
+  }
+  return valueToCost(_matrix.at(quId, refId));
+}
+
+void TiledCostMatrixDatabase::getCosts(int quId, const int *refIds, int count,
+                                       double *costs) {
+  for (int i = 0; i < count; ++i) {
+    costs[i] = getCost(quId, refIds[i]);
+  }
+}
+
+void TiledCostMatrixDatabase::setSearchFocus(int quId, int refId,
+                                             int radius) {
+  int tileSize = _matrix.tileSize();
+  // references passed per query image, the path usually goes diagonally
+  double slope = 1.0;
+  if (_lastFocusQuId >= 0 && quId > _lastFocusQuId) {
+    slope = double(refId - _lastFocusRefId) / (quId - _lastFocusQuId);
+  }
+  _lastFocusQuId = quId;
+  _lastFocusRefId = refId;
+
+  // the tiles of the next tile row along the predicted path
+  int nextQuId = (quId / tileSize + 1) * tileSize;
+  int nextRefId = refId + slope * (nextQuId - quId);
+  int tileRow = nextQuId / tileSize;
+  for (int tileCol = (nextRefId - radius) / tileSize;
+       tileCol <= (nextRefId + radius) / tileSize; ++tileCol) {
+    _matrix.readAhead(tileRow, tileCol);
+  }
+  // and the next tiles in the same tile row, if the path leaves them
+  int sideRefId = slope >= 0 ? refId + radius + tileSize / 2
+                             : refId - radius - tileSize / 2;
+  _matrix.readAhead(quId / tileSize, sideRefId / tileSize);
+}
@@ -0,0 +1,66 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#ifndef SRC_DATABASE_TILED_COST_MATRIX_DATABASE_H_
+#define SRC_DATABASE_TILED_COST_MATRIX_DATABASE_H_
+
+#include <string>
+#include "database/online_database.h"
+#include "database/tiled_cost_matrix.h"
+
+/**
+ * @brief      Cost matrix database for matrices that do not fit in the RAM.
+ * The matrix is read tile by tile from a tiled cost matrix file (created by
+ * the tile_cost_matrix app). Tiles on the predicted path are read ahead.
+ */
+class TiledCostMatrixDatabase : public OnlineDatabase {
+ public:
+  using Ptr = std::shared_ptr<TiledCostMatrixDatabase>;
+  using ConstPtr = std::shared_ptr<const TiledCostMatrixDatabase>;
+
+  bool loadFromFile(const std::string &filename);
+  /** maximal number of tiles kept in memory **/
+  void setCacheSize(int tiles) { _matrix.setCacheSize(tiles); }
+
+  int refSize() override;
+  /** gets the original cost and transforms it 1/cost **/
+  double getCost(int quId, int refId) override;
+  void getCosts(int quId, const int *refIds, int count,
+                double *costs) override;
+  /** the tile cache is not shared between threads **/
+  bool isThreadSafe() const override { return false; }
+  /**
+   * @brief      Reads ahead the tiles, which the path reaches next if it
+   * keeps its current direction.
+   */
+  void setSearchFocus(int quId, int refId, int radius) override;
+
+  const TiledCostMatrix::Stats &tileStats() const { return _matrix.stats(); }
+
+ private:
+  TiledCostMatrix _matrix;
+  int _lastFocusQuId = -1;
+  int _lastFocusRefId = -1;
+};
+
+#endif  // SRC_DATABASE_TILED_COST_MATRIX_DATABASE_H_
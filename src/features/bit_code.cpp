@@ -0,0 +1,99 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include "features/bit_code.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+BitCode::BitCode(const std::vector<bool> &bits) {
+  pack(bits.size(), [&bits](size_t i) { return bits[i]; });
+}
+
+void BitCode::clear() {
+  _words.clear();
+  _size = 0;
+}
+
+void BitCode::assign(size_t size, bool value) {
+  _size = size;
+  _words.assign((size + 63) / 64, value ? ~uint64_t(0) : 0);
+  if (value && (size & 63)) {
+    _words.back() = (uint64_t(1) << (size & 63)) - 1;
+  }
+}
+
+void BitCode::assignWords(const uint64_t *words, size_t size) {
+  _size = size;
+  _words.assign(words, words + (size + 63) / 64);
+  if (size & 63) {
+    _words.back() &= (uint64_t(1) << (size & 63)) - 1;
+  }
+}
+
+size_t BitCode::count() const {
+  size_t bits = 0;
+  for (uint64_t word : _words) {
+    bits += __builtin_popcountll(word);
+  }
+  return bits;
+}
+
+std::vector<bool> BitCode::toVector() const {
+  std::vector<bool> bits(_size, false);
+  forEachSetBit([&bits](size_t i) { bits[i] = true; });
+  return bits;
+}
+
+size_t hammingDistance(const BitCode &lhs, const BitCode &rhs) {
+  if (lhs.size() != rhs.size()) {
+    printf("[ERROR][BitCode] Codes have different sizes %lu and %lu\n",
+           lhs.size(), rhs.size());
+    exit(EXIT_FAILURE);
+  }
+  const uint64_t *l = lhs.words();
+  const uint64_t *r = rhs.words();
+  size_t distance = 0;
+  for (size_t w = 0; w < lhs.numWords(); ++w) {
+    distance += __builtin_popcountll(l[w] ^ r[w]);
+  }
+  return distance;
+}
+
+double jaccardSimilarity(const BitCode &lhs, const BitCode &rhs) {
+  if (lhs.size() != rhs.size()) {
+    printf("[ERROR][BitCode] Codes have different sizes %lu and %lu\n",
+           lhs.size(), rhs.size());
+    exit(EXIT_FAILURE);
+  }
+  const uint64_t *l = lhs.words();
+  const uint64_t *r = rhs.words();
+  size_t intersection = 0, unification = 0;
+  for (size_t w = 0; w < lhs.numWords(); ++w) {
+    intersection += __builtin_popcountll(l[w] & r[w]);
+    unification += __builtin_popcountll(l[w] | r[w]);
+  }
+  if (unification == 0) {
+    return 1.0;
+  }
+  return static_cast<double>(intersection) / unification;
+}
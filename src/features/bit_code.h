@@ -0,0 +1,127 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#ifndef SRC_FEATURES_BIT_CODE_H_
+#define SRC_FEATURES_BIT_CODE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+/**
+ * @brief      Binary code packed into 64 bit words. Bit i is stored in word
+ * i / 64 at position i % 64. The unused bits of the last word are always 0, so
+ * the words can be compared, counted and handed over to indexes directly.
+ */
+class BitCode {
+ public:
+  BitCode() {}
+  explicit BitCode(size_t size, bool value = false) { assign(size, value); }
+  /** allows to set the bits from a std::vector<bool> **/
+  BitCode(const std::vector<bool> &bits);  // NOLINT
+
+  size_t size() const { return _size; }
+  bool empty() const { return _size == 0; }
+  void clear();
+  void assign(size_t size, bool value);
+  /** copies `size` bits from the packed words **/
+  void assignWords(const uint64_t *words, size_t size);
+
+  /**
+   * @brief      Sets the code of `size` bits, one word at a time.
+   *
+   * @param[in]  size  The number of bits
+   * @param[in]  isSet returns the value of bit i
+   */
+  template <typename Predicate>
+  void pack(size_t size, Predicate isSet);
+
+  bool operator[](size_t i) const {
+    return (_words[i >> 6] >> (i & 63)) & 1;
+  }
+  void set(size_t i, bool value = true) {
+    if (value) {
+      _words[i >> 6] |= uint64_t(1) << (i & 63);
+    } else {
+      _words[i >> 6] &= ~(uint64_t(1) << (i & 63));
+    }
+  }
+
+  const uint64_t *words() const { return _words.data(); }
+  size_t numWords() const { return _words.size(); }
+  /** heap memory of the packed words in bytes **/
+  size_t memorySize() const { return _words.capacity() * sizeof(uint64_t); }
+
+  /** number of set bits **/
+  size_t count() const;
+  /** calls f(i) for every set bit i in increasing order **/
+  template <typename Function>
+  void forEachSetBit(Function f) const;
+  std::vector<bool> toVector() const;
+
+  bool operator==(const BitCode &rhs) const {
+    return _size == rhs._size && _words == rhs._words;
+  }
+  bool operator!=(const BitCode &rhs) const { return !(*this == rhs); }
+
+ private:
+  std::vector<uint64_t> _words;
+  size_t _size = 0;
+};
+
+/** number of different bits. Codes should have the same size **/
+size_t hammingDistance(const BitCode &lhs, const BitCode &rhs);
+/**
+ * @brief      Jaccard similarity of the set bits: |lhs & rhs| / |lhs | rhs|.
+ * Returns 1 if both codes have no set bits.
+ */
+double jaccardSimilarity(const BitCode &lhs, const BitCode &rhs);
+
+template <typename Predicate>
+void BitCode::pack(size_t size, Predicate isSet) {
+  _size = size;
+  _words.assign((size + 63) / 64, 0);
+  for (size_t w = 0; w < _words.size(); ++w) {
+    uint64_t word = 0;
+    size_t begin = w * 64;
+    size_t end = begin + 64 < size ? begin + 64 : size;
+    for (size_t i = begin; i < end; ++i) {
+      word |= uint64_t(isSet(i) ? 1 : 0) << (i - begin);
+    }
+    _words[w] = word;
+  }
+}
+
+template <typename Function>
+void BitCode::forEachSetBit(Function f) const {
+  for (size_t w = 0; w < _words.size(); ++w) {
+    uint64_t word = _words[w];
+    while (word) {
+      f(w * 64 + __builtin_ctzll(word));
+      // clears the lowest set bit
+      word &= word - 1;
+    }
+  }
+}
+
+#endif  // SRC_FEATURES_BIT_CODE_H_
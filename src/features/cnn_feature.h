@@ -63,10 +63,25 @@ class CnnFeature : public iBinarizableFeature {
    */
   double score2cost(double score) const override;
   void disp() const override;
+  size_t memorySize() const override {
+    return sizeof(*this) + dim.capacity() * sizeof(double) +
+           bits.memorySize();
+  }
+
+  /**
+   * @brief      L2 norm of `dim`. It is computed once on loading. If `dim`
+   * is set manually, call updateNorm() afterwards, otherwise the norm is
+   * recomputed on every call.
+   */
+  double norm() const;
+  void updateNorm();
 
   std::vector<double> dim;
   using iBinarizableFeature::bits;
 
+ protected:
+  double _norm = -1.0;
+
  private:
   void binarize();
 };
@@ -22,36 +22,27 @@
 **/
 
 #include <string>
-#include <fstream>
 #include <algorithm>
 #include <numeric>
 #include <math.h>
 #include "cnn_feature_mean.h"
+#include "features/feature_file.h"
 
 
 void CnnFeatureMean::loadFromFile(const std::string &filename) {
   // Timer timer;
   // timer.start();
-  std::ifstream in(filename.c_str());
-  if (!in) {
+  // binary features are mapped directly, text files are parsed as a fallback
+  FeatureFileHeader header;
+  if (!loadFeatureValues(filename, TEXT_WITH_DIMS, &dim, &header)) {
     printf("[ERROR][OnlineDatabase] Feature %s cannot be loaded\n",
            filename.c_str());
     exit(EXIT_FAILURE);
   }
-  int n, r, c;
-  in >> n >> r >> c;
-  int num_of_elements = n * r * c;
-  dim.reserve(num_of_elements);
-
-  while (!in.eof()) {
-    double value;
-    in >> value;
-    dim.push_back(value);
-  }
-  in.close();
   // timer.stop();
   // cout << "Feature loading time: ";
   // timer.print_elapsed_time(TimeExt::MSec);
+  _norm = header.norm;
   binarize();
 }
 
@@ -68,12 +59,10 @@ void CnnFeatureMean::binarize() {
   d_max = *min_maxEl.second;
   double tmp = (des_max - des_min) / (d_max - d_min);
 
-  bits.resize(dim.size(), 0);
-
   int thresh = (mean - d_min) * tmp + des_min;
-  for (int f = 0; f < dim.size(); ++f) {
+  // the bits are packed one word at a time
+  bits.pack(dim.size(), [&](size_t f) {
     int d_int = (dim[f] - d_min) * tmp + des_min;
-    bool value = d_int < thresh ? 0 : 1;
-    bits[f] = value;
-  }
+    return d_int >= thresh;
+  });
 }
@@ -0,0 +1,135 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include "features/cnn_feature_sparse.h"
+#include <math.h>
+#include <algorithm>
+#include <limits>
+#include "features/feature_file.h"
+
+double sparseDot(const uint32_t *lhsIdx, const double *lhsVal, size_t lhsNnz,
+                 const uint32_t *rhsIdx, const double *rhsVal, size_t rhsNnz) {
+  double prod = 0.0;
+  size_t l = 0, r = 0;
+  while (l < lhsNnz && r < rhsNnz) {
+    if (lhsIdx[l] < rhsIdx[r]) {
+      ++l;
+    } else if (rhsIdx[r] < lhsIdx[l]) {
+      ++r;
+    } else {
+      prod += lhsVal[l] * rhsVal[r];
+      ++l;
+      ++r;
+    }
+  }
+  return prod;
+}
+
+void CnnFeatureSparse::loadFromFile(const std::string &filename) {
+  std::vector<double> dense;
+  if (!loadFeatureValues(filename, TEXT_WITH_DIMS, &dense)) {
+    printf("[ERROR][CnnFeatureSparse] Feature %s cannot be loaded\n",
+           filename.c_str());
+    exit(EXIT_FAILURE);
+  }
+  setValues(dense);
+}
+
+void CnnFeatureSparse::setValues(const std::vector<double> &dense) {
+  _size = dense.size();
+  indices.clear();
+  values.clear();
+  double sqSum = 0.0;
+  for (size_t i = 0; i < dense.size(); ++i) {
+    if (dense[i] != 0.0) {
+      indices.push_back(i);
+      values.push_back(dense[i]);
+      sqSum += dense[i] * dense[i];
+    }
+  }
+  indices.shrink_to_fit();
+  values.shrink_to_fit();
+  _norm = sqrt(sqSum);
+  binarize();
+}
+
+void CnnFeatureSparse::binarize() {
+  bits.clear();
+  if (_size == 0) {
+    return;
+  }
+  int des_max = 255, des_min = 0;  // des_ - desired params
+  double d_min = 0.0, d_max = 0.0;
+  if (!values.empty()) {
+    auto min_maxEl = std::minmax_element(values.begin(), values.end());
+    d_min = *min_maxEl.first;
+    d_max = *min_maxEl.second;
+    // zeros are part of the dense feature
+    if (values.size() < _size) {
+      d_min = std::min(d_min, 0.0);
+      d_max = std::max(d_max, 0.0);
+    }
+  }
+  double tmp = (des_max - des_min) / (d_max - d_min);
+  int thresh = des_max / 2;
+
+  // all the zero values get the same bit
+  int zero_int = (0.0 - d_min) * tmp + des_min;
+  bits.assign(_size, zero_int >= thresh);
+  for (size_t i = 0; i < values.size(); ++i) {
+    int d_int = (values[i] - d_min) * tmp + des_min;
+    bits.set(indices[i], d_int >= thresh);
+  }
+}
+
+double CnnFeatureSparse::computeSimilarityScore(
+    const iFeature::ConstPtr &rhs) const {
+  const auto featurePtr = std::dynamic_pointer_cast<const CnnFeatureSparse>(rhs);
+  if (!featurePtr) {
+    printf(
+        "[ERROR][Feature] It seems like you are trying to match features of "
+        "different type\n");
+    exit(EXIT_FAILURE);
+  }
+  double prod_qr_db =
+      sparseDot(indices.data(), values.data(), values.size(),
+                featurePtr->indices.data(), featurePtr->values.data(),
+                featurePtr->values.size());
+  return prod_qr_db / (_norm * featurePtr->_norm);
+}
+
+double CnnFeatureSparse::score2cost(double score) const {
+  double cost;
+  if (score < 1e-09) {
+    cost = std::numeric_limits<double>::max();
+    printf("[INFO] The cost of comparing two images is suspiciously small.\n");
+  } else {
+    cost = 1. / score;
+  }
+  return cost;
+}
+
+void CnnFeatureSparse::disp() const {
+  printf("[INFO][CnnFeatureSparse] %lu non-zero values out of %lu\n",
+         values.size(), _size);
+}
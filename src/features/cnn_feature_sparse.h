@@ -0,0 +1,101 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#ifndef SRC_FEATURES_CNN_FEATURE_SPARSE_H_
+#define SRC_FEATURES_CNN_FEATURE_SPARSE_H_
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "features/ibinarizable_feature.h"
+
+/**
+ * @brief      Sparse version of the CnnFeature. OverFeat features are mostly
+ * zeros after the ReLU, so only the non-zero values are stored together with
+ * their indices (sorted in increasing order). Produces the same scores and
+ * bits as CnnFeature (mid binarization).
+ */
+class CnnFeatureSparse : public iBinarizableFeature {
+ public:
+  using Ptr = std::shared_ptr<CnnFeatureSparse>;
+  using ConstPtr = std::shared_ptr<const CnnFeatureSparse>;
+
+  /**
+   * @brief      Loads a feature in the same formats as CnnFeature and keeps
+   * only the non-zero values.
+   *
+   * @param[in]  filename  The filename
+   */
+  void loadFromFile(const std::string &filename) override;
+  /**
+   * @brief      sets the feature from dense values
+   *
+   * @param[in]  values  The dense values
+   */
+  void setValues(const std::vector<double> &values);
+  /**
+   * @brief      computes the cosine distance between two sparse vectors
+   *
+   * @param[in]  rhs   The right hand side
+   *
+   * @return     The similarity score.
+   */
+  double computeSimilarityScore(const iFeature::ConstPtr &rhs) const override;
+  /**
+   * @brief      weight/cost is an inverse of a score.
+   *
+   * @param[in]  score  The score
+   *
+   * @return    weight/cost. If cost is near to 0, returns the
+   * std::numeric_limits<double>::max()
+   */
+  double score2cost(double score) const override;
+  void disp() const override;
+  size_t memorySize() const override {
+    return sizeof(*this) + indices.capacity() * sizeof(uint32_t) +
+           values.capacity() * sizeof(double) + bits.memorySize();
+  }
+
+  /** number of values of the dense feature **/
+  size_t size() const { return _size; }
+  /** number of non-zero values **/
+  size_t nnz() const { return values.size(); }
+  double norm() const { return _norm; }
+
+  std::vector<uint32_t> indices;
+  std::vector<double> values;
+  using iBinarizableFeature::bits;
+
+ private:
+  void binarize();
+
+  size_t _size = 0;
+  double _norm = 0.0;
+};
+
+/**
+ * @brief      dot product of two sparse vectors with sorted indices
+ */
+double sparseDot(const uint32_t *lhsIdx, const double *lhsVal, size_t lhsNnz,
+                 const uint32_t *rhsIdx, const double *rhsVal, size_t rhsNnz);
+
+#endif  // SRC_FEATURES_CNN_FEATURE_SPARSE_H_
@@ -0,0 +1,144 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include "features/compact_feature.h"
+#include <math.h>
+#include <algorithm>
+#include <limits>
+#include "features/cnn_feature.h"
+#include "features/dot_kernels.h"
+#include "features/feature_view.h"
+#include "features/vgg_feature.h"
+
+CompactFeature::CompactFeature(const iFeature::Ptr &loader, Storage storage)
+    : _loader(loader), _storage(storage) {}
+
+void CompactFeature::loadFromFile(const std::string &filename) {
+  if (!_loader) {
+    printf("[ERROR][CompactFeature] No feature to load %s with\n",
+           filename.c_str());
+    exit(EXIT_FAILURE);
+  }
+  _loader->loadFromFile(filename);
+  std::vector<double> *dim = nullptr;
+  BitCode *loadedBits = nullptr;
+  if (auto cnn = std::dynamic_pointer_cast<CnnFeature>(_loader)) {
+    dim = &cnn->dim;
+    loadedBits = &cnn->bits;
+  } else if (auto vgg = std::dynamic_pointer_cast<VggFeature>(_loader)) {
+    dim = &vgg->dim;
+    loadedBits = &vgg->bits;
+  }
+  if (!dim) {
+    printf(
+        "[ERROR][CompactFeature] Only dense features can be stored in a "
+        "compact way\n");
+    exit(EXIT_FAILURE);
+  }
+  setValues(*dim);
+  bits = *loadedBits;
+  // the dense values are not needed anymore
+  std::vector<double>().swap(*dim);
+  loadedBits->clear();
+}
+
+void CompactFeature::setValues(const std::vector<double> &values) {
+  _size = values.size();
+  _float32.clear();
+  _int8.clear();
+  if (_storage == FLOAT32) {
+    _float32.assign(values.begin(), values.end());
+    _norm = sqrt(dotProduct(_float32.data(), _float32.data(), _size));
+    return;
+  }
+  double maxAbs = 0.0;
+  for (double v : values) {
+    maxAbs = std::max(maxAbs, fabs(v));
+  }
+  // symmetric quantization to [-127, 127]
+  _scale = maxAbs > 0 ? maxAbs / 127.0 : 1.0;
+  _int8.resize(_size);
+  for (size_t i = 0; i < _size; ++i) {
+    _int8[i] = static_cast<int8_t>(lround(values[i] / _scale));
+  }
+  _norm = sqrt(static_cast<double>(dotProduct(_int8.data(), _int8.data(),
+                                              _size))) *
+          _scale;
+}
+
+double CompactFeature::computeSimilarityScore(
+    const iFeature::ConstPtr &rhs) const {
+  const auto featurePtr = std::dynamic_pointer_cast<const CompactFeature>(rhs);
+  if (!featurePtr) {
+    // archived features are matched by the view
+    if (const auto view = dynamic_cast<const FeatureView *>(rhs.get())) {
+      return view->similarityTo(*this);
+    }
+  }
+  if (!featurePtr || featurePtr->_storage != _storage) {
+    printf(
+        "[ERROR][Feature] It seems like you are trying to match features of "
+        "different type\n");
+    exit(EXIT_FAILURE);
+  }
+  double prod_qr_db;
+  if (_storage == FLOAT32) {
+    prod_qr_db = dotProduct(featurePtr->_float32.data(), _float32.data(),
+                            featurePtr->_size);
+  } else {
+    prod_qr_db = dotProduct(featurePtr->_int8.data(), _int8.data(),
+                            featurePtr->_size) *
+                 (_scale * featurePtr->_scale);
+  }
+  return prod_qr_db / (_norm * featurePtr->_norm);
+}
+
+double CompactFeature::dot(const double *values, size_t n) const {
+  double prod = 0.0;
+  if (_storage == FLOAT32) {
+    for (size_t i = 0; i < n; ++i) {
+      prod += _float32[i] * values[i];
+    }
+    return prod;
+  }
+  for (size_t i = 0; i < n; ++i) {
+    prod += _int8[i] * values[i];
+  }
+  return prod * _scale;
+}
+
+double CompactFeature::score2cost(double score) const {
+  double cost;
+  if (score < 1e-09) {
+    cost = std::numeric_limits<double>::max();
+    printf("[INFO] The cost of comparing two images is suspiciously small.\n");
+  } else {
+    cost = 1. / score;
+  }
+  return cost;
+}
+
+void CompactFeature::disp() const {
+  printf("[INFO][CompactFeature] %s feature with %lu values\n",
+         _storage == FLOAT32 ? "float32" : "int8", _size);
+}
@@ -0,0 +1,99 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#ifndef SRC_FEATURES_COMPACT_FEATURE_H_
+#define SRC_FEATURES_COMPACT_FEATURE_H_
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "features/ibinarizable_feature.h"
+
+/**
+ * @brief      Stores the values of a dense feature (CnnFeature, VggFeature and
+ * their mean versions) in float32 or as int8 with one symmetric scale per
+ * feature. The feature is loaded and binarized by the dense feature, then the
+ * double values are released. Takes 2 (float32) or 8 (int8) times less memory.
+ */
+class CompactFeature : public iBinarizableFeature {
+ public:
+  using Ptr = std::shared_ptr<CompactFeature>;
+  using ConstPtr = std::shared_ptr<const CompactFeature>;
+
+  enum Storage { FLOAT32, INT8 };
+
+  /**
+   * @param[in]  loader   dense feature used to read and binarize the files
+   * @param[in]  storage  The storage
+   */
+  CompactFeature(const iFeature::Ptr &loader, Storage storage);
+
+  void loadFromFile(const std::string &filename) override;
+  /** converts the dense values into the compact storage **/
+  void setValues(const std::vector<double> &values);
+  /**
+   * @brief      computes the cosine distance between two compact features of
+   * the same storage type.
+   *
+   * @param[in]  rhs   The right hand side
+   *
+   * @return     The similarity score.
+   */
+  double computeSimilarityScore(const iFeature::ConstPtr &rhs) const override;
+  /**
+   * @brief      weight/cost is an inverse of a score.
+   *
+   * @param[in]  score  The score
+   *
+   * @return    weight/cost. If cost is near to 0, returns the
+   * std::numeric_limits<double>::max()
+   */
+  double score2cost(double score) const override;
+  void disp() const override;
+  size_t memorySize() const override {
+    return sizeof(*this) + _float32.capacity() * sizeof(float) +
+           _int8.capacity() * sizeof(int8_t) + bits.memorySize();
+  }
+
+  /** dot product with dense double values of the same size **/
+  double dot(const double *values, size_t n) const;
+
+  Storage storage() const { return _storage; }
+  size_t size() const { return _size; }
+  /** norm of the stored (rounded) values **/
+  double norm() const { return _norm; }
+  /** dequantization scale of the int8 values **/
+  double scale() const { return _scale; }
+
+  using iBinarizableFeature::bits;
+
+ private:
+  iFeature::Ptr _loader;
+  Storage _storage;
+  std::vector<float> _float32;
+  std::vector<int8_t> _int8;
+  double _scale = 1.0;
+  double _norm = 0.0;
+  size_t _size = 0;
+};
+
+#endif  // SRC_FEATURES_COMPACT_FEATURE_H_
@@ -0,0 +1,587 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include "features/dot_kernels.h"
+#include <math.h>
+#include <stdio.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define VPR_DOT_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+namespace {
+
+struct DotKernels {
+  double (*dot64)(const double *, const double *, size_t);
+  double (*dot32)(const float *, const float *, size_t);
+  int64_t (*dot8)(const int8_t *, const int8_t *, size_t);
+  void (*normDot64)(const double *, const double *, size_t, double *,
+                    double *, double *);
+  void (*normDot32)(const float *, const float *, size_t, double *, double *,
+                    double *);
+};
+
+// ---------------------------------------------------------------- scalar
+
+template <typename T>
+double dotScalar(const T *a, const T *b, size_t n) {
+  // 4 independent sums let the compiler keep the pipeline busy
+  double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    s0 += double(a[i]) * b[i];
+    s1 += double(a[i + 1]) * b[i + 1];
+    s2 += double(a[i + 2]) * b[i + 2];
+    s3 += double(a[i + 3]) * b[i + 3];
+  }
+  for (; i < n; ++i) {
+    s0 += double(a[i]) * b[i];
+  }
+  return (s0 + s1) + (s2 + s3);
+}
+
+int64_t dotScalarInt8(const int8_t *a, const int8_t *b, size_t n) {
+  int64_t sum = 0;
+  for (size_t i = 0; i < n; ++i) {
+    sum += int32_t(a[i]) * b[i];
+  }
+  return sum;
+}
+
+// number of vector iterations after which the int32 sums of the int8
+// kernels are moved to int64, so they cannot overflow
+const size_t kInt8FlushIterations = 16384;
+
+template <typename T>
+void normDotScalar(const T *a, const T *b, size_t n, double *aa, double *bb,
+                   double *ab) {
+  double sa = 0.0, sb = 0.0, sab = 0.0;
+  for (size_t i = 0; i < n; ++i) {
+    double x = a[i], y = b[i];
+    sa += x * x;
+    sb += y * y;
+    sab += x * y;
+  }
+  *aa = sa;
+  *bb = sb;
+  *ab = sab;
+}
+
+const DotKernels kScalarKernels = {dotScalar<double>, dotScalar<float>,
+                                   dotScalarInt8, normDotScalar<double>,
+                                   normDotScalar<float>};
+
+#ifdef VPR_DOT_KERNELS_X86
+
+// ------------------------------------------------------------------ SSE2
+
+__attribute__((target("sse2"))) double dotSse2(const double *a,
+                                               const double *b, size_t n) {
+  __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    acc0 =
+        _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+    acc1 = _mm_add_pd(
+        acc1, _mm_mul_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2)));
+  }
+  double tmp[2];
+  _mm_storeu_pd(tmp, _mm_add_pd(acc0, acc1));
+  double sum = tmp[0] + tmp[1];
+  for (; i < n; ++i) {
+    sum += a[i] * b[i];
+  }
+  return sum;
+}
+
+__attribute__((target("sse2"))) double dotSse2(const float *a, const float *b,
+                                               size_t n) {
+  // the products of floats are exact in double, only the sums round
+  __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m128 x = _mm_loadu_ps(a + i);
+    __m128 y = _mm_loadu_ps(b + i);
+    acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_cvtps_pd(x), _mm_cvtps_pd(y)));
+    acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(x, x)),
+                                       _mm_cvtps_pd(_mm_movehl_ps(y, y))));
+  }
+  double tmp[2];
+  _mm_storeu_pd(tmp, _mm_add_pd(acc0, acc1));
+  double sum = tmp[0] + tmp[1];
+  for (; i < n; ++i) {
+    sum += double(a[i]) * b[i];
+  }
+  return sum;
+}
+
+__attribute__((target("sse2"))) void normDotSse2(const double *a,
+                                                 const double *b, size_t n,
+                                                 double *aa, double *bb,
+                                                 double *ab) {
+  __m128d accA = _mm_setzero_pd(), accB = _mm_setzero_pd(),
+          accAB = _mm_setzero_pd();
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    __m128d x = _mm_loadu_pd(a + i);
+    __m128d y = _mm_loadu_pd(b + i);
+    accA = _mm_add_pd(accA, _mm_mul_pd(x, x));
+    accB = _mm_add_pd(accB, _mm_mul_pd(y, y));
+    accAB = _mm_add_pd(accAB, _mm_mul_pd(x, y));
+  }
+  double tA[2], tB[2], tAB[2];
+  _mm_storeu_pd(tA, accA);
+  _mm_storeu_pd(tB, accB);
+  _mm_storeu_pd(tAB, accAB);
+  double sa = tA[0] + tA[1], sb = tB[0] + tB[1], sab = tAB[0] + tAB[1];
+  for (; i < n; ++i) {
+    sa += a[i] * a[i];
+    sb += b[i] * b[i];
+    sab += a[i] * b[i];
+  }
+  *aa = sa;
+  *bb = sb;
+  *ab = sab;
+}
+
+__attribute__((target("sse2"))) void normDotSse2(const float *a,
+                                                 const float *b, size_t n,
+                                                 double *aa, double *bb,
+                                                 double *ab) {
+  __m128d accA = _mm_setzero_pd(), accB = _mm_setzero_pd(),
+          accAB = _mm_setzero_pd();
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    __m128d x = _mm_cvtps_pd(
+        _mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(
+            a + i))));
+    __m128d y = _mm_cvtps_pd(
+        _mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(
+            b + i))));
+    accA = _mm_add_pd(accA, _mm_mul_pd(x, x));
+    accB = _mm_add_pd(accB, _mm_mul_pd(y, y));
+    accAB = _mm_add_pd(accAB, _mm_mul_pd(x, y));
+  }
+  double tA[2], tB[2], tAB[2];
+  _mm_storeu_pd(tA, accA);
+  _mm_storeu_pd(tB, accB);
+  _mm_storeu_pd(tAB, accAB);
+  double sa = tA[0] + tA[1], sb = tB[0] + tB[1], sab = tAB[0] + tAB[1];
+  for (; i < n; ++i) {
+    sa += double(a[i]) * a[i];
+    sb += double(b[i]) * b[i];
+    sab += double(a[i]) * b[i];
+  }
+  *aa = sa;
+  *bb = sb;
+  *ab = sab;
+}
+
+__attribute__((target("sse2"))) int64_t dotSse2(const int8_t *a,
+                                                const int8_t *b, size_t n) {
+  int64_t sum = 0;
+  size_t i = 0;
+  while (i + 16 <= n) {
+    __m128i acc = _mm_setzero_si128();
+    for (size_t it = 0; it < kInt8FlushIterations && i + 16 <= n;
+         ++it, i += 16) {
+      __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+      __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+      // sign extension to int16, SSE2 has no cvtepi8
+      __m128i xLo = _mm_srai_epi16(_mm_unpacklo_epi8(x, x), 8);
+      __m128i xHi = _mm_srai_epi16(_mm_unpackhi_epi8(x, x), 8);
+      __m128i yLo = _mm_srai_epi16(_mm_unpacklo_epi8(y, y), 8);
+      __m128i yHi = _mm_srai_epi16(_mm_unpackhi_epi8(y, y), 8);
+      acc = _mm_add_epi32(acc, _mm_madd_epi16(xLo, yLo));
+      acc = _mm_add_epi32(acc, _mm_madd_epi16(xHi, yHi));
+    }
+    int32_t tmp[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(tmp), acc);
+    sum += int64_t(tmp[0]) + tmp[1] + tmp[2] + tmp[3];
+  }
+  for (; i < n; ++i) {
+    sum += int32_t(a[i]) * b[i];
+  }
+  return sum;
+}
+
+const DotKernels kSse2Kernels = {dotSse2, dotSse2, dotSse2, normDotSse2,
+                                 normDotSse2};
+
+// -------------------------------------------------------------- AVX2+FMA
+
+__attribute__((target("avx2,fma"))) double dotAvx2(const double *a,
+                                                   const double *b, size_t n) {
+  __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i),
+                           acc0);
+    acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4),
+                           _mm256_loadu_pd(b + i + 4), acc1);
+  }
+  double tmp[4];
+  _mm256_storeu_pd(tmp, _mm256_add_pd(acc0, acc1));
+  double sum = (tmp[0] + tmp[1]) + (tmp[2] + tmp[3]);
+  for (; i < n; ++i) {
+    sum += a[i] * b[i];
+  }
+  return sum;
+}
+
+__attribute__((target("avx2,fma"))) double dotAvx2(const float *a,
+                                                   const float *b, size_t n) {
+  __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    acc0 = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm_loadu_ps(a + i)),
+                           _mm256_cvtps_pd(_mm_loadu_ps(b + i)), acc0);
+    acc1 = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm_loadu_ps(a + i + 4)),
+                           _mm256_cvtps_pd(_mm_loadu_ps(b + i + 4)), acc1);
+  }
+  double tmp[4];
+  _mm256_storeu_pd(tmp, _mm256_add_pd(acc0, acc1));
+  double sum = (tmp[0] + tmp[1]) + (tmp[2] + tmp[3]);
+  for (; i < n; ++i) {
+    sum += double(a[i]) * b[i];
+  }
+  return sum;
+}
+
+__attribute__((target("avx2,fma"))) void normDotAvx2(const double *a,
+                                                     const double *b, size_t n,
+                                                     double *aa, double *bb,
+                                                     double *ab) {
+  __m256d accA = _mm256_setzero_pd(), accB = _mm256_setzero_pd(),
+          accAB = _mm256_setzero_pd();
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256d x = _mm256_loadu_pd(a + i);
+    __m256d y = _mm256_loadu_pd(b + i);
+    accA = _mm256_fmadd_pd(x, x, accA);
+    accB = _mm256_fmadd_pd(y, y, accB);
+    accAB = _mm256_fmadd_pd(x, y, accAB);
+  }
+  double tA[4], tB[4], tAB[4];
+  _mm256_storeu_pd(tA, accA);
+  _mm256_storeu_pd(tB, accB);
+  _mm256_storeu_pd(tAB, accAB);
+  double sa = (tA[0] + tA[1]) + (tA[2] + tA[3]);
+  double sb = (tB[0] + tB[1]) + (tB[2] + tB[3]);
+  double sab = (tAB[0] + tAB[1]) + (tAB[2] + tAB[3]);
+  for (; i < n; ++i) {
+    sa += a[i] * a[i];
+    sb += b[i] * b[i];
+    sab += a[i] * b[i];
+  }
+  *aa = sa;
+  *bb = sb;
+  *ab = sab;
+}
+
+__attribute__((target("avx2,fma"))) void normDotAvx2(const float *a,
+                                                     const float *b, size_t n,
+                                                     double *aa, double *bb,
+                                                     double *ab) {
+  __m256d accA = _mm256_setzero_pd(), accB = _mm256_setzero_pd(),
+          accAB = _mm256_setzero_pd();
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256d x = _mm256_cvtps_pd(_mm_loadu_ps(a + i));
+    __m256d y = _mm256_cvtps_pd(_mm_loadu_ps(b + i));
+    accA = _mm256_fmadd_pd(x, x, accA);
+    accB = _mm256_fmadd_pd(y, y, accB);
+    accAB = _mm256_fmadd_pd(x, y, accAB);
+  }
+  double tA[4], tB[4], tAB[4];
+  _mm256_storeu_pd(tA, accA);
+  _mm256_storeu_pd(tB, accB);
+  _mm256_storeu_pd(tAB, accAB);
+  double sa = (tA[0] + tA[1]) + (tA[2] + tA[3]);
+  double sb = (tB[0] + tB[1]) + (tB[2] + tB[3]);
+  double sab = (tAB[0] + tAB[1]) + (tAB[2] + tAB[3]);
+  for (; i < n; ++i) {
+    sa += double(a[i]) * a[i];
+    sb += double(b[i]) * b[i];
+    sab += double(a[i]) * b[i];
+  }
+  *aa = sa;
+  *bb = sb;
+  *ab = sab;
+}
+
+__attribute__((target("avx2,fma"))) int64_t dotAvx2(const int8_t *a,
+                                                    const int8_t *b, size_t n) {
+  int64_t sum = 0;
+  size_t i = 0;
+  while (i + 16 <= n) {
+    __m256i acc = _mm256_setzero_si256();
+    for (size_t it = 0; it < kInt8FlushIterations && i + 16 <= n;
+         ++it, i += 16) {
+      __m256i x = _mm256_cvtepi8_epi16(
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i)));
+      __m256i y = _mm256_cvtepi8_epi16(
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i)));
+      acc = _mm256_add_epi32(acc, _mm256_madd_epi16(x, y));
+    }
+    int32_t tmp[8];
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(tmp), acc);
+    for (int k = 0; k < 8; ++k) {
+      sum += tmp[k];
+    }
+  }
+  for (; i < n; ++i) {
+    sum += int32_t(a[i]) * b[i];
+  }
+  return sum;
+}
+
+const DotKernels kAvx2Kernels = {dotAvx2, dotAvx2, dotAvx2, normDotAvx2,
+                                 normDotAvx2};
+
+// --------------------------------------------------------------- AVX-512
+
+// _mm512_reduce_add_pd triggers -Wuninitialized in some gcc versions
+__attribute__((target("avx512f"))) double sumAvx512(__m512d v) {
+  double tmp[8];
+  _mm512_storeu_pd(tmp, v);
+  return ((tmp[0] + tmp[1]) + (tmp[2] + tmp[3])) +
+         ((tmp[4] + tmp[5]) + (tmp[6] + tmp[7]));
+}
+
+// _mm512_cvtps_pd triggers the same warning, the zero mask variant does not
+__attribute__((target("avx512f"))) __m512d loadAvx512(const float *p) {
+  return _mm512_maskz_cvtps_pd(0xFF, _mm256_loadu_ps(p));
+}
+
+__attribute__((target("avx512f"))) double dotAvx512(const double *a,
+                                                    const double *b,
+                                                    size_t n) {
+  __m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd();
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i),
+                           acc0);
+    acc1 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 8),
+                           _mm512_loadu_pd(b + i + 8), acc1);
+  }
+  double sum = sumAvx512(_mm512_add_pd(acc0, acc1));
+  for (; i < n; ++i) {
+    sum += a[i] * b[i];
+  }
+  return sum;
+}
+
+__attribute__((target("avx512f"))) double dotAvx512(const float *a,
+                                                    const float *b, size_t n) {
+  __m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd();
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    acc0 = _mm512_fmadd_pd(loadAvx512(a + i), loadAvx512(b + i), acc0);
+    acc1 = _mm512_fmadd_pd(loadAvx512(a + i + 8), loadAvx512(b + i + 8), acc1);
+  }
+  double sum = sumAvx512(_mm512_add_pd(acc0, acc1));
+  for (; i < n; ++i) {
+    sum += double(a[i]) * b[i];
+  }
+  return sum;
+}
+
+__attribute__((target("avx512f"))) void normDotAvx512(const double *a,
+                                                      const double *b,
+                                                      size_t n, double *aa,
+                                                      double *bb, double *ab) {
+  __m512d accA = _mm512_setzero_pd(), accB = _mm512_setzero_pd(),
+          accAB = _mm512_setzero_pd();
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m512d x = _mm512_loadu_pd(a + i);
+    __m512d y = _mm512_loadu_pd(b + i);
+    accA = _mm512_fmadd_pd(x, x, accA);
+    accB = _mm512_fmadd_pd(y, y, accB);
+    accAB = _mm512_fmadd_pd(x, y, accAB);
+  }
+  double sa = sumAvx512(accA);
+  double sb = sumAvx512(accB);
+  double sab = sumAvx512(accAB);
+  for (; i < n; ++i) {
+    sa += a[i] * a[i];
+    sb += b[i] * b[i];
+    sab += a[i] * b[i];
+  }
+  *aa = sa;
+  *bb = sb;
+  *ab = sab;
+}
+
+__attribute__((target("avx512f"))) void normDotAvx512(const float *a,
+                                                      const float *b, size_t n,
+                                                      double *aa, double *bb,
+                                                      double *ab) {
+  __m512d accA = _mm512_setzero_pd(), accB = _mm512_setzero_pd(),
+          accAB = _mm512_setzero_pd();
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m512d x = loadAvx512(a + i);
+    __m512d y = loadAvx512(b + i);
+    accA = _mm512_fmadd_pd(x, x, accA);
+    accB = _mm512_fmadd_pd(y, y, accB);
+    accAB = _mm512_fmadd_pd(x, y, accAB);
+  }
+  double sa = sumAvx512(accA);
+  double sb = sumAvx512(accB);
+  double sab = sumAvx512(accAB);
+  for (; i < n; ++i) {
+    sa += double(a[i]) * a[i];
+    sb += double(b[i]) * b[i];
+    sab += double(a[i]) * b[i];
+  }
+  *aa = sa;
+  *bb = sb;
+  *ab = sab;
+}
+
+// the int8 kernel would need AVX-512BW, the AVX2 one is used instead
+const DotKernels kAvx512Kernels = {dotAvx512, dotAvx512, dotAvx2,
+                                   normDotAvx512, normDotAvx512};
+
+#endif  // VPR_DOT_KERNELS_X86
+
+const DotKernels *kernelsFor(DotKernelType type) {
+#ifdef VPR_DOT_KERNELS_X86
+  switch (type) {
+    case DOT_SSE2:
+      return &kSse2Kernels;
+    case DOT_AVX2:
+      return &kAvx2Kernels;
+    case DOT_AVX512:
+      return &kAvx512Kernels;
+    default:
+      break;
+  }
+#endif
+  return &kScalarKernels;
+}
+
+DotKernelType bestDotKernel() {
+  const DotKernelType order[] = {DOT_AVX512, DOT_AVX2, DOT_SSE2};
+  for (DotKernelType type : order) {
+    if (dotKernelSupported(type)) {
+      return type;
+    }
+  }
+  return DOT_SCALAR;
+}
+
+DotKernelType &activeType() {
+  static DotKernelType type = bestDotKernel();
+  return type;
+}
+
+const DotKernels *&active() {
+  static const DotKernels *kernels = kernelsFor(activeType());
+  return kernels;
+}
+
+template <typename T>
+double cosine(const T *a, const T *b, size_t n) {
+  double aa, bb, ab;
+  normDotProduct(a, b, n, &aa, &bb, &ab);
+  return ab / sqrt(aa * bb);
+}
+
+}  // namespace
+
+double dotProduct(const double *a, const double *b, size_t n) {
+  return active()->dot64(a, b, n);
+}
+
+double dotProduct(const float *a, const float *b, size_t n) {
+  return active()->dot32(a, b, n);
+}
+
+int64_t dotProduct(const int8_t *a, const int8_t *b, size_t n) {
+  return active()->dot8(a, b, n);
+}
+
+void normDotProduct(const double *a, const double *b, size_t n, double *aa,
+                    double *bb, double *ab) {
+  active()->normDot64(a, b, n, aa, bb, ab);
+}
+
+void normDotProduct(const float *a, const float *b, size_t n, double *aa,
+                    double *bb, double *ab) {
+  active()->normDot32(a, b, n, aa, bb, ab);
+}
+
+double cosineSimilarity(const double *a, const double *b, size_t n) {
+  return cosine(a, b, n);
+}
+
+double cosineSimilarity(const float *a, const float *b, size_t n) {
+  return cosine(a, b, n);
+}
+
+bool dotKernelSupported(DotKernelType type) {
+  switch (type) {
+    case DOT_SCALAR:
+      return true;
+#ifdef VPR_DOT_KERNELS_X86
+    case DOT_SSE2:
+      return __builtin_cpu_supports("sse2");
+    case DOT_AVX2:
+      return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    case DOT_AVX512:
+      return __builtin_cpu_supports("avx512f");
+#endif
+    default:
+      return false;
+  }
+}
+
+DotKernelType activeDotKernel() { return activeType(); }
+
+const char *dotKernelName(DotKernelType type) {
+  switch (type) {
+    case DOT_SSE2:
+      return "sse2";
+    case DOT_AVX2:
+      return "avx2";
+    case DOT_AVX512:
+      return "avx512";
+    default:
+      return "scalar";
+  }
+}
+
+bool setDotKernel(DotKernelType type) {
+  if (!dotKernelSupported(type)) {
+    printf("[WARNING][DotKernels] Kernel %s is not supported by this cpu\n",
+           dotKernelName(type));
+    return false;
+  }
+  activeType() = type;
+  active() = kernelsFor(type);
+  return true;
+}
@@ -0,0 +1,78 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#ifndef SRC_FEATURES_DOT_KERNELS_H_
+#define SRC_FEATURES_DOT_KERNELS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Dot product kernels used for computing the similarity scores. On x86 the
+ * best kernel supported by the cpu (SSE2, AVX2+FMA or AVX-512) is picked at
+ * runtime, otherwise a portable scalar version is used. All the kernels
+ * accumulate in double, also for float inputs, whose products are exact in
+ * double. The vector kernels sum in a different order than the scalar one, so
+ * results may differ by the rounding of the double sums, about
+ * n * DBL_EPSILON relative to the sum of the absolute products.
+ */
+enum DotKernelType { DOT_SCALAR, DOT_SSE2, DOT_AVX2, DOT_AVX512 };
+
+/** dot product of two vectors of size n **/
+double dotProduct(const double *a, const double *b, size_t n);
+double dotProduct(const float *a, const float *b, size_t n);
+/** exact integer dot product, used for int8 quantized features **/
+int64_t dotProduct(const int8_t *a, const int8_t *b, size_t n);
+
+/**
+ * @brief      computes the squared norms and the dot product of two vectors in
+ * one pass.
+ *
+ * @param[in]  a     The first vector
+ * @param[in]  b     The second vector
+ * @param[in]  n     The size of the vectors
+ * @param[out] aa    squared norm of a
+ * @param[out] bb    squared norm of b
+ * @param[out] ab    dot product of a and b
+ */
+void normDotProduct(const double *a, const double *b, size_t n, double *aa,
+                    double *bb, double *ab);
+void normDotProduct(const float *a, const float *b, size_t n, double *aa,
+                    double *bb, double *ab);
+
+/** cosine similarity computed with normDotProduct **/
+double cosineSimilarity(const double *a, const double *b, size_t n);
+double cosineSimilarity(const float *a, const float *b, size_t n);
+
+bool dotKernelSupported(DotKernelType type);
+DotKernelType activeDotKernel();
+const char *dotKernelName(DotKernelType type);
+/**
+ * @brief      Overrides the automatically selected kernel. Not thread safe,
+ * meant for testing and benchmarking.
+ *
+ * @return     false if the kernel is not supported by the cpu
+ */
+bool setDotKernel(DotKernelType type);
+
+#endif  // SRC_FEATURES_DOT_KERNELS_H_
@@ -0,0 +1,207 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include "features/feature_archive.h"
+#include <math.h>
+#include <string.h>
+#include <limits>
+#include "features/feature_file.h"
+
+namespace {
+bool isDenseType(uint32_t type) {
+  return type == FeatureFactory::Cnn_Feature ||
+         type == FeatureFactory::Vgg_Feature ||
+         type == FeatureFactory::Cnn_Feature_Mean ||
+         type == FeatureFactory::Vgg_Feature_Mean;
+}
+
+/** true if `count` elements at the 8 byte aligned `offset` fit in the file.
+ * Divides instead of multiplying, so corrupted values cannot overflow **/
+bool fitsInFile(uint64_t offset, uint64_t count, uint64_t elSize,
+                uint64_t fileSize) {
+  return offset % sizeof(uint64_t) == 0 && offset <= fileSize &&
+         count <= (fileSize - offset) / elSize;
+}
+}  // namespace
+
+static_assert(sizeof(FeatureArchiveHeader) == 64,
+              "FeatureArchiveHeader should be 64 bytes");
+static_assert(sizeof(FeatureArchiveEntry) == 32,
+              "FeatureArchiveEntry should be 32 bytes");
+
+bool FeatureArchive::isArchive(const std::string &filename) {
+  std::ifstream in(filename.c_str(), std::ios::binary);
+  char magic[sizeof(kFeatureArchiveMagic)];
+  if (!in || !in.read(magic, sizeof(magic))) {
+    return false;
+  }
+  return memcmp(magic, kFeatureArchiveMagic, sizeof(magic)) == 0;
+}
+
+bool FeatureArchive::open(const std::string &filename) {
+  if (!_file.open(filename) || _file.size() < sizeof(_header)) {
+    printf("[ERROR][FeatureArchive] Archive %s cannot be opened\n",
+           filename.c_str());
+    return false;
+  }
+  memcpy(&_header, _file.data(), sizeof(_header));
+  if (memcmp(_header.magic, kFeatureArchiveMagic, sizeof(_header.magic)) != 0 ||
+      _header.version != kFeatureArchiveVersion) {
+    printf("[ERROR][FeatureArchive] %s is not a feature archive\n",
+           filename.c_str());
+    return false;
+  }
+  if (!isDenseType(_header.featureType)) {
+    printf("[ERROR][FeatureArchive] Archive %s has unknown feature type %u\n",
+           filename.c_str(), _header.featureType);
+    return false;
+  }
+  // the features are addressed by int ids
+  if (_header.count > uint64_t(std::numeric_limits<int>::max()) ||
+      !fitsInFile(_header.indexOffset, _header.count,
+                  sizeof(FeatureArchiveEntry), _file.size())) {
+    printf("[ERROR][FeatureArchive] Archive %s is corrupted\n",
+           filename.c_str());
+    return false;
+  }
+  _entries = reinterpret_cast<const FeatureArchiveEntry *>(
+      _file.data() + _header.indexOffset);
+  for (uint64_t i = 0; i < _header.count; ++i) {
+    const FeatureArchiveEntry &entry = _entries[i];
+    bool valid = fitsInFile(entry.offset, entry.size, sizeof(double),
+                            _file.size());
+    if (valid && entry.bitsOffset != 0) {
+      uint64_t words = (entry.size + 63) / 64;
+      valid = fitsInFile(entry.bitsOffset, words, sizeof(uint64_t),
+                         _file.size());
+    }
+    if (!valid) {
+      printf("[ERROR][FeatureArchive] Feature %lu in %s is corrupted\n", i,
+             filename.c_str());
+      return false;
+    }
+  }
+  _filename = filename;
+  printf("[INFO][FeatureArchive] Archive %s with %lu features was mapped\n",
+         filename.c_str(), _header.count);
+  return true;
+}
+
+const double *FeatureArchive::values(int id) const {
+  return reinterpret_cast<const double *>(_file.data() + _entries[id].offset);
+}
+
+const uint64_t *FeatureArchive::bitWords(int id) const {
+  if (_entries[id].bitsOffset == 0) {
+    return nullptr;
+  }
+  return reinterpret_cast<const uint64_t *>(_file.data() +
+                                            _entries[id].bitsOffset);
+}
+
+bool FeatureArchiveWriter::open(const std::string &filename, int count,
+                                FeatureFactory::FeatureType type) {
+  if (!isDenseType(type)) {
+    printf("[ERROR][FeatureArchive] Only dense features can be archived\n");
+    return false;
+  }
+  _type = type;
+  _out.open(filename.c_str(), std::ios::binary);
+  if (!_out) {
+    printf("[ERROR][FeatureArchive] Cannot open %s for writing\n",
+           filename.c_str());
+    return false;
+  }
+  _count = count;
+  _entries.clear();
+  _entries.reserve(count);
+  // the index is written on close, reserve the space for it now
+  std::vector<char> placeholder(
+      sizeof(FeatureArchiveHeader) + count * sizeof(FeatureArchiveEntry), 0);
+  _out.write(placeholder.data(), placeholder.size());
+  return _out.good();
+}
+
+void FeatureArchiveWriter::pad() {
+  uint64_t pos = _out.tellp();
+  uint64_t aligned = (pos + kFeatureArchiveAlignment - 1) /
+                     kFeatureArchiveAlignment * kFeatureArchiveAlignment;
+  for (; pos < aligned; ++pos) {
+    _out.put(0);
+  }
+}
+
+bool FeatureArchiveWriter::add(const std::vector<double> &values,
+                               const BitCode *bits) {
+  if (static_cast<int>(_entries.size()) >= _count) {
+    printf("[ERROR][FeatureArchive] Archive is full. Feature not added\n");
+    return false;
+  }
+  if (bits && bits->size() != values.size()) {
+    printf("[ERROR][FeatureArchive] Bits do not match the feature size\n");
+    return false;
+  }
+  FeatureArchiveEntry entry;
+  memset(&entry, 0, sizeof(entry));
+  pad();
+  entry.offset = _out.tellp();
+  entry.size = values.size();
+  double sqSum = 0.0;
+  for (double v : values) {
+    sqSum += v * v;
+  }
+  entry.norm = sqrt(sqSum);
+  _out.write(reinterpret_cast<const char *>(values.data()),
+             values.size() * sizeof(double));
+
+  if (bits) {
+    pad();
+    entry.bitsOffset = _out.tellp();
+    _out.write(reinterpret_cast<const char *>(bits->words()),
+               bits->numWords() * sizeof(uint64_t));
+  }
+  _entries.push_back(entry);
+  return _out.good();
+}
+
+bool FeatureArchiveWriter::close() {
+  if (static_cast<int>(_entries.size()) != _count) {
+    printf("[ERROR][FeatureArchive] Expected %d features, got %lu\n", _count,
+           _entries.size());
+    return false;
+  }
+  FeatureArchiveHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kFeatureArchiveMagic, sizeof(kFeatureArchiveMagic));
+  header.version = kFeatureArchiveVersion;
+  header.dtype = FLOAT64;
+  header.count = _count;
+  header.indexOffset = sizeof(header);
+  header.featureType = _type;
+  _out.seekp(0);
+  _out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  _out.write(reinterpret_cast<const char *>(_entries.data()),
+             _entries.size() * sizeof(FeatureArchiveEntry));
+  _out.close();
+  return !_out.fail();
+}
@@ -0,0 +1,139 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#ifndef SRC_FEATURES_FEATURE_ARCHIVE_H_
+#define SRC_FEATURES_FEATURE_ARCHIVE_H_
+
+#include <stdint.h>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "features/bit_code.h"
+#include "features/feature_factory.h"
+#include "tools/mapped_file/mapped_file.h"
+
+/**
+ * Archive layout: FeatureArchiveHeader, followed by `count` index entries and
+ * the feature payloads. Every payload (values and packed bits) starts at a 64
+ * byte aligned offset, so features can be used in place from the mapping.
+ */
+struct FeatureArchiveHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t dtype;
+  uint64_t count;
+  uint64_t indexOffset;
+  // FeatureFactory::FeatureType the values were loaded with
+  uint32_t featureType;
+  uint32_t reserved0;
+  uint64_t reserved[3];
+};
+
+struct FeatureArchiveEntry {
+  // byte offset of the float64 values
+  uint64_t offset;
+  // number of values
+  uint64_t size;
+  // byte offset of the bits packed into uint64_t words. 0 if not stored
+  uint64_t bitsOffset;
+  // L2 norm of the values
+  double norm;
+};
+
+const char kFeatureArchiveMagic[8] = {'V', 'P', 'R', 'A', 'R', 'C', 'H', '\0'};
+const uint32_t kFeatureArchiveVersion = 1;
+const uint64_t kFeatureArchiveAlignment = 64;
+
+/**
+ * @brief      Read-only access to a packed feature archive. The archive is
+ * memory mapped, accessing a feature does not copy any data.
+ */
+class FeatureArchive {
+ public:
+  using Ptr = std::shared_ptr<FeatureArchive>;
+  using ConstPtr = std::shared_ptr<const FeatureArchive>;
+
+  /** checks if the file starts with the archive header **/
+  static bool isArchive(const std::string &filename);
+
+  bool open(const std::string &filename);
+  int size() const { return static_cast<int>(_header.count); }
+  const std::string &filename() const { return _filename; }
+  /** defines how the archived features are matched **/
+  FeatureFactory::FeatureType featureType() const {
+    return static_cast<FeatureFactory::FeatureType>(_header.featureType);
+  }
+
+  const FeatureArchiveEntry &entry(int id) const { return _entries[id]; }
+  const double *values(int id) const;
+  /** returns nullptr if the bits were not stored **/
+  const uint64_t *bitWords(int id) const;
+
+ private:
+  MappedFile _file;
+  std::string _filename;
+  FeatureArchiveHeader _header;
+  const FeatureArchiveEntry *_entries = nullptr;
+};
+
+/**
+ * @brief      Writes features one after another into an archive.
+ */
+class FeatureArchiveWriter {
+ public:
+  /**
+   * @brief      Starts a new archive.
+   *
+   * @param[in]  filename  The filename
+   * @param[in]  count     The number of features that will be added
+   * @param[in]  type      The type the features were loaded with. Only dense
+   * features can be archived.
+   *
+   * @return     false if the archive cannot be written.
+   */
+  bool open(const std::string &filename, int count,
+            FeatureFactory::FeatureType type = FeatureFactory::Cnn_Feature);
+  /**
+   * @brief      Appends a feature to the archive.
+   *
+   * @param[in]  values  The values
+   * @param[in]  bits    (optional) binarized feature
+   *
+   * @return     false if the feature cannot be written.
+   */
+  bool add(const std::vector<double> &values,
+           const BitCode *bits = nullptr);
+  /** writes the index table. Should be called after all features are added **/
+  bool close();
+
+ private:
+  void pad();
+
+  std::ofstream _out;
+  std::vector<FeatureArchiveEntry> _entries;
+  int _count = 0;
+  FeatureFactory::FeatureType _type = FeatureFactory::Cnn_Feature;
+};
+
+#endif  // SRC_FEATURES_FEATURE_ARCHIVE_H_
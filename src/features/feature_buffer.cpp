@@ -24,49 +24,127 @@
 
 #include "feature_buffer.h"
 
-#include <limits>
+#include <stdio.h>
+#include <iterator>
 
 bool FeatureBuffer::inBuffer(int id) const {
-  auto feature = featureMap.find(id);
-  if (feature == featureMap.end()) {
+  auto feature = _entries.find(id);
+  if (feature == _entries.end()) {
     // not found
     return false;
   }
   return true;
 }
 
-iFeature::ConstPtr FeatureBuffer::getFeature(int id) const {
-  auto found = featureMap.find(id);
-  return found->second;
+iFeature::ConstPtr FeatureBuffer::getFeature(int id) {
+  auto found = _entries.find(id);
+  if (found == _entries.end()) {
+    _stats.misses++;
+    return nullptr;
+  }
+  _stats.hits++;
+  Entry &entry = found->second;
+  if (!entry.pinned) {
+    // move to the front, O(1)
+    _lru.splice(_lru.begin(), _lru, entry.position);
+  }
+  return entry.feature;
+}
+
+bool FeatureBuffer::isFull() const {
+  if (_bufferSize >= 0 && static_cast<int>(_entries.size()) > _bufferSize) {
+    return true;
+  }
+  return _memoryBudget > 0 && _memoryUsed > _memoryBudget;
 }
 
-/** internal function. deletes the latest added feature from the buffer **/
-void FeatureBuffer::deleteFeature() {
-  featureMap.erase(ids[0]);
-  ids.erase(ids.begin());
+/** internal function. deletes the least recently used features **/
+void FeatureBuffer::evict() {
+  // pinned features stay even if the buffer is over the limits
+  while (isFull() && !_lru.empty()) {
+    int id = _lru.back();
+    _lru.pop_back();
+    auto found = _entries.find(id);
+    _memoryUsed -= found->second.bytes;
+    _entries.erase(found);
+    _stats.evictions++;
+  }
 }
 
-void FeatureBuffer::addFeature(int id, const iFeature::ConstPtr& feature) {
-  if (ids.size() > static_cast<size_t>(std::numeric_limits<int>::max())) {
-    fprintf(stderr,
-            "[ERROR] ids vector size does not fit in integer type. Cannot add "
-            "feature with id: %d.\n",
-            id);
+void FeatureBuffer::addFeature(int id, const iFeature::ConstPtr &feature) {
+  auto found = _entries.find(id);
+  if (found != _entries.end()) {
+    fprintf(stderr, "[WARNING] feature with id %d exists. Overwriting.\n", id);
+    Entry &entry = found->second;
+    _memoryUsed -= entry.bytes;
+    entry.feature = feature;
+    entry.bytes = feature->memorySize();
+    _memoryUsed += entry.bytes;
+    if (!entry.pinned) {
+      _lru.splice(_lru.begin(), _lru, entry.position);
+    }
+    evict();
     return;
   }
-  if (static_cast<int>(ids.size()) == bufferSize) {
-    deleteFeature();
+  Entry &entry = _entries[id];
+  entry.feature = feature;
+  entry.bytes = feature->memorySize();
+  _memoryUsed += entry.bytes;
+  if (_pinned.count(id) > 0) {
+    entry.pinned = true;
+  } else {
+    _lru.push_front(id);
+    entry.position = _lru.begin();
   }
-  ids.push_back(id);
-  if (featureMap.count(id) > 0) {
-    fprintf(stderr, "[WARNING] feature with id %d exists. Overwriting.\n", id);
+  evict();
+}
+
+void FeatureBuffer::pin(int id, Entry *entry) {
+  if (entry->pinned) {
+    return;
   }
-  // Map stores const pointers, so we cannot use operator[] here.
-  featureMap.emplace(id, feature);
+  _lru.erase(entry->position);
+  entry->pinned = true;
+}
+
+void FeatureBuffer::unpin(int id, Entry *entry) {
+  if (!entry->pinned) {
+    return;
+  }
+  entry->pinned = false;
+  // the search has moved away from it, evict it first
+  _lru.push_back(id);
+  entry->position = std::prev(_lru.end());
+}
+
+void FeatureBuffer::setPinned(const std::vector<int> &ids) {
+  std::unordered_set<int> pinned(ids.begin(), ids.end());
+  for (int id : _pinned) {
+    auto found = _entries.find(id);
+    if (found != _entries.end() && pinned.count(id) == 0) {
+      unpin(id, &found->second);
+    }
+  }
+  for (int id : pinned) {
+    auto found = _entries.find(id);
+    if (found != _entries.end()) {
+      pin(id, &found->second);
+    }
+  }
+  _pinned.swap(pinned);
+  evict();
 }
 
 /**  sets buffer size + reserves the space for map **/
 void FeatureBuffer::setBufferSize(int size) {
-  bufferSize = size;
-  featureMap.reserve(size);
+  _bufferSize = size;
+  if (size > 0) {
+    _entries.reserve(size);
+  }
+  evict();
+}
+
+void FeatureBuffer::setMemoryBudget(size_t bytes) {
+  _memoryBudget = bytes;
+  evict();
 }
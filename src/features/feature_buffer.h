@@ -25,30 +25,76 @@
 #ifndef SRC_FEATURES_FEATURE_BUFFER_H_
 #define SRC_FEATURES_FEATURE_BUFFER_H_
 
+#include <stddef.h>
+#include <list>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include "ifeature.h"
 
 /**
  * @brief      Class for feature buffer. Stores the features kept in memory
- * during the search
+ * during the search. When the buffer is full, the least recently used
+ * feature is evicted. The buffer can be limited by the number of features
+ * and by their memory size. Pinned features are never evicted.
  */
 class FeatureBuffer {
  public:
+  struct Stats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+  };
+
   bool inBuffer(int id) const;
-  /**  sets buffer size + reserves the space for map **/
+  /**  sets maximal number of features + reserves the space for map. -1 for
+   * no limit **/
   void setBufferSize(int size);
-  /** returns empty vector if a feature is not in buffer */
-  iFeature::ConstPtr getFeature(int id) const;
-  void addFeature(int id, const iFeature::ConstPtr& feature);
+  /** sets maximal memory of the features in bytes. 0 for no limit **/
+  void setMemoryBudget(size_t bytes);
+  /**
+   * @brief      returns nullptr if a feature is not in buffer. Marks the
+   * feature as recently used.
+   */
+  iFeature::ConstPtr getFeature(int id);
+  void addFeature(int id, const iFeature::ConstPtr &feature);
+
+  /**
+   * @brief      The features with these ids are not evicted, also the ones
+   * that are added later. Replaces the previously pinned ids.
+   */
+  void setPinned(const std::vector<int> &ids);
+
+  int size() const { return _entries.size(); }
+  int bufferSize() const { return _bufferSize; }
+  /** memory used by the buffered features in bytes **/
+  size_t memoryUsed() const { return _memoryUsed; }
+  const Stats &stats() const { return _stats; }
+
+ private:
+  struct Entry {
+    iFeature::ConstPtr feature;
+    size_t bytes = 0;
+    // position in _lru, only valid if not pinned
+    std::list<int>::iterator position;
+    bool pinned = false;
+  };
 
-  void deleteFeature();
+  bool isFull() const;
+  /** evicts the least recently used features until the buffer is not full **/
+  void evict();
+  void pin(int id, Entry *entry);
+  void unpin(int id, Entry *entry);
 
-  // this is needed to remember which feature came first.
-  int bufferSize = -1;
-  std::vector<int> ids;
-  std::unordered_map<int, const iFeature::ConstPtr> featureMap;
+  int _bufferSize = -1;
+  size_t _memoryBudget = 0;
+  size_t _memoryUsed = 0;
+  std::unordered_map<int, Entry> _entries;
+  // most recently used ids in front, pinned features are not in the list
+  std::list<int> _lru;
+  std::unordered_set<int> _pinned;
+  Stats _stats;
 };
 
 #endif  // SRC_FEATURES_FEATURE_BUFFER_H_
@@ -25,6 +25,8 @@
 #include "feature_factory.h"
 #include "cnn_feature.h"
 #include "cnn_feature_mean.h"
+#include "cnn_feature_sparse.h"
+#include "compact_feature.h"
 #include "vgg_feature.h"
 #include "vgg_feature_mean.h"
 
@@ -53,10 +55,25 @@ iFeature::Ptr FeatureFactory::createFeature() const {
       featurePtr = VggFeatureMean::Ptr(new VggFeatureMean);
       break;
     }
+    case Cnn_Feature_Sparse: {
+      featurePtr = CnnFeatureSparse::Ptr(new CnnFeatureSparse);
+      break;
+    }
     default: {
       printf("[ERROR][FeatureFactory] Unknown feature type\n");
       exit(EXIT_FAILURE);
     }
   }
-  return featurePtr;
+  if (_storage == Float64) {
+    return featurePtr;
+  }
+  if (_type == Cnn_Feature_Sparse) {
+    printf(
+        "[WARNING][FeatureFactory] Sparse features are always stored as "
+        "float64\n");
+    return featurePtr;
+  }
+  return CompactFeature::Ptr(new CompactFeature(
+      featurePtr,
+      _storage == Float32 ? CompactFeature::FLOAT32 : CompactFeature::INT8));
 }
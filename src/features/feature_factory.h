@@ -37,14 +37,25 @@ class FeatureFactory {
     Cnn_Feature,
     Vgg_Feature,
     Cnn_Feature_Mean,
-    Vgg_Feature_Mean
+    Vgg_Feature_Mean,
+    Cnn_Feature_Sparse
   };
 
+  /**
+   * How the values of the dense features are kept in memory. Float32 and Int8
+   * features are CompactFeature objects.
+   */
+  enum StorageType { Float64, Float32, Int8 };
+
   iFeature::Ptr createFeature() const;
   void setFeatureType(FeatureType type) { _type = type; }
+  FeatureType featureType() const { return _type; }
+  void setStorageType(StorageType type) { _storage = type; }
+  StorageType storageType() const { return _storage; }
 
  private:
   FeatureType _type = FeatureType::Cnn_Feature;
+  StorageType _storage = StorageType::Float64;
 };
 
 #endif  // SRC_FEATURES_FEATURE_FACTORY_H_
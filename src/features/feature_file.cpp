@@ -0,0 +1,164 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include "features/feature_file.h"
+#include <math.h>
+#include <string.h>
+#include <fstream>
+#include "tools/mapped_file/mapped_file.h"
+
+static_assert(sizeof(FeatureFileHeader) == 64,
+              "FeatureFileHeader should be 64 bytes");
+
+namespace {
+
+size_t dtypeSize(uint32_t dtype) {
+  switch (dtype) {
+    case FLOAT64:
+      return sizeof(double);
+    case FLOAT32:
+      return sizeof(float);
+    default:
+      return 0;
+  }
+}
+
+bool loadBinary(const MappedFile &file, const std::string &filename,
+                std::vector<double> *values, FeatureFileHeader *header) {
+  FeatureFileHeader h;
+  memcpy(&h, file.data(), sizeof(h));
+  if (h.version != kFeatureFileVersion) {
+    printf("[ERROR][FeatureFile] Unsupported version %u of %s\n", h.version,
+           filename.c_str());
+    return false;
+  }
+  size_t elSize = dtypeSize(h.dtype);
+  // h.size comes from the file, h.size * elSize may overflow
+  if (elSize == 0 || h.size > (file.size() - sizeof(h)) / elSize) {
+    printf("[ERROR][FeatureFile] Feature %s is corrupted\n", filename.c_str());
+    return false;
+  }
+  const uint8_t *payload = file.data() + sizeof(h);
+  if (h.dtype == FLOAT64) {
+    const double *begin = reinterpret_cast<const double *>(payload);
+    values->assign(begin, begin + h.size);
+  } else {
+    const float *begin = reinterpret_cast<const float *>(payload);
+    values->assign(begin, begin + h.size);
+  }
+  if (header) {
+    *header = h;
+  }
+  return true;
+}
+
+bool loadText(const std::string &filename, FeatureTextLayout layout,
+              std::vector<double> *values, FeatureFileHeader *header) {
+  std::ifstream in(filename.c_str());
+  if (!in) {
+    return false;
+  }
+  int dims[3] = {1, 1, 0};
+  if (layout == TEXT_WITH_DIMS) {
+    in >> dims[0] >> dims[1] >> dims[2];
+    values->reserve(dims[0] * dims[1] * dims[2]);
+  }
+  double value;
+  while (in >> value) {
+    values->push_back(value);
+  }
+  if (layout == TEXT_VALUES_ONLY) {
+    dims[2] = values->size();
+  }
+  if (header) {
+    *header = makeFeatureHeader(*values, dims, FLOAT64);
+  }
+  return true;
+}
+
+}  // namespace
+
+bool isBinaryFeature(const void *data, size_t size) {
+  return size >= sizeof(FeatureFileHeader) &&
+         memcmp(data, kFeatureFileMagic, sizeof(kFeatureFileMagic)) == 0;
+}
+
+bool loadFeatureValues(const std::string &filename, FeatureTextLayout layout,
+                       std::vector<double> *values,
+                       FeatureFileHeader *header) {
+  values->clear();
+  MappedFile file;
+  if (file.open(filename) && isBinaryFeature(file.data(), file.size())) {
+    return loadBinary(file, filename, values, header);
+  }
+  file.close();
+  return loadText(filename, layout, values, header);
+}
+
+FeatureFileHeader makeFeatureHeader(const std::vector<double> &values,
+                                    const int dims[3], FeatureDType dtype) {
+  FeatureFileHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kFeatureFileMagic, sizeof(kFeatureFileMagic));
+  header.version = kFeatureFileVersion;
+  header.dtype = dtype;
+  for (int i = 0; i < 3; ++i) {
+    header.dims[i] = dims[i];
+  }
+  header.size = values.size();
+  double sqSum = 0.0;
+  for (double v : values) {
+    if (v != 0.0) {
+      header.nnz++;
+      sqSum += v * v;
+    }
+  }
+  header.norm = sqrt(sqSum);
+  return header;
+}
+
+bool saveBinaryFeature(const std::string &filename,
+                       const std::vector<double> &values, const int dims[3],
+                       FeatureDType dtype) {
+  std::ofstream out(filename.c_str(), std::ios::binary);
+  if (!out) {
+    printf("[ERROR][FeatureFile] Cannot open %s for writing\n",
+           filename.c_str());
+    return false;
+  }
+  if (dtype == FLOAT64) {
+    FeatureFileHeader header = makeFeatureHeader(values, dims, dtype);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(values.data()),
+              values.size() * sizeof(double));
+  } else {
+    std::vector<float> converted(values.begin(), values.end());
+    // the norm should match the values that are read back
+    FeatureFileHeader header = makeFeatureHeader(
+        std::vector<double>(converted.begin(), converted.end()), dims, dtype);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(converted.data()),
+              converted.size() * sizeof(float));
+  }
+  return out.good();
+}
@@ -0,0 +1,104 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#ifndef SRC_FEATURES_FEATURE_FILE_H_
+#define SRC_FEATURES_FEATURE_FILE_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * Binary feature format. A file starts with a 64 byte FeatureFileHeader that
+ * is followed by `size` values of type `dtype` in native (little endian) byte
+ * order. The payload starts right after the header, so it is aligned for
+ * direct access through a memory mapping.
+ */
+enum FeatureDType { FLOAT64 = 0, FLOAT32 = 1 };
+
+/** Layout of the text feature files. OverFeat files start with "n r c". **/
+enum FeatureTextLayout { TEXT_WITH_DIMS, TEXT_VALUES_ONLY };
+
+struct FeatureFileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t dtype;
+  // feature map dimensions (n, r, c). Plain vectors are stored as 1 1 size
+  uint32_t dims[3];
+  uint32_t reserved0;
+  uint64_t size;
+  // number of non zero values
+  uint64_t nnz;
+  // L2 norm of the feature vector
+  double norm;
+  uint64_t reserved1;
+};
+
+const char kFeatureFileMagic[8] = {'V', 'P', 'R', 'F', 'E', 'A', 'T', '\0'};
+const uint32_t kFeatureFileVersion = 1;
+
+/**
+ * @brief      Checks if the buffer starts with a valid feature header.
+ *
+ * @param[in]  data  The data
+ * @param[in]  size  The size of the buffer in bytes
+ *
+ * @return     True if binary feature, False otherwise.
+ */
+bool isBinaryFeature(const void *data, size_t size);
+
+/**
+ * @brief      Loads the feature values. Binary files are read through a memory
+ * mapping without parsing, otherwise the file is parsed as text.
+ *
+ * @param[in]  filename  The filename
+ * @param[in]  layout    The layout of the text file, ignored for binary files
+ * @param[out] values    The values
+ * @param[out] header    (optional) filled header. For text files the norm and
+ * nnz are computed from the values.
+ *
+ * @return     false if the file cannot be read.
+ */
+bool loadFeatureValues(const std::string &filename, FeatureTextLayout layout,
+                       std::vector<double> *values,
+                       FeatureFileHeader *header = nullptr);
+
+/**
+ * @brief      Saves the feature values in the binary format.
+ *
+ * @param[in]  filename  The filename
+ * @param[in]  values    The values
+ * @param[in]  dims      The feature map dimensions (n, r, c)
+ * @param[in]  dtype     The type of the stored values
+ *
+ * @return     false if the file cannot be written.
+ */
+bool saveBinaryFeature(const std::string &filename,
+                       const std::vector<double> &values, const int dims[3],
+                       FeatureDType dtype = FLOAT64);
+
+/** Fills the header for the values. **/
+FeatureFileHeader makeFeatureHeader(const std::vector<double> &values,
+                                    const int dims[3], FeatureDType dtype);
+
+#endif  // SRC_FEATURES_FEATURE_FILE_H_
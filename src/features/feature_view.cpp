@@ -0,0 +1,150 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include "features/feature_view.h"
+#include <math.h>
+#include <limits>
+#include "features/cnn_feature.h"
+#include "features/compact_feature.h"
+#include "features/dot_kernels.h"
+#include "features/vgg_feature.h"
+
+namespace {
+/** returns nullptr if the feature is not of type T **/
+template <class T>
+const std::vector<double> *denseValues(const iFeature &feature, double *norm) {
+  const auto dense = dynamic_cast<const T *>(&feature);
+  if (!dense) {
+    return nullptr;
+  }
+  *norm = dense->norm();
+  return &dense->dim;
+}
+
+void differentTypes() {
+  printf(
+      "[ERROR][Feature] It seems like you are trying to match features of "
+      "different type\n");
+  exit(EXIT_FAILURE);
+}
+}  // namespace
+
+FeatureView::FeatureView(const FeatureArchive::ConstPtr &archive, int id,
+                         bool withBits)
+    : _archive(archive), _type(archive->featureType()) {
+  const FeatureArchiveEntry &entry = archive->entry(id);
+  _data = archive->values(id);
+  _size = entry.size;
+  _norm = entry.norm;
+
+  const uint64_t *words = archive->bitWords(id);
+  if (withBits && words) {
+    bits.assignWords(words, _size);
+  }
+}
+
+void FeatureView::loadFromFile(const std::string &filename) {
+  printf(
+      "[ERROR][FeatureView] Views can only be created from a FeatureArchive. "
+      "Cannot load %s\n",
+      filename.c_str());
+  exit(EXIT_FAILURE);
+}
+
+double FeatureView::computeSimilarityScore(
+    const iFeature::ConstPtr &rhs) const {
+  return similarityTo(*rhs);
+}
+
+double FeatureView::similarityTo(const iFeature &rhs) const {
+  if (const auto view = dynamic_cast<const FeatureView *>(&rhs)) {
+    if (view->featureType() != _type) {
+      differentTypes();
+    }
+    return cosine(view->data(), view->size(), view->norm());
+  }
+  if (const auto compact = dynamic_cast<const CompactFeature *>(&rhs)) {
+    if (compact->size() != _size) {
+      printf("[ERROR][FeatureView] Features have different sizes %lu and %lu\n",
+             _size, compact->size());
+      exit(EXIT_FAILURE);
+    }
+    return compact->dot(_data, _size) / (_norm * compact->norm());
+  }
+  const std::vector<double> *dim = nullptr;
+  double rhsNorm = 0.0;
+  switch (_type) {
+    case FeatureFactory::Cnn_Feature:
+    case FeatureFactory::Cnn_Feature_Mean:
+      dim = denseValues<CnnFeature>(rhs, &rhsNorm);
+      break;
+    case FeatureFactory::Vgg_Feature:
+    case FeatureFactory::Vgg_Feature_Mean:
+      dim = denseValues<VggFeature>(rhs, &rhsNorm);
+      break;
+    default:
+      break;
+  }
+  if (!dim) {
+    differentTypes();
+  }
+  return cosine(dim->data(), dim->size(), rhsNorm);
+}
+
+double FeatureView::cosine(const double *rhsData, size_t rhsSize,
+                           double rhsNorm) const {
+  if (rhsSize != _size) {
+    printf("[ERROR][FeatureView] Features have different sizes %lu and %lu\n",
+           _size, rhsSize);
+    exit(EXIT_FAILURE);
+  }
+  double prod = dotProduct(_data, rhsData, _size);
+  return prod / (_norm * rhsNorm);
+}
+
+double FeatureView::score2cost(double score) const {
+  switch (_type) {
+    case FeatureFactory::Cnn_Feature:
+    case FeatureFactory::Cnn_Feature_Mean:
+    case FeatureFactory::Vgg_Feature:
+    case FeatureFactory::Vgg_Feature_Mean:
+      break;
+    default:
+      printf("[ERROR][FeatureView] Unknown feature type %d\n", _type);
+      exit(EXIT_FAILURE);
+  }
+  // the dense features share the inverse of the cosine similarity
+  double cost;
+  if (score < 1e-09) {
+    cost = std::numeric_limits<double>::max();
+    printf("[INFO] The cost of comparing two images is suspiciously small.\n");
+  } else {
+    cost = 1. / score;
+  }
+  return cost;
+}
+
+void FeatureView::disp() const {
+  printf("[INFO][FeatureView] Feature with %lu values, norm %f\n", _size,
+         _norm);
+}
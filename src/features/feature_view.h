@@ -0,0 +1,100 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#ifndef SRC_FEATURES_FEATURE_VIEW_H_
+#define SRC_FEATURES_FEATURE_VIEW_H_
+
+#include <memory>
+#include <string>
+#include "features/feature_archive.h"
+#include "features/feature_factory.h"
+#include "features/ibinarizable_feature.h"
+
+/**
+ * @brief      Non-owning view of a feature stored in a FeatureArchive. The
+ * values are used in place from the mapped archive, which is kept alive as
+ * long as the view exists. The archive records the feature type, which
+ * defines the features a view can be matched against: views of the same type,
+ * CompactFeature and CnnFeature or VggFeature respectively.
+ */
+class FeatureView : public iBinarizableFeature {
+ public:
+  using Ptr = std::shared_ptr<FeatureView>;
+  using ConstPtr = std::shared_ptr<const FeatureView>;
+
+  /**
+   * @brief      Creates a view of the feature `id` from the archive.
+   *
+   * @param[in]  archive   The archive
+   * @param[in]  id        The feature id within the archive
+   * @param[in]  withBits  copies the stored binarized feature into `bits`.
+   * Only needed for relocalization.
+   */
+  FeatureView(const FeatureArchive::ConstPtr &archive, int id,
+              bool withBits = false);
+
+  /** Views are created from an archive. Not supported. **/
+  void loadFromFile(const std::string &filename) override;
+  /**
+   * @brief      computes the cosine distance between two vectors
+   *
+   * @param[in]  rhs   The right hand side
+   *
+   * @return     The similarity score.
+   */
+  double computeSimilarityScore(const iFeature::ConstPtr &rhs) const override;
+  /** computeSimilarityScore() for the features that are matched to views **/
+  double similarityTo(const iFeature &rhs) const;
+  /**
+   * @brief      weight/cost is an inverse of a score.
+   *
+   * @param[in]  score  The score
+   *
+   * @return    weight/cost. If cost is near to 0, returns the
+   * std::numeric_limits<double>::max()
+   */
+  double score2cost(double score) const override;
+  void disp() const override;
+  /** the values are owned by the archive, only the view is counted **/
+  size_t memorySize() const override {
+    return sizeof(*this) + bits.memorySize();
+  }
+
+  const double *data() const { return _data; }
+  size_t size() const { return _size; }
+  double norm() const { return _norm; }
+  FeatureFactory::FeatureType featureType() const { return _type; }
+
+  using iBinarizableFeature::bits;
+
+ private:
+  double cosine(const double *rhsData, size_t rhsSize, double rhsNorm) const;
+
+  FeatureArchive::ConstPtr _archive;
+  FeatureFactory::FeatureType _type = FeatureFactory::Cnn_Feature;
+  const double *_data = nullptr;
+  size_t _size = 0;
+  double _norm = 0.0;
+};
+
+#endif  // SRC_FEATURES_FEATURE_VIEW_H_
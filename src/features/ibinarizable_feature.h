@@ -26,6 +26,7 @@
 #define SRC_FEATURES_IBINARIZABLE_FEATURE_H_
 
 #include <vector>
+#include "features/bit_code.h"
 #include "features/ifeature.h"
 
 /**
@@ -37,7 +38,7 @@ class iBinarizableFeature : public iFeature {
   using ConstPtr = std::shared_ptr<const iBinarizableFeature>;
   virtual ~iBinarizableFeature() {}
 
-  std::vector<bool> bits;
+  BitCode bits;
 };
 
 #endif  // SRC_FEATURES_IBINARIZABLE_FEATURE_H_
@@ -24,6 +24,7 @@
 
 #ifndef SRC_FEATURES_IFEATURE_H_
 #define SRC_FEATURES_IFEATURE_H_
+#include <stddef.h>
 #include <string>
 #include <memory>
 
@@ -55,6 +56,11 @@ class iFeature {
   virtual double score2cost(double score) const = 0;
   virtual void loadFromFile(const std::string &filename) = 0;
   virtual void disp() const = 0;
+  /**
+   * @brief      Approximate memory used by the feature in bytes. Used to
+   * limit the memory of the feature buffers. 0 if unknown.
+   */
+  virtual size_t memorySize() const { return 0; }
   virtual ~iFeature(){}
 };
 
@@ -0,0 +1,350 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include "features/product_quantizer.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <limits>
+#include <random>
+#include "features/dot_kernels.h"
+
+namespace {
+const char kPqStoreMagic[8] = {'V', 'P', 'R', 'P', 'Q', '\0', '\0', '\0'};
+const uint32_t kPqStoreVersion = 1;
+}  // namespace
+
+bool ProductQuantizer::setParams(int numSubspaces, int numCentroids,
+                                 int iterations) {
+  if (numSubspaces < 1 || numCentroids < 1 || numCentroids > 256 ||
+      iterations < 1) {
+    printf(
+        "[ERROR][ProductQuantizer] Invalid parameters: %d subspaces, %d "
+        "centroids, %d iterations\n",
+        numSubspaces, numCentroids, iterations);
+    return false;
+  }
+  _numSubspaces = numSubspaces;
+  _numCentroids = numCentroids;
+  _iterations = iterations;
+  _centroids.clear();
+  _centroidNorms.clear();
+  return true;
+}
+
+const float *ProductQuantizer::centroid(int m, int k) const {
+  int begin = subBegin(m);
+  int sub = subBegin(m + 1) - begin;
+  return _centroids.data() + static_cast<size_t>(_numCentroids) * begin +
+         static_cast<size_t>(k) * sub;
+}
+
+bool ProductQuantizer::train(
+    const std::vector<std::vector<double> > &samples) {
+  if (_numSubspaces < 1) {
+    printf("[ERROR][ProductQuantizer] Parameters are not set\n");
+    return false;
+  }
+  if (samples.empty()) {
+    printf("[ERROR][ProductQuantizer] No samples for training\n");
+    return false;
+  }
+  _dim = samples[0].size();
+  for (const auto &sample : samples) {
+    if (static_cast<int>(sample.size()) != _dim) {
+      printf("[ERROR][ProductQuantizer] Samples have different sizes\n");
+      return false;
+    }
+  }
+  if (_dim < _numSubspaces) {
+    printf("[ERROR][ProductQuantizer] More subspaces than dimensions\n");
+    return false;
+  }
+  if (static_cast<int>(samples.size()) < _numCentroids) {
+    printf(
+        "[WARNING][ProductQuantizer] Only %lu samples, the number of "
+        "centroids is reduced\n",
+        samples.size());
+    _numCentroids = samples.size();
+  }
+  _centroids.assign(static_cast<size_t>(_numCentroids) * _dim, 0.f);
+  for (int m = 0; m < _numSubspaces; ++m) {
+    trainSubspace(m, samples);
+  }
+  updateCentroidNorms();
+  return true;
+}
+
+void ProductQuantizer::trainSubspace(
+    int m, const std::vector<std::vector<double> > &samples) {
+  const int begin = subBegin(m);
+  const int sub = subBegin(m + 1) - begin;
+  const int numSamples = samples.size();
+  std::vector<float> data(static_cast<size_t>(numSamples) * sub);
+  for (int n = 0; n < numSamples; ++n) {
+    std::copy(samples[n].begin() + begin, samples[n].begin() + begin + sub,
+              data.begin() + static_cast<size_t>(n) * sub);
+  }
+  float *centroids = _centroids.data() +
+                     static_cast<size_t>(_numCentroids) * begin;
+
+  // random, but reproducible, samples as initial centroids
+  std::vector<int> ids(numSamples);
+  for (int n = 0; n < numSamples; ++n) {
+    ids[n] = n;
+  }
+  std::mt19937 generator(m);
+  std::shuffle(ids.begin(), ids.end(), generator);
+  for (int k = 0; k < _numCentroids; ++k) {
+    std::copy(data.begin() + static_cast<size_t>(ids[k]) * sub,
+              data.begin() + static_cast<size_t>(ids[k] + 1) * sub,
+              centroids + static_cast<size_t>(k) * sub);
+  }
+
+  std::vector<int> assignment(numSamples, -1);
+  std::vector<float> norms(_numCentroids);
+  for (int it = 0; it < _iterations; ++it) {
+    for (int k = 0; k < _numCentroids; ++k) {
+      const float *c = centroids + static_cast<size_t>(k) * sub;
+      norms[k] = dotProduct(c, c, sub);
+    }
+    bool changed = false;
+    for (int n = 0; n < numSamples; ++n) {
+      const float *x = data.data() + static_cast<size_t>(n) * sub;
+      int best = 0;
+      double bestDist = std::numeric_limits<double>::max();
+      for (int k = 0; k < _numCentroids; ++k) {
+        // |x - c|^2 without the constant |x|^2
+        double dist = norms[k] - 2.0 * dotProduct(
+            x, centroids + static_cast<size_t>(k) * sub, sub);
+        if (dist < bestDist) {
+          bestDist = dist;
+          best = k;
+        }
+      }
+      if (assignment[n] != best) {
+        assignment[n] = best;
+        changed = true;
+      }
+    }
+    if (!changed) {
+      break;
+    }
+    std::vector<double> sums(static_cast<size_t>(_numCentroids) * sub, 0.0);
+    std::vector<int> counts(_numCentroids, 0);
+    for (int n = 0; n < numSamples; ++n) {
+      const float *x = data.data() + static_cast<size_t>(n) * sub;
+      double *sum = sums.data() + static_cast<size_t>(assignment[n]) * sub;
+      for (int d = 0; d < sub; ++d) {
+        sum[d] += x[d];
+      }
+      counts[assignment[n]]++;
+    }
+    for (int k = 0; k < _numCentroids; ++k) {
+      // empty clusters keep their centroid
+      if (counts[k] == 0) {
+        continue;
+      }
+      float *c = centroids + static_cast<size_t>(k) * sub;
+      const double *sum = sums.data() + static_cast<size_t>(k) * sub;
+      for (int d = 0; d < sub; ++d) {
+        c[d] = sum[d] / counts[k];
+      }
+    }
+  }
+}
+
+void ProductQuantizer::updateCentroidNorms() {
+  _centroidNorms.resize(static_cast<size_t>(_numSubspaces) * _numCentroids);
+  for (int m = 0; m < _numSubspaces; ++m) {
+    int sub = subBegin(m + 1) - subBegin(m);
+    for (int k = 0; k < _numCentroids; ++k) {
+      const float *c = centroid(m, k);
+      _centroidNorms[m * _numCentroids + k] = dotProduct(c, c, sub);
+    }
+  }
+}
+
+int ProductQuantizer::nearestCentroid(int m, const float *sub) const {
+  int size = subBegin(m + 1) - subBegin(m);
+  int best = 0;
+  double bestDist = std::numeric_limits<double>::max();
+  for (int k = 0; k < _numCentroids; ++k) {
+    double dist = _centroidNorms[m * _numCentroids + k] -
+                  2.0 * dotProduct(sub, centroid(m, k), size);
+    if (dist < bestDist) {
+      bestDist = dist;
+      best = k;
+    }
+  }
+  return best;
+}
+
+void ProductQuantizer::encode(const double *values, uint8_t *code) const {
+  std::vector<float> converted(values, values + _dim);
+  for (int m = 0; m < _numSubspaces; ++m) {
+    code[m] = nearestCentroid(m, converted.data() + subBegin(m));
+  }
+}
+
+void ProductQuantizer::computeTable(const double *query,
+                                    std::vector<float> *table) const {
+  std::vector<float> converted(query, query + _dim);
+  table->resize(static_cast<size_t>(_numSubspaces) * _numCentroids);
+  for (int m = 0; m < _numSubspaces; ++m) {
+    int begin = subBegin(m);
+    int sub = subBegin(m + 1) - begin;
+    for (int k = 0; k < _numCentroids; ++k) {
+      (*table)[m * _numCentroids + k] =
+          dotProduct(converted.data() + begin, centroid(m, k), sub);
+    }
+  }
+}
+
+double ProductQuantizer::innerProduct(const std::vector<float> &table,
+                                      const uint8_t *code) const {
+  double prod = 0.0;
+  const float *row = table.data();
+  for (int m = 0; m < _numSubspaces; ++m, row += _numCentroids) {
+    prod += row[code[m]];
+  }
+  return prod;
+}
+
+bool ProductQuantizer::write(std::ofstream *out) const {
+  int32_t params[3] = {_dim, _numSubspaces, _numCentroids};
+  out->write(reinterpret_cast<const char *>(params), sizeof(params));
+  out->write(reinterpret_cast<const char *>(_centroids.data()),
+             _centroids.size() * sizeof(float));
+  return out->good();
+}
+
+bool ProductQuantizer::read(std::ifstream *in) {
+  int32_t params[3];
+  if (!in->read(reinterpret_cast<char *>(params), sizeof(params))) {
+    return false;
+  }
+  _dim = params[0];
+  _numSubspaces = params[1];
+  _numCentroids = params[2];
+  if (_dim < 1 || _numSubspaces < 1 || _numSubspaces > _dim ||
+      _numCentroids < 1 || _numCentroids > 256) {
+    return false;
+  }
+  _centroids.resize(static_cast<size_t>(_numCentroids) * _dim);
+  if (!in->read(reinterpret_cast<char *>(_centroids.data()),
+                _centroids.size() * sizeof(float))) {
+    return false;
+  }
+  updateCentroidNorms();
+  return true;
+}
+
+void PqReferenceStore::setQuantizer(const ProductQuantizer &quantizer) {
+  _quantizer = quantizer;
+  _codes.clear();
+  _norms.clear();
+}
+
+void PqReferenceStore::add(const std::vector<double> &values) {
+  if (static_cast<int>(values.size()) != _quantizer.dimension()) {
+    printf("[ERROR][PqReferenceStore] Feature has %lu values instead of %d\n",
+           values.size(), _quantizer.dimension());
+    exit(EXIT_FAILURE);
+  }
+  size_t offset = _codes.size();
+  _codes.resize(offset + _quantizer.codeSize());
+  _quantizer.encode(values.data(), _codes.data() + offset);
+  _norms.push_back(sqrt(dotProduct(values.data(), values.data(),
+                                   values.size())));
+}
+
+bool PqReferenceStore::save(const std::string &filename) const {
+  std::ofstream out(filename.c_str(), std::ios::binary);
+  if (!out) {
+    printf("[ERROR][PqReferenceStore] Cannot open %s for writing\n",
+           filename.c_str());
+    return false;
+  }
+  out.write(kPqStoreMagic, sizeof(kPqStoreMagic));
+  out.write(reinterpret_cast<const char *>(&kPqStoreVersion),
+            sizeof(kPqStoreVersion));
+  if (!_quantizer.write(&out)) {
+    return false;
+  }
+  uint64_t count = _norms.size();
+  out.write(reinterpret_cast<const char *>(&count), sizeof(count));
+  out.write(reinterpret_cast<const char *>(_norms.data()),
+            _norms.size() * sizeof(float));
+  out.write(reinterpret_cast<const char *>(_codes.data()), _codes.size());
+  return out.good();
+}
+
+bool PqReferenceStore::load(const std::string &filename) {
+  std::ifstream in(filename.c_str(), std::ios::binary);
+  char magic[sizeof(kPqStoreMagic)];
+  uint32_t version = 0;
+  if (!in || !in.read(magic, sizeof(magic)) ||
+      memcmp(magic, kPqStoreMagic, sizeof(magic)) != 0 ||
+      !in.read(reinterpret_cast<char *>(&version), sizeof(version)) ||
+      version != kPqStoreVersion) {
+    printf("[ERROR][PqReferenceStore] %s is not a PQ reference store\n",
+           filename.c_str());
+    return false;
+  }
+  uint64_t count = 0;
+  if (!_quantizer.read(&in) ||
+      !in.read(reinterpret_cast<char *>(&count), sizeof(count))) {
+    printf("[ERROR][PqReferenceStore] Store %s is corrupted\n",
+           filename.c_str());
+    return false;
+  }
+  // the count is checked before anything is allocated for it
+  uint64_t start = in.tellg();
+  in.seekg(0, std::ios::end);
+  uint64_t end = in.tellg();
+  in.seekg(start);
+  if (!in || end < start ||
+      count > uint64_t(std::numeric_limits<int>::max()) ||
+      count > (end - start) / bytesPerReference()) {
+    printf("[ERROR][PqReferenceStore] Store %s is corrupted\n",
+           filename.c_str());
+    return false;
+  }
+  _norms.resize(count);
+  _codes.resize(count * _quantizer.codeSize());
+  in.read(reinterpret_cast<char *>(_norms.data()), count * sizeof(float));
+  in.read(reinterpret_cast<char *>(_codes.data()), _codes.size());
+  if (!in) {
+    printf("[ERROR][PqReferenceStore] Store %s is corrupted\n",
+           filename.c_str());
+    _norms.clear();
+    _codes.clear();
+    return false;
+  }
+  printf("[INFO][PqReferenceStore] %lu references with %lu bytes each\n",
+         count, bytesPerReference());
+  return true;
+}
@@ -0,0 +1,138 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#ifndef SRC_FEATURES_PRODUCT_QUANTIZER_H_
+#define SRC_FEATURES_PRODUCT_QUANTIZER_H_
+
+#include <stdint.h>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief      Product quantizer for approximating inner products. The vector
+ * is split into `numSubspaces` parts and every part is replaced by the id of
+ * the nearest of `numCentroids` centroids, learned with k-means. A vector is
+ * then stored in `numSubspaces` bytes. The inner product with a query is a sum
+ * of `numSubspaces` values from a table computed once per query.
+ */
+class ProductQuantizer {
+ public:
+  using Ptr = std::shared_ptr<ProductQuantizer>;
+  using ConstPtr = std::shared_ptr<const ProductQuantizer>;
+
+  /**
+   * @param[in]  numSubspaces  number of parts, equals to the code size
+   * @param[in]  numCentroids  centroids per part, at most 256
+   * @param[in]  iterations    k-means iterations
+   *
+   * @return     false if the parameters are invalid
+   */
+  bool setParams(int numSubspaces, int numCentroids = 256, int iterations = 10);
+  /**
+   * @brief      learns the centroids. If there are less samples than
+   * centroids, only as many centroids as samples are used.
+   *
+   * @param[in]  samples  The training vectors, all of the same size
+   *
+   * @return     false if the quantizer cannot be trained with the samples
+   */
+  bool train(const std::vector<std::vector<double> > &samples);
+  bool isTrained() const { return !_centroids.empty(); }
+
+  /** writes codeSize() bytes to code **/
+  void encode(const double *values, uint8_t *code) const;
+  /**
+   * @brief      Computes the inner products of every query part with every
+   * centroid of this part.
+   *
+   * @param[in]  query  The query of dimension() values
+   * @param[out] table  numSubspaces x numCentroids values
+   */
+  void computeTable(const double *query, std::vector<float> *table) const;
+  /** approximated inner product of the query and the encoded vector **/
+  double innerProduct(const std::vector<float> &table,
+                      const uint8_t *code) const;
+
+  int dimension() const { return _dim; }
+  int numSubspaces() const { return _numSubspaces; }
+  int numCentroids() const { return _numCentroids; }
+  int codeSize() const { return _numSubspaces; }
+
+  bool write(std::ofstream *out) const;
+  bool read(std::ifstream *in);
+
+ private:
+  int subBegin(int m) const {
+    return static_cast<int64_t>(m) * _dim / _numSubspaces;
+  }
+  const float *centroid(int m, int k) const;
+  void trainSubspace(int m, const std::vector<std::vector<double> > &samples);
+  int nearestCentroid(int m, const float *sub) const;
+  void updateCentroidNorms();
+
+  int _dim = 0;
+  int _numSubspaces = 0;
+  int _numCentroids = 256;
+  int _iterations = 10;
+  // for every subspace m, numCentroids centroids of its size one after another
+  std::vector<float> _centroids;
+  // squared norms of the centroids, used for the nearest centroid search
+  std::vector<float> _centroidNorms;
+};
+
+/**
+ * @brief      Product quantized reference features: one code and the exact
+ * L2 norm for every feature.
+ */
+class PqReferenceStore {
+ public:
+  using Ptr = std::shared_ptr<PqReferenceStore>;
+  using ConstPtr = std::shared_ptr<const PqReferenceStore>;
+
+  void setQuantizer(const ProductQuantizer &quantizer);
+  const ProductQuantizer &quantizer() const { return _quantizer; }
+  /** encodes the feature and adds it as the next reference **/
+  void add(const std::vector<double> &values);
+
+  int size() const { return _norms.size(); }
+  const uint8_t *code(int id) const {
+    return _codes.data() + static_cast<size_t>(id) * _quantizer.codeSize();
+  }
+  double norm(int id) const { return _norms[id]; }
+  /** bytes used for one reference **/
+  size_t bytesPerReference() const {
+    return _quantizer.codeSize() + sizeof(float);
+  }
+
+  bool save(const std::string &filename) const;
+  bool load(const std::string &filename);
+
+ private:
+  ProductQuantizer _quantizer;
+  std::vector<uint8_t> _codes;
+  std::vector<float> _norms;
+};
+
+#endif  // SRC_FEATURES_PRODUCT_QUANTIZER_H_
@@ -25,28 +25,26 @@
 #include <algorithm>
 #include <numeric>
 #include <math.h>
-#include <fstream>
 #include <limits>
+#include "features/dot_kernels.h"
+#include "features/feature_file.h"
+#include "features/feature_view.h"
 // #include "tools/timer/timer.h"
 
 void VggFeature::loadFromFile(const std::string &filename) {
   // Timer timer;
   // timer.start();
-  std::ifstream in(filename.c_str());
-  if (!in) {
+  // binary features are mapped directly, text files are parsed as a fallback
+  FeatureFileHeader header;
+  if (!loadFeatureValues(filename, TEXT_VALUES_ONLY, &dim, &header)) {
     printf("[ERROR][OnlineDatabase] Feature %s cannot be loaded\n",
            filename.c_str());
     exit(EXIT_FAILURE);
   }
-
-  double value;
-  while (in >> value) {
-    dim.push_back(value);
-  }
-  in.close();
   // timer.stop();
   // cout << "Feature loading time: ";
   // timer.print_elapsed_time(TimeExt::MSec);
+  _norm = header.norm;
   binarize();
 }
 
@@ -60,35 +58,44 @@ void VggFeature::binarize() {
   d_max = *min_maxEl.second;
   double tmp = (des_max - des_min) / (d_max - d_min);
 
-  bits.resize(dim.size(), 0);
-
   int thresh = des_max / 2;
-  for (int f = 0; f < dim.size(); ++f) {
+  // the bits are packed one word at a time
+  bits.pack(dim.size(), [&](size_t f) {
     int d_int = (dim[f] - d_min) * tmp + des_min;
-    bool value = d_int < thresh ? 0 : 1;
-    bits[f] = value;
-  }
+    return d_int >= thresh;
+  });
 }
 
 double VggFeature::computeSimilarityScore(const iFeature::ConstPtr& rhs) const {
-  const auto featurePtr = std::static_pointer_cast<const VggFeature>(rhs);
+  const auto featurePtr = dynamic_cast<const VggFeature *>(rhs.get());
   if (!featurePtr) {
+    // archived features are matched by the view
+    if (const auto view = dynamic_cast<const FeatureView *>(rhs.get())) {
+      return view->similarityTo(*this);
+    }
     printf(
         "[ERROR][Feature] It seems like you are trying to match features of "
         "different type\n");
     exit(EXIT_FAILURE);
   }
-  double norm_qr =
-      sqrt(std::inner_product(dim.begin(), dim.end(), dim.begin(), 0.0L));
-  double norm_db =
-      sqrt(std::inner_product(featurePtr->dim.begin(), featurePtr->dim.end(),
-                              featurePtr->dim.begin(), 0.0L));
-  double prod_qr_db = std::inner_product(
-      featurePtr->dim.begin(), featurePtr->dim.end(), dim.begin(), 0.0L);
-  double cos_dist = prod_qr_db / (norm_qr * norm_db);
+  // the norms are cached, only the dot product is computed here
+  double prod_qr_db =
+      dotProduct(featurePtr->dim.data(), dim.data(), featurePtr->dim.size());
+  double cos_dist = prod_qr_db / (norm() * featurePtr->norm());
   return cos_dist;
 }
 
+double VggFeature::norm() const {
+  if (_norm < 0) {
+    return sqrt(dotProduct(dim.data(), dim.data(), dim.size()));
+  }
+  return _norm;
+}
+
+void VggFeature::updateNorm() {
+  _norm = sqrt(dotProduct(dim.data(), dim.data(), dim.size()));
+}
+
 double VggFeature::score2cost(double score) const {
   double cost;
   if (score < 1e-09) {
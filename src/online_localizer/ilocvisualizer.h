@@ -26,7 +26,6 @@
 
 #include <memory>
 #include <set>
-#include <unordered_set>
 #include <vector>
 #include "online_localizer/path_element.h"
 #include "successor_manager/node.h"
@@ -41,7 +40,7 @@ class iLocVisualizer {
   using ConstPtr = std::shared_ptr<const iLocVisualizer>;
 
   virtual void drawPath(const std::vector<PathElement> &path) = 0;
-  virtual void drawFrontier(const std::unordered_set<Node> &frontier) = 0;
+  virtual void drawFrontier(const NodeSet &frontier) = 0;
   virtual void drawExpansion(NodeSet expansion) = 0;
   virtual void processFinished() = 0;
 };
@@ -35,11 +35,11 @@ using std::string;
 
 OnlineLocalizer::OnlineLocalizer() {
   // _pred[-1][-1] = Node(-1, -1, 0.0);
-  _pred[SOURCE_NODE.quId][SOURCE_NODE.refId] = SOURCE_NODE;
+  _pred(SOURCE_NODE.quId, SOURCE_NODE.refId) = SOURCE_NODE;
   Node source = SOURCE_NODE;
   source.accCost = 0.0;
   // SOURCE_NODE.accCost = 0.0;
-  _accCosts[SOURCE_NODE.quId][SOURCE_NODE.refId] = source.accCost;
+  _accCosts(SOURCE_NODE.quId, SOURCE_NODE.refId) = source.accCost;
   _frontier.push(source);
   _currentBestHyp = source;
 }
@@ -83,15 +83,44 @@ bool OnlineLocalizer::setNonMatchingCost(double non_match) {
   return true;
 }
 
-bool OnlineLocalizer::isReady() const {
-  if (!_successorManager) {
-    printf("[ERROR][OnlineLocalizer] Successor manager is not set\n");
+bool OnlineLocalizer::setAdaptiveFanOut(int margin, int window) {
+  if (margin < 0 || window < 2) {
+    printf(
+        "[ERROR][OnlineLocalizer] Invalid adaptive fan out: margin %d, window "
+        "%d\n",
+        margin, window);
+    return false;
+  }
+  _adaptiveMargin = margin;
+  _adaptiveWindow = window;
+  return true;
+}
+
+bool OnlineLocalizer::setHistory(int rows) {
+  // the lost detection looks at the last matches
+  if (rows < 0 || (rows > 0 && rows < _slidingWindowSize)) {
+    printf(
+        "[ERROR][OnlineLocalizer] The history should keep at least %d rows\n",
+        _slidingWindowSize);
     return false;
   }
+  _historyRows = rows;
+  return true;
+}
+
+bool OnlineLocalizer::isReady() const {
   if (_querySize == 0) {
     printf("[ERROR][OnlineLocalizer] Size of the query sequence is not set\n");
     return false;
   }
+  return isSearchReady();
+}
+
+bool OnlineLocalizer::isSearchReady() const {
+  if (!_successorManager) {
+    printf("[ERROR][OnlineLocalizer] Successor manager is not set\n");
+    return false;
+  }
   if (_expansionRate < 0.0) {
     printf("[ERROR][OnlineLocalizer] Expansion rate is not set\n");
     return false;
@@ -111,23 +140,26 @@ bool OnlineLocalizer::isReady() const {
 void OnlineLocalizer::matchImage(int quId) {
   _expandedRecently.clear();
 
-  std::unordered_set<Node> children;
+  std::vector<Node> &children = _children;
+  children.clear();
   if (_needReloc) {
-    _frontier = std::priority_queue<Node>();  // reseting priority_queue
+    _frontier = Frontier();  // reseting priority_queue
     printf("[INFO][OnlineLocalizer] RELOCALIZATION\n");
     Node expandedNode = _currentBestHyp;
-    children = _successorManager->getSuccessorsIfLost(expandedNode);
+    _successorManager->getSuccessorsIfLost(expandedNode, &children);
     // add only the most promising node to the frontier
     // need to call update search, since it updates the current best
     // hypothesis
     updateSearch(children);
-    children.clear();
     // just one most promising child is added to the graph
-    children.insert(_currentBestHyp);
+    children.assign(1, _currentBestHyp);
     updateGraph(expandedNode, children);
   } else {
     bool row_reached = false;
     printf("[INFO][OnlineLocalizer] NOT LOST\n");
+    if (_rowBatching) {
+      precomputeRow(quId - 1);
+    }
     while (!_frontier.empty() && !row_reached) {
       // counterNodes++;
       Node expandedNode = _frontier.top();
@@ -139,7 +171,7 @@ void OnlineLocalizer::matchImage(int quId) {
       }
       // printf("Node %d %d  %d worth expanding\n", expandedNode.quId,
       // expandedNode.refKey.refId, expandedNode.refKey.seqId);
-      children = _successorManager->getSuccessors(expandedNode);
+      _successorManager->getSuccessors(expandedNode, &children);
       updateGraph(expandedNode, children);
       updateSearch(children);
       if (expanded_row == quId - 1) {
@@ -157,11 +189,80 @@ void OnlineLocalizer::matchImage(int quId) {
   }
 }
 
+void OnlineLocalizer::precomputeRow(int quId) {
+  _rowParents.clear();
+  // the nodes that are not worth expanding now are likely to stay so. If
+  // one of them gets expanded anyway, its costs are computed then.
+  for (const Node &node : _frontier.nodes()) {
+    if (node.quId == quId && node.quId >= 0 &&
+        node.quId <= _currentBestHyp.quId && nodeWorthExpanding(node)) {
+      _rowParents.push_back(node);
+    }
+  }
+  _successorManager->precomputeSuccessors(_rowParents);
+}
+
+void OnlineLocalizer::updateStepWindow() {
+  if (_needReloc) {
+    _successorManager->resetStepWindow();
+    return;
+  }
+  // latest match first
+  std::vector<PathElement> path = getLastNmatches(_adaptiveWindow);
+  size_t hidden = 0;
+  while (hidden < path.size() && path[hidden].state == HIDDEN) {
+    ++hidden;
+  }
+  // only the steps between real matches tell the speed
+  _steps.clear();
+  for (size_t i = 0; i + 1 < path.size(); ++i) {
+    if (path[i].state == REAL && path[i + 1].state == REAL) {
+      _steps.push_back(path[i].refId - path[i + 1].refId);
+    }
+  }
+  // the margin would exceed any fan out
+  if (_steps.empty() || hidden >= 16) {
+    _successorManager->resetStepWindow();
+    return;
+  }
+  std::nth_element(_steps.begin(), _steps.begin() + _steps.size() / 2,
+                   _steps.end());
+  int step = _steps[_steps.size() / 2];
+  int margin = _adaptiveMargin << hidden;
+  _successorManager->setStepWindow(step - margin, step + margin);
+}
+
+void OnlineLocalizer::pruneHistory() {
+  int cutoff = _currentBestHyp.quId - _historyRows;
+  _frontier.removeRowsBefore(cutoff);
+  PredMap pred;
+  AccCostsMap accCosts;
+  for (const auto &entry : _pred) {
+    int quId = entry.quId(), refId = entry.refId();
+    if (quId < cutoff) {
+      continue;
+    }
+    // the paths end at the oldest kept row
+    pred(quId, refId) =
+        entry.value.quId < cutoff ? SOURCE_NODE : entry.value;
+    accCosts(quId, refId) = _accCosts.at(quId, refId);
+  }
+  _pred = std::move(pred);
+  _accCosts = std::move(accCosts);
+  _oldestRow = cutoff;
+}
+
 void OnlineLocalizer::processImage(int quId) {
   printf("[DEBUG][OnlineLocalizer] Checking image %d\n", quId);
   if (quId == 0) {
     _needReloc = true;
   }
+  if (!_needReloc && _currentBestHyp.quId >= 0) {
+    _successorManager->setSearchFocus(quId, _currentBestHyp.refId);
+  }
+  if (_adaptiveMargin > 0) {
+    updateStepWindow();
+  }
   matchImage(quId);
 
   // printf("[INFO] Qu %d frontier empty %d\n", qu, frontier.empty());
@@ -177,6 +278,11 @@ void OnlineLocalizer::processImage(int quId) {
     // not lost anymore
     _needReloc = false;
   }
+  // the graph is rebuilt once per `_historyRows` rows
+  if (_historyRows > 0 &&
+      _currentBestHyp.quId - _oldestRow >= 2 * _historyRows) {
+    pruneHistory();
+  }
 }
 
 void OnlineLocalizer::run() {
@@ -200,6 +306,10 @@ void OnlineLocalizer::run() {
     printf("==========================================\n");
     visualize();
   }
+  finish();
+}
+
+void OnlineLocalizer::finish() {
   printf("[DEBUG][OnlineLocalizer] Localization finished\n");
   if (_vis) {
     _vis->processFinished();
@@ -228,14 +338,14 @@ bool OnlineLocalizer::nodeWorthExpanding(const Node &node) const {
   double mean_cost = computeAveragePathCost();
   double potential_cost = node.accCost + row_dist * mean_cost * _expansionRate;
   if (potential_cost <
-      _accCosts.at(_currentBestHyp.quId).at(_currentBestHyp.refId)) {
+      _accCosts.at(_currentBestHyp.quId, _currentBestHyp.refId)) {
     return true;
   } else {
     return false;
   }
 }
 
-void OnlineLocalizer::updateSearch(const NodeSet &successors) {
+void OnlineLocalizer::updateSearch(const std::vector<Node> &successors) {
   Node possibleHyp = getProminentSuccessor(successors);
   // printf("[DEBUG][OnlineLocalizer] Prominent child is: ");
   // possibleHyp.print();
@@ -244,8 +354,8 @@ void OnlineLocalizer::updateSearch(const NodeSet &successors) {
     _currentBestHyp = possibleHyp;
   } else if (possibleHyp.quId == _currentBestHyp.quId) {
     double accCost_current =
-        _accCosts[_currentBestHyp.quId][_currentBestHyp.refId];
-    double accCost_poss = _accCosts[possibleHyp.quId][possibleHyp.refId];
+        _accCosts(_currentBestHyp.quId, _currentBestHyp.refId);
+    double accCost_poss = _accCosts(possibleHyp.quId, possibleHyp.refId);
     if (accCost_poss <= accCost_current) {
       _currentBestHyp = possibleHyp;
     }
@@ -254,7 +364,8 @@ void OnlineLocalizer::updateSearch(const NodeSet &successors) {
   // _currentBestHyp.print();
 }
 
-Node OnlineLocalizer::getProminentSuccessor(const NodeSet &successors) const {
+Node OnlineLocalizer::getProminentSuccessor(
+    const std::vector<Node> &successors) const {
   double min_cost = std::numeric_limits<double>::max();
   Node minCost_node;
   for (const Node &node : successors) {
@@ -279,27 +390,18 @@ double OnlineLocalizer::computeAveragePathCost() const {
     }
     mean_cost += pred.idvCost;
     elInPath++;
-    pred = _pred.at(pred.quId).at(pred.refId);
+    pred = _pred.at(pred.quId, pred.refId);
   }
   mean_cost = mean_cost / elInPath;
   return mean_cost;
 }
 
 bool OnlineLocalizer::predExists(const Node &node) const {
-  auto quId_found = _pred.find(node.quId);
-  if (quId_found == _pred.end()) {
-    // not found
-    return false;
-  }
-  auto node_found = quId_found->second.find(node.refId);
-  if (node_found == quId_found->second.end()) {
-    return false;
-  }
-  return true;
+  return _pred.get(node.quId, node.refId) != nullptr;
 }
 
 void OnlineLocalizer::updateGraph(const Node &parent,
-                                  const NodeSet &successors) {
+                                  const std::vector<Node> &successors) {
   if (successors.empty()) {
     printf(
         "[WARNING] No successors to add to the graph. May lead to disconnected "
@@ -314,7 +416,7 @@ void OnlineLocalizer::updateGraph(const Node &parent,
   for (Node child : successors) {
     if (predExists(child)) {
       // child was visisted before
-      double prev_accCost = _accCosts[child.quId][child.refId];
+      double prev_accCost = _accCosts(child.quId, child.refId);
       double poss_accCost = child.idvCost + parent.accCost;
       if (poss_accCost < prev_accCost) {
         // printf("[DEBUG][OnlineLocalizer] The child was visited before\n");
@@ -328,8 +430,8 @@ void OnlineLocalizer::updateGraph(const Node &parent,
         // update pred; update accu_costs + update frontier.
         // assign an alternative parent (the one that came in a function) to a
         // child
-        _pred[child.quId][child.refId] = parent;
-        _accCosts[child.quId][child.refId] = poss_accCost;
+        _pred(child.quId, child.refId) = parent;
+        _accCosts(child.quId, child.refId) = poss_accCost;
         // do not forget to update the accumulated cost for a child for
         // estimating the priority
         child.accCost = poss_accCost;
@@ -341,9 +443,9 @@ void OnlineLocalizer::updateGraph(const Node &parent,
       }
     } else {
       // new successor
-      _pred[child.quId][child.refId] = parent;
-      _accCosts[child.quId][child.refId] = child.idvCost + parent.accCost;
-      child.accCost = _accCosts[child.quId][child.refId];
+      _pred(child.quId, child.refId) = parent;
+      _accCosts(child.quId, child.refId) = child.idvCost + parent.accCost;
+      child.accCost = _accCosts(child.quId, child.refId);
       _frontier.push(child);
     }
   }
@@ -363,7 +465,7 @@ std::vector<PathElement> OnlineLocalizer::getCurrentPath() const {
     NodeState state = pred.idvCost > _nonMatchCost ? HIDDEN : REAL;
     PathElement pathEl(pred.quId, pred.refId, state);
     path.push_back(pathEl);
-    pred = _pred.at(pred.quId).at(pred.refId);
+    pred = _pred.at(pred.quId, pred.refId);
   }
   return path;
 }
@@ -425,7 +527,7 @@ std::vector<PathElement> OnlineLocalizer::getLastNmatches(int N) const {
     NodeState state = pred.idvCost > _nonMatchCost ? HIDDEN : REAL;
     PathElement pathEl(pred.quId, pred.refId, state);
     path.push_back(pathEl);
-    pred = _pred.at(pred.quId).at(pred.refId);
+    pred = _pred.at(pred.quId, pred.refId);
     counter--;
   }
   return path;
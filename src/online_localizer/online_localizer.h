@@ -24,10 +24,10 @@
 #ifndef SRC_ONLINE_LOCALIZER_ONLINE_LOCALIZER_H_
 #define SRC_ONLINE_LOCALIZER_ONLINE_LOCALIZER_H_
 
+#include <algorithm>
 #include <memory>
 #include <set>
 #include <string>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 #include <queue>
@@ -37,21 +37,71 @@
 #include "successor_manager/node.h"
 #include "successor_manager/successor_manager.h"
 
+/**
+ * @brief      Priority queue of the nodes to expand, which also gives access
+ * to all the stored nodes.
+ */
+class Frontier : public std::priority_queue<Node> {
+ public:
+  const std::vector<Node> &nodes() const { return c; }
+  /** removes the nodes of the query images before quId **/
+  void removeRowsBefore(int quId) {
+    c.erase(std::remove_if(c.begin(), c.end(),
+                           [quId](const Node &node) {
+                             return node.quId < quId;
+                           }),
+            c.end());
+    std::make_heap(c.begin(), c.end(), comp);
+  }
+};
+
 /**
  * @brief      Class for online localization
  */
 class OnlineLocalizer {
  public:
-  using PredMap = std::unordered_map<int, std::unordered_map<int, Node> >;
-  using AccCostsMap = std::unordered_map<int, std::unordered_map<int, double> >;
+  using PredMap = NodeMap<Node>;
+  using AccCostsMap = NodeMap<double>;
 
   OnlineLocalizer();
-  ~OnlineLocalizer() {}
+  virtual ~OnlineLocalizer() {}
   void setQuerySize(int size) { _querySize = size; }
   bool setSuccessorManager(SuccessorManager::Ptr succManager);
   bool setVisualizer(iLocVisualizer::Ptr vis);
   bool setExpansionRate(double rate);
   bool setNonMatchingCost(double non_match);
+  /**
+   * @brief      Before expanding the nodes of a query image, the costs of
+   * the successors of all its worthwhile nodes are computed in one batch,
+   * in parallel if the successor manager has several threads. The found
+   * path is the same as without batching.
+   */
+  void setRowBatching(bool enable) { _rowBatching = enable; }
+  /**
+   * @brief      Adaptive fan out: the successors of a node are searched
+   * around the reference step per query image, which is estimated from the
+   * last matches. The window spans `margin` refs on each side of the step.
+   * The margin doubles for every recent hidden match, so the search widens
+   * up to the full fan out when the matching fails.
+   *
+   * @param[in]  margin  The margin, 0 disables the adaptive fan out
+   * @param[in]  window  The number of last matches to estimate the step from
+   */
+  bool setAdaptiveFanOut(int margin, int window = 5);
+  /**
+   * @brief      Keeps only the search graph of the last query images, so the
+   * memory stays bounded on an endless stream. The older nodes are removed
+   * from the frontier, the predecessors and the accumulated costs, and the
+   * paths end at the oldest kept row. Between `rows` and 2 * `rows` rows
+   * are kept.
+   *
+   * @param[in]  rows  The number of rows, 0 keeps the whole graph
+   */
+  bool setHistory(int rows);
+  /** the oldest query row the search can still expand, -1 for the source **/
+  int oldestRow() const { return _oldestRow; }
+  /** number of nodes in the search graph **/
+  size_t graphSize() const { return _pred.size(); }
 
   /**
    * @brief      dumps path to the file. Line format: quId refId status (0-
@@ -61,8 +111,9 @@ class OnlineLocalizer {
    */
   void printPath(const std::string &filename) const;
 
-  bool isReady() const;
-  void run();
+  virtual bool isReady() const;
+  /** matches the query images 0 .. querySize - 1 **/
+  virtual void run();
   void processImage(int quId);
   // core working function
   void matchImage(int quId);
@@ -71,10 +122,10 @@ class OnlineLocalizer {
 
   // TODO: move these into protected
   // more on private side
-  void updateSearch(const NodeSet &successors);
+  void updateSearch(const std::vector<Node> &successors);
   void updateGraph(const Node &parent,
-                   const NodeSet &successors);
-  Node getProminentSuccessor(const NodeSet &successors) const;
+                   const std::vector<Node> &successors);
+  Node getProminentSuccessor(const std::vector<Node> &successors) const;
   bool predExists(const Node &node) const;
   bool nodeWorthExpanding(const Node &node) const;
   double computeAveragePathCost() const;
@@ -83,6 +134,18 @@ class OnlineLocalizer {
 
   void visualize() const;
 
+ protected:
+  /** checks the parameters of the search, the query size is not needed **/
+  bool isSearchReady() const;
+  /** tells the visualizer that all the images were processed **/
+  void finish();
+  /** precomputes the successors of the frontier nodes of the query quId **/
+  void precomputeRow(int quId);
+  /** sets the step window of the successor manager from the last matches **/
+  void updateStepWindow();
+  /** removes the nodes older than the history **/
+  void pruneHistory();
+
  private:
   int _querySize = 0;
   int _slidingWindowSize = 5; // frames
@@ -90,7 +153,7 @@ class OnlineLocalizer {
   double _expansionRate = -1.0;
   double _nonMatchCost = -1.0;
 
-   std::priority_queue<Node> _frontier;
+  Frontier _frontier;
   // stores parent for each node
   PredMap _pred;
   // stores the accumulative  cost for each node
@@ -101,6 +164,15 @@ class OnlineLocalizer {
   iLocVisualizer::Ptr _vis = nullptr;
 
   NodeSet _expandedRecently;
+  // successors of the expanded node, reused between the expansions
+  std::vector<Node> _children;
+  bool _rowBatching = false;
+  int _adaptiveMargin = 0;
+  int _adaptiveWindow = 5;
+  std::vector<int> _steps;
+  std::vector<Node> _rowParents;
+  int _historyRows = 0;
+  int _oldestRow = -1;
 };
 
 #endif  // SRC_ONLINE_LOCALIZER_ONLINE_LOCALIZER_H_
@@ -0,0 +1,105 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include "online_localizer/query_stream.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+QueryStream::QueryStream(int capacity) : _capacity(capacity) {
+  if (capacity < 1) {
+    printf("[ERROR][QueryStream] The capacity should be at least 1\n");
+    exit(EXIT_FAILURE);
+  }
+}
+
+bool QueryStream::push(const iFeature::ConstPtr &feature) {
+  Query query;
+  query.feature = feature;
+  return pushQuery(query, true);
+}
+
+bool QueryStream::push(const std::string &path) {
+  Query query;
+  query.path = path;
+  return pushQuery(query, true);
+}
+
+bool QueryStream::tryPush(const iFeature::ConstPtr &feature) {
+  Query query;
+  query.feature = feature;
+  return pushQuery(query, false);
+}
+
+bool QueryStream::tryPush(const std::string &path) {
+  Query query;
+  query.path = path;
+  return pushQuery(query, false);
+}
+
+bool QueryStream::pushQuery(const Query &query, bool wait) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  if (wait) {
+    _notFull.wait(lock, [this] {
+      return _closed || static_cast<int>(_queries.size()) < _capacity;
+    });
+  }
+  if (_closed || static_cast<int>(_queries.size()) >= _capacity) {
+    return false;
+  }
+  _queries.push_back(query);
+  lock.unlock();
+  _notEmpty.notify_one();
+  return true;
+}
+
+void QueryStream::close() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _closed = true;
+  }
+  _notFull.notify_all();
+  _notEmpty.notify_all();
+}
+
+bool QueryStream::pop(Query *query) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  _notEmpty.wait(lock, [this] { return _closed || !_queries.empty(); });
+  if (_queries.empty()) {
+    return false;
+  }
+  *query = _queries.front();
+  _queries.pop_front();
+  lock.unlock();
+  _notFull.notify_one();
+  return true;
+}
+
+int QueryStream::size() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _queries.size();
+}
+
+bool QueryStream::isClosed() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _closed;
+}
@@ -0,0 +1,86 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#ifndef SRC_ONLINE_LOCALIZER_QUERY_STREAM_H_
+#define SRC_ONLINE_LOCALIZER_QUERY_STREAM_H_
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "features/ifeature.h"
+
+/**
+ * @brief      Bounded queue of the query features arriving from a camera.
+ * The producer pushes the features (in memory or as files), the localizer
+ * takes them one by one. When the queue is full, push waits, so a producer
+ * faster than the localizer is slowed down.
+ */
+class QueryStream {
+ public:
+  using Ptr = std::shared_ptr<QueryStream>;
+  using ConstPtr = std::shared_ptr<const QueryStream>;
+
+  /** a query feature, either in memory or stored in a file **/
+  struct Query {
+    iFeature::ConstPtr feature = nullptr;
+    std::string path;
+  };
+
+  static const int kDefaultCapacity = 8;
+
+  explicit QueryStream(int capacity = kDefaultCapacity);
+
+  /** waits while the queue is full. Returns false if the stream is closed **/
+  bool push(const iFeature::ConstPtr &feature);
+  bool push(const std::string &path);
+  /** does not wait. Returns false if the queue is full or closed **/
+  bool tryPush(const iFeature::ConstPtr &feature);
+  bool tryPush(const std::string &path);
+  /** no more queries will come, the queued ones are still taken **/
+  void close();
+
+  /**
+   * @brief      Waits for the next query.
+   *
+   * @return     false if the stream is closed and empty.
+   */
+  bool pop(Query *query);
+
+  int size() const;
+  int capacity() const { return _capacity; }
+  bool isClosed() const;
+
+ private:
+  bool pushQuery(const Query &query, bool wait);
+
+  int _capacity;
+  mutable std::mutex _mutex;
+  std::condition_variable _notFull;
+  std::condition_variable _notEmpty;
+  std::deque<Query> _queries;
+  bool _closed = false;
+};
+
+#endif  // SRC_ONLINE_LOCALIZER_QUERY_STREAM_H_
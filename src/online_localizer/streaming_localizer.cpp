@@ -0,0 +1,95 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include "online_localizer/streaming_localizer.h"
+#include <vector>
+#include "tools/timer/timer.h"
+
+StreamingLocalizer::StreamingLocalizer() { setHistory(kDefaultHistory); }
+
+bool StreamingLocalizer::setDatabase(OnlineDatabase::Ptr database) {
+  if (!database) {
+    printf("[ERROR][StreamingLocalizer] Database is not set\n");
+    return false;
+  }
+  _database = database;
+  return true;
+}
+
+bool StreamingLocalizer::setQueryStream(QueryStream::Ptr stream) {
+  if (!stream) {
+    printf("[ERROR][StreamingLocalizer] Query stream is not set\n");
+    return false;
+  }
+  _stream = stream;
+  return true;
+}
+
+bool StreamingLocalizer::isReady() const {
+  if (!_database) {
+    printf("[ERROR][StreamingLocalizer] Database is not set\n");
+    return false;
+  }
+  if (!_stream) {
+    printf("[ERROR][StreamingLocalizer] Query stream is not set\n");
+    return false;
+  }
+  return isSearchReady();
+}
+
+void StreamingLocalizer::run() {
+  if (!isReady()) {
+    printf(
+        "[ERROR][StreamingLocalizer] Streaming Localizer is not ready to "
+        "work. Check if all needed parameters are set.\n");
+    exit(EXIT_FAILURE);
+  }
+
+  Timer timer;
+  QueryStream::Query query;
+  while (_stream->pop(&query)) {
+    int quId = query.feature ? _database->addQueryFeature(query.feature)
+                             : _database->addQueryFeature(query.path);
+    if (quId < 0) {
+      printf("[ERROR][StreamingLocalizer] The query was skipped\n");
+      continue;
+    }
+    timer.start();
+    processImage(quId);
+    // the rows before the history are not expanded any more
+    _database->dropQueryFeatures(oldestRow());
+    timer.stop();
+    printf("[StreamingLocalizer] Matched image %d\n", quId);
+    timer.print_elapsed_time(TimeExt::MSec);
+    printf("==========================================\n");
+    visualize();
+    ++_processed;
+    if (_callback) {
+      std::vector<PathElement> last = getLastNmatches(1);
+      if (!last.empty()) {
+        _callback(last.front());
+      }
+    }
+  }
+  finish();
+}
@@ -0,0 +1,69 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#ifndef SRC_ONLINE_LOCALIZER_STREAMING_LOCALIZER_H_
+#define SRC_ONLINE_LOCALIZER_STREAMING_LOCALIZER_H_
+
+#include <functional>
+#include <memory>
+#include "database/online_database.h"
+#include "online_localizer/online_localizer.h"
+#include "online_localizer/query_stream.h"
+
+/**
+ * @brief      Localizer for a live camera. The query features are taken from
+ * a QueryStream and every feature is matched as soon as it arrives, so the
+ * number of query images does not have to be known. Only the search graph of
+ * the recent query images is kept (see setHistory) and the streamed features
+ * of the older rows are released from the database.
+ */
+class StreamingLocalizer : public OnlineLocalizer {
+ public:
+  static const int kDefaultHistory = 256;
+
+  StreamingLocalizer();
+
+  /** called after every query image with its current match **/
+  using MatchCallback = std::function<void(const PathElement &match)>;
+
+  /** the database receives the query features of the stream **/
+  bool setDatabase(OnlineDatabase::Ptr database);
+  bool setQueryStream(QueryStream::Ptr stream);
+  void setMatchCallback(const MatchCallback &callback) {
+    _callback = callback;
+  }
+
+  bool isReady() const override;
+  /** matches the queries until the stream is closed and empty **/
+  void run() override;
+  /** number of query images matched so far **/
+  int processedCount() const { return _processed; }
+
+ private:
+  OnlineDatabase::Ptr _database = nullptr;
+  QueryStream::Ptr _stream = nullptr;
+  MatchCallback _callback;
+  int _processed = 0;
+};
+
+#endif  // SRC_ONLINE_LOCALIZER_STREAMING_LOCALIZER_H_
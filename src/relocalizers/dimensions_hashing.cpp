@@ -58,12 +58,10 @@ std::vector<int> DimensionsHashing::getCandidates(int quId) {
 void DimensionsHashing::hashFeatures(
     const std::vector<iBinarizableFeature::Ptr>& features) {
   for (size_t f = 0; f < features.size(); ++f) {
-    for (size_t b = 0; b < features[f]->bits.size(); ++b) {
-      if (features[f]->bits[b]) {
-        // if selected bin is 1
-        index[b].push_back(f);
-      }
-    }
+    // only the bins set to 1 are visited
+    features[f]->bits.forEachSetBit([this, f](size_t b) {
+      index[b].push_back(f);
+    });
   }
   this->weightIndex(features.size());
 }
@@ -103,27 +101,25 @@ std::vector<int> DimensionsHashing::hashFeature(
     exit(EXIT_FAILURE);
   }
   std::unordered_map<int, float> featureOcc;
-  for (int d = 0; d < fPtr->bits.size(); ++d) {
-    if (fPtr->bits[d]) {
-      // if bit equals to 1, take the dimension id and check in the index
-      auto dim_found = index.find(d);
-      if (dim_found != index.end()) {
-        // an entry for dimension d exists
-        // then add all associated feature ids
-        for (int featureId : dim_found->second) {
-          auto found = featureOcc.find(featureId);
-          if (found == featureOcc.end()) {
-            // new featureId
-            // featureOcc[featureId] = 1.0;
-            featureOcc[featureId] = _dimWeights.at(d);
-          } else {
-            // featureOcc[featureId] += 1.0;
-            featureOcc[featureId] += _dimWeights.at(d);
-          }
+  // take the dimension id of every bit that equals to 1 and check in the index
+  fPtr->bits.forEachSetBit([&](size_t d) {
+    auto dim_found = index.find(d);
+    if (dim_found != index.end()) {
+      // an entry for dimension d exists
+      // then add all associated feature ids
+      for (int featureId : dim_found->second) {
+        auto found = featureOcc.find(featureId);
+        if (found == featureOcc.end()) {
+          // new featureId
+          // featureOcc[featureId] = 1.0;
+          featureOcc[featureId] = _dimWeights.at(d);
+        } else {
+          // featureOcc[featureId] += 1.0;
+          featureOcc[featureId] += _dimWeights.at(d);
         }
       }
     }
-  }
+  });
 
   std::vector<int> candidates;
   if (featureOcc.empty()) {
@@ -22,6 +22,7 @@
 **/
 
 #include "lsh_cv_hashing.h"
+#include <string.h>
 #include "database/list_dir.h"
 #include "tools/timer/timer.h"
 
@@ -44,12 +45,12 @@ void LshCvHashing::train(std::vector<iBinarizableFeature::Ptr> features) {
   }
   _matcherPtr =
       cv::Ptr<cv::FlannBasedMatcher>(new cv::FlannBasedMatcher(_indexParam));
-  // transform to cv::Mat array of arrays
-  cv::Mat matFeatures(features.size(), features[0]->bits.size(), CV_8UC1);
+  // transform to cv::Mat array of arrays. Every row holds the packed bits
+  // as bytes, the way the binary descriptors are stored in OpenCV
+  const size_t rowBytes = features[0]->bits.numWords() * sizeof(uint64_t);
+  cv::Mat matFeatures(features.size(), rowBytes, CV_8UC1);
   for (int f = 0; f < features.size(); ++f) {
-    for (int d = 0; d < features[f]->bits.size(); ++d) {
-      matFeatures.at<uchar>(f, d) = features[f]->bits[d];
-    }
+    memcpy(matFeatures.ptr<uchar>(f), features[f]->bits.words(), rowBytes);
   }
   printf("Features were converted to Mat type %d\n", matFeatures.type());
   _matcherPtr->add(matFeatures);
@@ -63,10 +64,9 @@ void LshCvHashing::train(std::vector<iBinarizableFeature::Ptr> features) {
 std::vector<int> LshCvHashing::hashFeature(
     const iBinarizableFeature::ConstPtr& fPtr) {
   std::vector<std::vector<cv::DMatch>> matches;
-  cv::Mat feature(1, fPtr->bits.size(), CV_8UC1);
-  for (int i = 0; i < fPtr->bits.size(); ++i) {
-    feature.at<uchar>(0, i) = fPtr->bits[i];
-  }
+  // the packed words are used in place
+  cv::Mat feature(1, fPtr->bits.numWords() * sizeof(uint64_t), CV_8UC1,
+                  const_cast<uint64_t *>(fPtr->bits.words()));
   // _matcherPtr->match(feature, matches);
   Timer timer;
   timer.start();
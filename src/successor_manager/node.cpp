@@ -51,3 +51,13 @@ void Node::print() const {
 }
 
 
+
+bool NodeSet::insert(const Node &node) {
+  size_t before = _nodes.size();
+  Node &stored = _nodes(node.quId, node.refId);
+  if (_nodes.size() == before) {
+    return false;
+  }
+  stored = node;
+  return true;
+}
@@ -24,9 +24,14 @@
 #ifndef SRC_SUCCESSOR_MANAGER_NODE_H_
 #define SRC_SUCCESSOR_MANAGER_NODE_H_
 
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 /**
@@ -54,19 +59,233 @@ class Node {
  * tests**/
 bool operator==(const Node &lhs, const Node &rhs);
 
+/** packs the coordinates (quId, refId) of a node into one key **/
+inline uint64_t nodeKey(int quId, int refId) {
+  return (static_cast<uint64_t>(static_cast<uint32_t>(quId)) << 32) |
+         static_cast<uint32_t>(refId);
+}
+inline int nodeKeyQuId(uint64_t key) { return static_cast<int32_t>(key >> 32); }
+inline int nodeKeyRefId(uint64_t key) {
+  return static_cast<int32_t>(key & 0xFFFFFFFFu);
+}
+
+/** integer mix (splitmix64 finalizer) of a packed node key **/
+inline uint64_t nodeKeyHash(uint64_t key) {
+  key ^= key >> 30;
+  key *= 0xbf58476d1ce4e5b9ULL;
+  key ^= key >> 27;
+  key *= 0x94d049bb133111ebULL;
+  key ^= key >> 31;
+  return key;
+}
+
 // custom specialization of std::hash can be injected in namespace std
 // This makes a node hashable to use for std::unordered_set<Node>
 namespace std {
 template <>
 struct hash<Node> {
   std::size_t operator()(Node const &node) const {
-    std::string s = std::to_string(node.quId) + std::to_string(node.refId);
-    std::size_t const h(std::hash<std::string>{}(s));
-    return h;
+    return nodeKeyHash(nodeKey(node.quId, node.refId));
   }
 };
 }  // namespace std
 
-typedef std::unordered_set<Node> NodeSet;
+/**
+ * @brief      Flat open-addressing map from the node coordinates (quId, refId)
+ *             to a value. Entries live in one array with linear probing, so
+ *             inserting does not allocate until the table grows and clear()
+ *             keeps the memory for the next use.
+ */
+template <typename Value>
+class NodeMap {
+ public:
+  struct Entry {
+    uint64_t key = 0;
+    Value value = Value();
+    int quId() const { return nodeKeyQuId(key); }
+    int refId() const { return nodeKeyRefId(key); }
+  };
+
+  class const_iterator {
+   public:
+    const_iterator(const NodeMap *map, size_t slot) : _map(map), _slot(slot) {
+      skipEmpty();
+    }
+    const Entry &operator*() const { return _map->_entries[_slot]; }
+    const Entry *operator->() const { return &_map->_entries[_slot]; }
+    const_iterator &operator++() {
+      ++_slot;
+      skipEmpty();
+      return *this;
+    }
+    bool operator==(const const_iterator &rhs) const {
+      return _slot == rhs._slot;
+    }
+    bool operator!=(const const_iterator &rhs) const {
+      return _slot != rhs._slot;
+    }
+
+   private:
+    void skipEmpty() {
+      while (_slot < _map->_used.size() && !_map->_used[_slot]) {
+        ++_slot;
+      }
+    }
+    const NodeMap *_map;
+    size_t _slot;
+  };
+
+  NodeMap() {}
+  explicit NodeMap(size_t capacity) { reserve(capacity); }
+
+  /** returns the value for (quId, refId), inserts a default one if missing **/
+  Value &operator()(int quId, int refId) {
+    uint64_t key = nodeKey(quId, refId);
+    if ((_size + 1) * 2 > _used.size()) {
+      rehash(std::max<size_t>(16, _used.size() * 2));
+    }
+    size_t slot = findSlot(key);
+    if (!_used[slot]) {
+      _used[slot] = 1;
+      _entries[slot].key = key;
+      _entries[slot].value = Value();
+      ++_size;
+    }
+    return _entries[slot].value;
+  }
+
+  /** @return pointer to the value or nullptr if (quId, refId) is not stored **/
+  Value *get(int quId, int refId) {
+    if (_size == 0) {
+      return nullptr;
+    }
+    size_t slot = findSlot(nodeKey(quId, refId));
+    return _used[slot] ? &_entries[slot].value : nullptr;
+  }
+  const Value *get(int quId, int refId) const {
+    return const_cast<NodeMap *>(this)->get(quId, refId);
+  }
+
+  const Value &at(int quId, int refId) const {
+    const Value *value = get(quId, refId);
+    if (!value) {
+      printf("[ERROR][NodeMap] No entry for node %d %d\n", quId, refId);
+      exit(EXIT_FAILURE);
+    }
+    return *value;
+  }
+
+  const_iterator find(int quId, int refId) const {
+    if (_size == 0) {
+      return end();
+    }
+    size_t slot = findSlot(nodeKey(quId, refId));
+    return _used[slot] ? const_iterator(this, slot) : end();
+  }
+  size_t count(int quId, int refId) const { return get(quId, refId) ? 1 : 0; }
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, _used.size()); }
+
+  size_t size() const { return _size; }
+  bool empty() const { return _size == 0; }
+  /** removes all entries, the capacity is kept **/
+  void clear() {
+    std::fill(_used.begin(), _used.end(), 0);
+    _size = 0;
+  }
+  /** makes room for n entries without growing **/
+  void reserve(size_t n) {
+    size_t capacity = 16;
+    while (capacity < 2 * n) {
+      capacity *= 2;
+    }
+    if (capacity > _used.size()) {
+      rehash(capacity);
+    }
+  }
+
+ private:
+  // capacity is a power of two and at least twice the size, so a free slot
+  // always terminates the probing
+  size_t findSlot(uint64_t key) const {
+    size_t mask = _used.size() - 1;
+    size_t slot = nodeKeyHash(key) & mask;
+    while (_used[slot] && _entries[slot].key != key) {
+      slot = (slot + 1) & mask;
+    }
+    return slot;
+  }
+
+  void rehash(size_t capacity) {
+    std::vector<Entry> entries(capacity);
+    std::vector<uint8_t> used(capacity, 0);
+    entries.swap(_entries);
+    used.swap(_used);
+    for (size_t i = 0; i < used.size(); ++i) {
+      if (used[i]) {
+        size_t slot = findSlot(entries[i].key);
+        _used[slot] = 1;
+        _entries[slot] = std::move(entries[i]);
+      }
+    }
+  }
+
+  std::vector<Entry> _entries;
+  std::vector<uint8_t> _used;
+  size_t _size = 0;
+};
+
+/**
+ * @brief      Set of nodes identified by their coordinates (quId, refId).
+ *             Keeps the interface of std::unordered_set<Node> that the search
+ *             uses, but stores the nodes in a flat NodeMap.
+ */
+class NodeSet {
+ public:
+  class const_iterator {
+   public:
+    explicit const_iterator(NodeMap<Node>::const_iterator it) : _it(it) {}
+    const Node &operator*() const { return _it->value; }
+    const Node *operator->() const { return &_it->value; }
+    const_iterator &operator++() {
+      ++_it;
+      return *this;
+    }
+    bool operator==(const const_iterator &rhs) const { return _it == rhs._it; }
+    bool operator!=(const const_iterator &rhs) const { return _it != rhs._it; }
+
+   private:
+    NodeMap<Node>::const_iterator _it;
+  };
+  using iterator = const_iterator;
+
+  NodeSet() {}
+  template <typename InputIt>
+  NodeSet(InputIt first, InputIt last) {
+    for (; first != last; ++first) {
+      insert(*first);
+    }
+  }
+
+  /** @return false if a node with the same coordinates is already stored **/
+  bool insert(const Node &node);
+  const_iterator find(const Node &node) const {
+    return const_iterator(_nodes.find(node.quId, node.refId));
+  }
+  size_t count(const Node &node) const {
+    return _nodes.count(node.quId, node.refId);
+  }
+
+  const_iterator begin() const { return const_iterator(_nodes.begin()); }
+  const_iterator end() const { return const_iterator(_nodes.end()); }
+  size_t size() const { return _nodes.size(); }
+  bool empty() const { return _nodes.empty(); }
+  void clear() { _nodes.clear(); }
+  void reserve(size_t n) { _nodes.reserve(n); }
+
+ private:
+  NodeMap<Node> _nodes;
+};
 
 #endif  // SRC_SUCCESSOR_MANAGER_NODE_H_
@@ -0,0 +1,142 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include "successor_manager/similar_places.h"
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <fstream>
+
+bool SimilarPlaces::isBinary(const std::string &filename) {
+  std::ifstream in(filename, std::ios::binary);
+  char magic[sizeof(kSimilarPlacesMagic)];
+  if (!in || !in.read(magic, sizeof(magic))) {
+    return false;
+  }
+  return memcmp(magic, kSimilarPlacesMagic, sizeof(magic)) == 0;
+}
+
+bool SimilarPlaces::load(const std::string &filename) {
+  if (isBinary(filename)) {
+    return loadBinary(filename);
+  }
+  return loadText(filename);
+}
+
+bool SimilarPlaces::loadBinary(const std::string &filename) {
+  std::ifstream in(filename, std::ios::binary);
+  if (!in) {
+    printf("[ERROR][SimilarPlaces] Cannot open file %s\n", filename.c_str());
+    return false;
+  }
+  SimilarPlacesHeader header;
+  if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+      memcmp(header.magic, kSimilarPlacesMagic, sizeof(header.magic)) != 0 ||
+      header.version != kSimilarPlacesVersion) {
+    printf("[ERROR][SimilarPlaces] %s is not a similar places file\n",
+           filename.c_str());
+    return false;
+  }
+  std::vector<uint64_t> offsets(header.places + 1);
+  std::vector<uint32_t> refIds(header.links);
+  in.read(reinterpret_cast<char *>(offsets.data()),
+          offsets.size() * sizeof(uint64_t));
+  in.read(reinterpret_cast<char *>(refIds.data()),
+          refIds.size() * sizeof(uint32_t));
+  if (!in || offsets.front() != 0 || offsets.back() != header.links ||
+      !std::is_sorted(offsets.begin(), offsets.end())) {
+    printf("[ERROR][SimilarPlaces] The file %s is corrupted\n",
+           filename.c_str());
+    return false;
+  }
+  _offsets.swap(offsets);
+  _refIds.swap(refIds);
+  return true;
+}
+
+bool SimilarPlaces::loadText(const std::string &filename) {
+  std::ifstream in(filename.c_str());
+  if (!in) {
+    printf("[ERROR][SimilarPlaces] Cannot open file %s\n", filename.c_str());
+    return false;
+  }
+  std::vector<std::pair<int, int> > pairs;
+  int ref_id_from, ref_id_to;
+  while (in >> ref_id_from >> ref_id_to) {
+    if (ref_id_from < 0 || ref_id_to < 0) {
+      printf("[ERROR][SimilarPlaces] Invalid pair %d %d in %s\n", ref_id_from,
+             ref_id_to, filename.c_str());
+      return false;
+    }
+    pairs.push_back(std::make_pair(ref_id_from, ref_id_to));
+  }
+  build(pairs);
+  return true;
+}
+
+void SimilarPlaces::build(const std::vector<std::pair<int, int> > &pairs) {
+  // both directions of every link, sorted by the source
+  std::vector<std::pair<uint32_t, uint32_t> > links;
+  links.reserve(2 * pairs.size());
+  for (const auto &pair : pairs) {
+    if (pair.first == pair.second) {
+      continue;
+    }
+    links.push_back(std::make_pair(pair.first, pair.second));
+    links.push_back(std::make_pair(pair.second, pair.first));
+  }
+  std::sort(links.begin(), links.end());
+  links.erase(std::unique(links.begin(), links.end()), links.end());
+
+  int places = links.empty() ? 0 : links.back().first + 1;
+  _offsets.assign(places + 1, 0);
+  _refIds.resize(links.size());
+  for (size_t i = 0; i < links.size(); ++i) {
+    _offsets[links[i].first + 1]++;
+    _refIds[i] = links[i].second;
+  }
+  for (int refId = 0; refId < places; ++refId) {
+    _offsets[refId + 1] += _offsets[refId];
+  }
+}
+
+bool SimilarPlaces::save(const std::string &filename) const {
+  std::ofstream out(filename, std::ios::binary);
+  if (!out) {
+    printf("[ERROR][SimilarPlaces] The file cannot be opened %s\n",
+           filename.c_str());
+    return false;
+  }
+  SimilarPlacesHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kSimilarPlacesMagic, sizeof(kSimilarPlacesMagic));
+  header.version = kSimilarPlacesVersion;
+  header.places = size();
+  header.links = _refIds.size();
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char *>(_offsets.data()),
+            _offsets.size() * sizeof(uint64_t));
+  out.write(reinterpret_cast<const char *>(_refIds.data()),
+            _refIds.size() * sizeof(uint32_t));
+  return static_cast<bool>(out);
+}
@@ -0,0 +1,91 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#ifndef SRC_SUCCESSOR_MANAGER_SIMILAR_PLACES_H_
+#define SRC_SUCCESSOR_MANAGER_SIMILAR_PLACES_H_
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Similar places layout (CSR): a 48 byte SimilarPlacesHeader followed by
+ * `places + 1` uint64 offsets and `links` uint32 refIds. The similar places
+ * of refId are the refIds in [offsets[refId], offsets[refId + 1]), sorted.
+ * Every link is stored in both directions.
+ */
+struct SimilarPlacesHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t reserved0;
+  uint64_t places;
+  uint64_t links;
+  uint64_t reserved[2];
+};
+
+const char kSimilarPlacesMagic[8] = {'V', 'P', 'R', 'S', 'I', 'M', 'P', '\0'};
+const uint32_t kSimilarPlacesVersion = 1;
+
+/**
+ * @brief      Graph of the similar places within the reference trajectory
+ * stored as compressed sparse rows.
+ */
+class SimilarPlaces {
+ public:
+  using Ptr = std::shared_ptr<SimilarPlaces>;
+  using ConstPtr = std::shared_ptr<const SimilarPlaces>;
+
+  static bool isBinary(const std::string &filename);
+
+  /** loads the binary format or the text format with "refId1 refId2" lines **/
+  bool load(const std::string &filename);
+  bool loadBinary(const std::string &filename);
+  bool loadText(const std::string &filename);
+  bool save(const std::string &filename) const;
+
+  /** builds the graph from the pairs of similar places **/
+  void build(const std::vector<std::pair<int, int> > &pairs);
+
+  /** number of refIds covered, the last one has similar places **/
+  int size() const { return static_cast<int>(_offsets.size()) - 1; }
+  size_t links() const { return _refIds.size(); }
+  bool empty() const { return _refIds.empty(); }
+
+  /** similar places of refId are [begin(refId), end(refId)) **/
+  const uint32_t *begin(int refId) const {
+    return _refIds.data() + (inRange(refId) ? _offsets[refId] : 0);
+  }
+  const uint32_t *end(int refId) const {
+    return _refIds.data() + (inRange(refId) ? _offsets[refId + 1] : 0);
+  }
+
+ private:
+  bool inRange(int refId) const { return refId >= 0 && refId < size(); }
+
+  std::vector<uint64_t> _offsets = std::vector<uint64_t>(1, 0);
+  std::vector<uint32_t> _refIds;
+};
+
+#endif  // SRC_SUCCESSOR_MANAGER_SIMILAR_PLACES_H_
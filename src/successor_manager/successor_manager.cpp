@@ -23,7 +23,6 @@
 
 #include "successor_manager/successor_manager.h"
 #include <algorithm>
-#include <fstream>
 // #include <unordered_set>
 using std::vector;
 
@@ -42,12 +41,27 @@ bool SuccessorManager::setFanOut(int value) {
   return true;
 }
 
+void SuccessorManager::setStepWindow(int minStep, int maxStep) {
+  if (minStep > maxStep) {
+    printf("[ERROR][SuccessorManager] Invalid step window %d %d\n", minStep,
+           maxStep);
+    return;
+  }
+  _stepWindow = true;
+  _minStep = minStep;
+  _maxStep = maxStep;
+}
+
+void SuccessorManager::resetStepWindow() { _stepWindow = false; }
+
 bool SuccessorManager::setDatabase(iDatabase::Ptr database) {
   if (!database) {
     printf("[ERROR][SuccessorManager] Invalid database.\n");
     return false;
   }
   _database = database;
+  // the precomputed costs belong to the previous database
+  _rowQuId = -1;
   return true;
 }
 
@@ -60,6 +74,39 @@ bool SuccessorManager::setRelocalizer(iRelocalizer::Ptr relocalizer) {
   return true;
 }
 
+bool SuccessorManager::setNumThreads(int threads) {
+  if (threads < 1) {
+    printf("[ERROR][SuccessorManager] Invalid number of threads %d\n",
+           threads);
+    return false;
+  }
+  _threadPool = threads > 1 ? ThreadPool::Ptr(new ThreadPool(threads))
+                            : nullptr;
+  return true;
+}
+
+void SuccessorManager::setSearchFocus(int quId, int refId) {
+  // successors of the nodes within one fan out of refId
+  _database->setSearchFocus(quId, refId, 2 * _fan_out);
+  // the search may also jump to the places similar to refId
+  if (_simPlaces.begin(refId) == _simPlaces.end(refId)) {
+    return;
+  }
+  _ranges.clear();
+  for (const uint32_t *sim = _simPlaces.begin(refId);
+       sim != _simPlaces.end(refId); ++sim) {
+    addFanOutRange(*sim);
+  }
+  mergeRanges(&_ranges);
+  _focusRefIds.clear();
+  for (const auto &range : _ranges) {
+    for (int id = range.first; id <= range.second; ++id) {
+      _focusRefIds.push_back(id);
+    }
+  }
+  _database->prefetchRefs(_focusRefIds);
+}
+
 /**
  * @brief      Sets the similar places.
  *
@@ -68,20 +115,13 @@ bool SuccessorManager::setRelocalizer(iRelocalizer::Ptr relocalizer) {
  * @return     { description_of_the_return_value }
  */
 bool SuccessorManager::setSimilarPlaces(const std::string &filename) {
-  std::ifstream in(filename.c_str());
-  if (!in) {
-    printf("[ERROR][SuccessorManager] Cannot open file %s\n", filename.c_str());
+  if (!_simPlaces.load(filename)) {
+    printf("[ERROR][SuccessorManager] Cannot read file %s\n", filename.c_str());
     printf("[======================= Similar places were not set\n");
     return false;
   }
-  while (!in.eof()) {
-    int ref_id_from, ref_id_to;
-    in >> ref_id_from >> ref_id_to;
-    _sameRefPlaces[ref_id_from].insert(ref_id_to);
-    _sameRefPlaces[ref_id_to].insert(ref_id_from);
-  }
-  in.close();
-  printf("[INFO][SuccessorManager] Similar Places were set\n");
+  printf("[INFO][SuccessorManager] Similar Places were set: %lu links\n",
+         _simPlaces.links());
   return true;
 }
 
@@ -101,8 +141,9 @@ bool SuccessorManager::isReady() const {
  *
  * @return     The successors.
  */
-std::unordered_set<Node> SuccessorManager::getSuccessors(const Node &node) {
-  _successors.clear();
+void SuccessorManager::getSuccessors(const Node &node,
+                                     std::vector<Node> *successors) {
+  successors->clear();
 
   if (node == SOURCE_NODE) {
     printf(
@@ -116,57 +157,153 @@ std::unordered_set<Node> SuccessorManager::getSuccessors(const Node &node) {
            node.refId);
     exit(EXIT_FAILURE);
   }
-  // check for regular succcessor
-  getSuccessorFanOut(node.quId, node.refId);
-  // check for additional successors based on similar places
-  if (!_sameRefPlaces.empty()) {
-    getSuccessorsSimPlaces(node.quId, node.refId);
+  // the windows around similar places may overlap, every child is
+  // evaluated once
+  int succ_qu_id = node.quId + 1;
+  _refIds.clear();
+  for (const auto &range : successorRanges(node.refId)) {
+    for (int succ_ref = range.first; succ_ref <= range.second; ++succ_ref) {
+      _refIds.push_back(succ_ref);
+    }
+  }
+  lookupCosts(succ_qu_id);
+  for (size_t i = 0; i < _refIds.size(); ++i) {
+    successors->push_back(Node(succ_qu_id, _refIds[i], _costs[i]));
+  }
+  // printf("Successors were computed %d \n", successors->size());
+}
+
+void SuccessorManager::lookupCosts(int quId) {
+  _costs.resize(_refIds.size());
+  if (quId != _rowQuId) {
+    _database->getCosts(quId, _refIds.data(), _refIds.size(), _costs.data());
+    return;
+  }
+  _missIds.clear();
+  for (size_t i = 0; i < _refIds.size(); ++i) {
+    size_t pos = _refIds[i] - _rowFirstRefId;
+    _costs[i] = pos < _rowCosts.size() ? _rowCosts[pos] : -1.0;
+    if (_costs[i] < 0) {
+      _missIds.push_back(_refIds[i]);
+    }
+  }
+  if (_missIds.empty()) {
+    return;
+  }
+  _missCosts.resize(_missIds.size());
+  _database->getCosts(quId, _missIds.data(), _missIds.size(),
+                      _missCosts.data());
+  size_t miss = 0;
+  for (size_t i = 0; i < _refIds.size(); ++i) {
+    if (_costs[i] < 0) {
+      _costs[i] = _missCosts[miss++];
+    }
+  }
+}
+
+void SuccessorManager::computeRowChunk(int chunk) {
+  int first = chunk * kRowChunkSize;
+  int size = _rowRefIds.size() - first;
+  if (size > kRowChunkSize) {
+    size = kRowChunkSize;
+  }
+  _database->getCosts(_rowQuId, _rowRefIds.data() + first, size,
+                      _rowBatchCosts.data() + first);
+}
+
+int SuccessorManager::precomputeSuccessors(const std::vector<Node> &parents) {
+  _rowQuId = -1;
+  if (parents.empty() || !_database->isThreadSafe()) {
+    return 0;
+  }
+  // union of the successor ranges of all the parents
+  _rowRanges.clear();
+  for (const Node &parent : parents) {
+    const auto &ranges = successorRanges(parent.refId);
+    _rowRanges.insert(_rowRanges.end(), ranges.begin(), ranges.end());
+  }
+  mergeRanges(&_rowRanges);
+  if (_rowRanges.empty()) {
+    return 0;
+  }
+  _rowRefIds.clear();
+  for (const auto &range : _rowRanges) {
+    for (int refId = range.first; refId <= range.second; ++refId) {
+      _rowRefIds.push_back(refId);
+    }
+  }
+
+  int count = _rowRefIds.size();
+  _rowBatchCosts.resize(count);
+  int chunks = (count + kRowChunkSize - 1) / kRowChunkSize;
+  _rowQuId = parents.front().quId + 1;
+  if (_threadPool) {
+    _threadPool->parallelFor(chunks,
+                             [this](int chunk) { computeRowChunk(chunk); });
   } else {
-    printf("[DEBUG] Similar Places were not set\n");
+    for (int chunk = 0; chunk < chunks; ++chunk) {
+      computeRowChunk(chunk);
+    }
   }
-  // printf("Successors were computed %d \n", _successors.size());
-  return _successors;
+
+  _rowFirstRefId = _rowRefIds.front();
+  _rowCosts.assign(_rowRefIds.back() - _rowFirstRefId + 1, -1.0);
+  for (int i = 0; i < count; ++i) {
+    _rowCosts[_rowRefIds[i] - _rowFirstRefId] = _rowBatchCosts[i];
+  }
+  return count;
+}
+
+const std::vector<std::pair<int, int> > &SuccessorManager::successorRanges(
+    int refId) {
+  _ranges.clear();
+  addFanOutRange(refId);
+  for (const uint32_t *sim = _simPlaces.begin(refId);
+       sim != _simPlaces.end(refId); ++sim) {
+    addFanOutRange(*sim);
+  }
+  mergeRanges(&_ranges);
+  return _ranges;
 }
 
 /**
- * @brief      Gets succesors based on fanout for node (quId, refId) from
- * database. Select followers based on _fanOut;
- *
- * @param[in]  quId   query index
- * @param[in]  refId  reference index
- *
+ * @brief      Adds the window of successors based on fanout for refId and
+ * the step window, if set. The window is clipped to the reference trajectory.
  */
-void SuccessorManager::getSuccessorFanOut(int quId, int refId) {
-  int left_ref = std::max(refId - _fan_out, 0);
-  int right_ref = std::min(refId + _fan_out, _database->refSize() - 1);
-  // printf("[DEBUG] For parent %d %d children borders are:\n", quId, refId);
+void SuccessorManager::addFanOutRange(int refId) {
+  int minStep = -_fan_out;
+  int maxStep = _fan_out;
+  if (_stepWindow) {
+    // the window may be predicted beyond the fan out, it is clipped to its
+    // closest border then
+    minStep = std::min(std::max(_minStep, -_fan_out), _fan_out);
+    maxStep = std::min(std::max(_maxStep, -_fan_out), _fan_out);
+  }
+  int left_ref = std::max(refId + minStep, 0);
+  int right_ref = std::min(refId + maxStep, _database->refSize() - 1);
   // printf("[DEBUG] Left: %d, right: %d\n", left_ref, right_ref);
-
-  for (int succ_ref = left_ref; succ_ref <= right_ref; ++succ_ref) {
-    Node succ;
-    double succ_cost = _database->getCost(quId + 1, succ_ref);
-    succ.set(quId + 1, succ_ref, succ_cost);
-    _successors.insert(succ);
+  if (left_ref <= right_ref) {
+    _ranges.push_back(std::make_pair(left_ref, right_ref));
   }
 }
 
-/**
- * @brief      Gets the successors if there are similar places.
- *
- * @param[in]  quId  query index
- */
-void SuccessorManager::getSuccessorsSimPlaces(int quId, int refId) {
-  auto found = _sameRefPlaces.find(refId);
-  std::set<int> simPlaces;
-  if (found == _sameRefPlaces.end()) {
-    // no similar places for the place refId
-    // do not update _successors
-  } else {
-    simPlaces = _sameRefPlaces[refId];
-    for (int simPlace : simPlaces) {
-      getSuccessorFanOut(quId, simPlace);
+/** sorts the ranges and merges the overlapping and adjacent ones in place **/
+void SuccessorManager::mergeRanges(
+    std::vector<std::pair<int, int> > *ranges) {
+  if (ranges->empty()) {
+    return;
+  }
+  std::vector<std::pair<int, int> > &r = *ranges;
+  std::sort(r.begin(), r.end());
+  size_t last = 0;
+  for (size_t i = 1; i < r.size(); ++i) {
+    if (r[i].first <= r[last].second + 1) {
+      r[last].second = std::max(r[last].second, r[i].second);
+    } else {
+      r[++last] = r[i];
     }
   }
+  r.resize(last + 1);
 }
 
 /**
@@ -178,9 +315,9 @@ void SuccessorManager::getSuccessorsSimPlaces(int quId, int refId) {
  *
  * @return     The successors if lost.
  */
-std::unordered_set<Node> SuccessorManager::getSuccessorsIfLost(
-    const Node &node) {
-  _successors.clear();
+void SuccessorManager::getSuccessorsIfLost(const Node &node,
+                                           std::vector<Node> *successors) {
+  successors->clear();
   if (!_relocalizer) {
     printf("[ERROR][SuccessorManager] Relocalizer is not set\n");
     exit(EXIT_FAILURE);
@@ -193,25 +330,37 @@ std::unordered_set<Node> SuccessorManager::getSuccessorsIfLost(
     // no similar places found
     printf("[DEBUG] No similar images found\n");
     // propagate one node as if moving
-    Node succ;
     double succ_cost = _database->getCost(succ_qu_id, node.refId);
-    succ.set(succ_qu_id, node.refId, succ_cost);
-    _successors.insert(succ);
+    successors->push_back(Node(succ_qu_id, node.refId, succ_cost));
   } else {
     // some similar places found
     // printf("[DEBUG] Similar images found %lu\n", candidates.size());
-    for (const auto &candId : candidates) {
-      Node succ;
-      double succ_cost = _database->getCost(succ_qu_id, candId);
-      succ.set(succ_qu_id, candId, succ_cost);
-      _successors.insert(succ);
-      succ.print();
+    _costs.resize(candidates.size());
+    _database->getCosts(succ_qu_id, candidates.data(), candidates.size(),
+                        _costs.data());
+    for (size_t i = 0; i < candidates.size(); ++i) {
+      successors->push_back(Node(succ_qu_id, candidates[i], _costs[i]));
+      successors->back().print();
     }
+    removeDuplicates(successors);
   }
 
-  // for(const auto&n :_successors){
+  // for(const auto&n : *successors){
   //   n.print();
   // }
-  // printf("Successor manager reported %lu candidates\n", _successors.size());
-  return _successors;
+  // printf("Successor manager reported %lu candidates\n", successors->size());
+}
+
+/**
+ * @brief      Sorts the successors by refId and drops the duplicates. All the
+ * successors belong to the same query image, so the duplicates carry the same
+ * cost. Sorting in place does not allocate, unlike hashing into a set.
+ */
+void SuccessorManager::removeDuplicates(std::vector<Node> *successors) {
+  std::sort(successors->begin(), successors->end(),
+            [](const Node &lhs, const Node &rhs) {
+              return lhs.refId < rhs.refId;
+            });
+  auto last = std::unique(successors->begin(), successors->end());
+  successors->erase(last, successors->end());
 }
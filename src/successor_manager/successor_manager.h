@@ -25,15 +25,15 @@
 #define SRC_SUCCESSOR_MANAGER_SUCCESSOR_MANAGER_H_
 
 #include <memory>
-#include <set>
 #include <string>
-#include <unordered_map>
-#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "database/idatabase.h"
 #include "relocalizers/irelocalizer.h"
 #include "successor_manager/node.h"
+#include "successor_manager/similar_places.h"
+#include "tools/thread_pool/thread_pool.h"
 
 
 /**
@@ -56,12 +56,27 @@ class SuccessorManager {
    * @return     checks if input is valid
    */
   bool setFanOut(int value);
+  /**
+   * @brief      Restricts the successors of refId to the refs
+   * [refId + minStep, refId + maxStep]. The steps are clipped to the fan
+   * out. Used to follow the estimated speed of the camera.
+   */
+  void setStepWindow(int minStep, int maxStep);
+  /** successors cover the whole fan out again **/
+  void resetStepWindow();
+  bool hasStepWindow() const { return _stepWindow; }
   bool setDatabase(iDatabase::Ptr database);
   bool setRelocalizer(iRelocalizer::Ptr relocalizer);
+  /**
+   * @brief      Sets the number of threads that compute the costs in
+   * precomputeSuccessors. 1 computes them on the calling thread.
+   */
+  bool setNumThreads(int threads);
   /**
    * @brief      Introduces the notion of similar places within the reference trajectory. The ids of the similar places should be pre-computed.
    *
-   * @param[in]  filename  The filename
+   * @param[in]  filename  The binary similar places file or the text file
+   * with "refId1 refId2" lines
    *
    * @return     { description_of_the_return_value }
    */
@@ -69,24 +84,79 @@ class SuccessorManager {
 
   bool isReady() const;
 
-  std::unordered_set<Node> getSuccessors(const Node &node);
-  std::unordered_set<Node> getSuccessorsIfLost(const Node &node);
+  /**
+   * @brief      Writes the successors of node into a caller-owned buffer. The
+   *             buffer is cleared first and keeps its capacity, so repeated
+   *             expansions do not allocate. Every successor appears once and
+   *             they are sorted by refId.
+   */
+  void getSuccessors(const Node &node, std::vector<Node> *successors);
+  void getSuccessorsIfLost(const Node &node, std::vector<Node> *successors);
+
+  /**
+   * @brief      Computes the costs of all the successors of the parents ahead
+   * in parallel. All the parents belong to the same query image. The
+   * following getSuccessors calls for these parents take the costs from
+   * here, so their results stay the same. Does nothing, if the database is
+   * not thread safe.
+   *
+   * @return     number of costs computed ahead
+   */
+  int precomputeSuccessors(const std::vector<Node> &parents);
+
+  /**
+   * @brief      Tells the database that the search continues around refId
+   * for the query quId. The window covers the reachable successors.
+   */
+  void setSearchFocus(int quId, int refId);
 
-  void getSuccessorFanOut(int quId, int refId);
-  void getSuccessorsSimPlaces(int quId, int refId);
+  /**
+   * @brief      Collects the fan out windows of refId and of its similar
+   * places, merged into disjoint sorted ranges [first, second].
+   */
+  const std::vector<std::pair<int, int> > &successorRanges(int refId);
 
  protected:
   iDatabase::Ptr _database = nullptr;
   int _fan_out = 0;
+  bool _stepWindow = false;
+  int _minStep = 0;
+  int _maxStep = 0;
 
  private:
-  // current successors
-  std::unordered_set<Node> _successors;
+  void addFanOutRange(int refId);
+  /** fills _costs for _refIds of quId, uses the precomputed costs if any **/
+  void lookupCosts(int quId);
+  void computeRowChunk(int chunk);
+  static void mergeRanges(std::vector<std::pair<int, int> > *ranges);
+  static void removeDuplicates(std::vector<Node> *successors);
+
   /**
-   * for refId gives the vector of refIds, that represent similar places
+   * for refId gives the refIds, that represent similar places
    */
-  std::unordered_map<int, std::set<int> > _sameRefPlaces;
+  SimilarPlaces _simPlaces;
+
   iRelocalizer::Ptr _relocalizer = nullptr;
+  // reused for the batched cost requests
+  std::vector<int> _refIds;
+  std::vector<double> _costs;
+  std::vector<int> _focusRefIds;
+  std::vector<std::pair<int, int> > _ranges;
+
+  // refs per cost request of precomputeSuccessors
+  static const int kRowChunkSize = 32;
+  ThreadPool::Ptr _threadPool = nullptr;
+  // costs of the query _rowQuId for the refs [_rowFirstRefId, ...),
+  // negative if not precomputed
+  int _rowQuId = -1;
+  int _rowFirstRefId = 0;
+  std::vector<double> _rowCosts;
+  std::vector<std::pair<int, int> > _rowRanges;
+  std::vector<int> _rowRefIds;
+  std::vector<double> _rowBatchCosts;
+  // costs that were not precomputed
+  std::vector<int> _missIds;
+  std::vector<double> _missCosts;
 };
 
 #endif  // SRC_SUCCESSOR_MANAGER_SUCCESSOR_MANAGER_H_
@@ -84,6 +84,26 @@ bool ConfigParser::parse(const std::string &iniFile) {
         ss >> bufferSize;
         continue;
       }
+      if (header == "bufferMemory") {
+        ss >> header;  // reads "="
+        ss >> bufferMemory;
+        continue;
+      }
+      if (header == "prefetch") {
+        ss >> header;  // reads "="
+        ss >> prefetch;
+        continue;
+      }
+      if (header == "adaptiveFanOut") {
+        ss >> header;  // reads "="
+        ss >> adaptiveFanOut;
+        continue;
+      }
+      if (header == "expansionThreads") {
+        ss >> header;  // reads "="
+        ss >> expansionThreads;
+        continue;
+      }
 
       if (header == "path2quImg") {
         ss >> header;  // reads "="
@@ -111,6 +131,31 @@ bool ConfigParser::parse(const std::string &iniFile) {
         ss >> costOutputName;
         continue;
       }
+      if (header == "costType") {
+        ss >> header;  // reads "="
+        ss >> costType;
+        continue;
+      }
+      if (header == "costScaling") {
+        ss >> header;  // reads "="
+        ss >> costScaling;
+        continue;
+      }
+      if (header == "sparseThreshold") {
+        ss >> header;  // reads "="
+        ss >> sparseThreshold;
+        continue;
+      }
+      if (header == "sparseFallbackCost") {
+        ss >> header;  // reads "="
+        ss >> sparseFallbackCost;
+        continue;
+      }
+      if (header == "costCache") {
+        ss >> header;  // reads "="
+        ss >> costCache;
+        continue;
+      }
       if (header == "simPlaces") {
         ss >> header;  // reads "="
         ss >> simPlaces;
@@ -135,10 +180,19 @@ void ConfigParser::print() const {
   printf("== Path2reference images: %s\n", path2refImg.c_str());
   printf("== Image extension: %s\n", imgExt.c_str());
   printf("== Buffer size: %d\n", bufferSize);
+  printf("== Buffer memory: %d MB\n", bufferMemory);
+  printf("== Prefetch: %d\n", prefetch);
+  printf("== Expansion threads: %d\n", expansionThreads);
+  printf("== Adaptive fan out: %d\n", adaptiveFanOut);
 
   printf("== CostMatrix: %s\n", costMatrix.c_str());
   printf("== costOutputName: %s\n", costOutputName.c_str());
+  printf("== costType: %s\n", costType.c_str());
+  printf("== costScaling: %s\n", costScaling.c_str());
+  printf("== sparseThreshold: %3.4f\n", sparseThreshold);
+  printf("== sparseFallbackCost: %3.4f\n", sparseFallbackCost);
   printf("== simPlaces: %s\n", simPlaces.c_str());
+  printf("== costCache: %s\n", costCache.c_str());
 }
 
 bool ConfigParser::parseYaml(const std::string &yamlFile) {
@@ -181,12 +235,39 @@ bool ConfigParser::parseYaml(const std::string &yamlFile) {
   if (config["bufferSize"]) {
     bufferSize = config["bufferSize"].as<int>();
   }
+  if (config["bufferMemory"]) {
+    bufferMemory = config["bufferMemory"].as<int>();
+  }
+  if (config["prefetch"]) {
+    prefetch = config["prefetch"].as<int>();
+  }
+  if (config["adaptiveFanOut"]) {
+    adaptiveFanOut = config["adaptiveFanOut"].as<int>();
+  }
+  if (config["expansionThreads"]) {
+    expansionThreads = config["expansionThreads"].as<int>();
+  }
   if (config["costMatrix"]) {
     costMatrix = config["costMatrix"].as<std::string>();
   }
   if (config["costOutputName"]) {
     costOutputName = config["costOutputName"].as<std::string>();
   }
+  if (config["costType"]) {
+    costType = config["costType"].as<std::string>();
+  }
+  if (config["costScaling"]) {
+    costScaling = config["costScaling"].as<std::string>();
+  }
+  if (config["sparseThreshold"]) {
+    sparseThreshold = config["sparseThreshold"].as<double>();
+  }
+  if (config["sparseFallbackCost"]) {
+    sparseFallbackCost = config["sparseFallbackCost"].as<double>();
+  }
+  if (config["costCache"]) {
+    costCache = config["costCache"].as<std::string>();
+  }
   if (config["simPlaces"]) {
     simPlaces = config["simPlaces"].as<std::string>();
   }
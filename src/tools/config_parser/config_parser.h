@@ -43,15 +43,24 @@ class ConfigParser {
   std::string imgExt = "";
   std::string costMatrix = "";
   std::string costOutputName = "";
+  std::string costType = "float32";
+  std::string costScaling = "row";
   std::string simPlaces = "";
   std::string hashTable = "";
+  std::string costCache = "";
   std::string pathFile = "matches.txt";
 
   int querySize = -1;
   int fanOut = -1;
   int bufferSize = -1;
+  int bufferMemory = 0;
+  int prefetch = 0;
+  int expansionThreads = 1;
+  int adaptiveFanOut = 0;
   double nonMatchCost = -1.0;
   double expansionRate = -1.0;
+  double sparseThreshold = 0.0;
+  double sparseFallbackCost = -1.0;
 };
 
 /*! \var std::string ConfigParser::path2qu
@@ -78,11 +87,33 @@ class ConfigParser {
    matching.
 */
 
+/*! \var std::string ConfigParser::costType
+    \brief type of the values in the binary cost matrix: "float32",
+   "float16", "uint8" or "uint16".
+*/
+/*! \var std::string ConfigParser::costScaling
+    \brief quantization range of the "uint8" and "uint16" cost matrices:
+   "row" - every row has its own scale, "global" - one scale for the matrix.
+*/
+
+/*! \var double ConfigParser::sparseThreshold
+    \brief smallest similarity stored in a sparse (.csr) cost matrix.
+*/
+/*! \var double ConfigParser::sparseFallbackCost
+    \brief cost of the cells missing in a sparse cost matrix. If not
+   positive, 1 / sparseThreshold is used.
+*/
+
 /*! \var std::string ConfigParser::hashTable
     \brief stores the name of the file to read hash table from.
    matching.
 */
 
+/*! \var std::string ConfigParser::costCache
+    \brief stores the name of the file, where the computed costs are kept for
+   the next runs on the same features. Empty - no cost cache.
+*/
+
 /*! \var int ConfigParser::querySize
     \brief stores number of query images.
 */
@@ -96,6 +127,23 @@ class ConfigParser {
     \brief number of image features to be cached. Speeds up the computation for
    feature_based matching. Irrelevant for cost_matrix_based matching.
 */
+/*! \var int ConfigParser::bufferMemory
+    \brief memory limit of each feature buffer in megabytes. 0 - no limit.
+   The least recently used features are dropped first.
+*/
+/*! \var int ConfigParser::prefetch
+    \brief number of query features loaded ahead on a background thread,
+   together with the reference features around the current match. 0 - no
+   prefetching.
+*/
+/*! \var int ConfigParser::adaptiveFanOut
+    \brief margin in refs around the estimated reference step, in which the
+   successors are searched. 0 - the whole fan out is searched.
+*/
+/*! \var int ConfigParser::expansionThreads
+    \brief number of threads that compute the successor costs of a query
+   image in one batch. 1 - the nodes are expanded one by one.
+*/
 /*! \var double ConfigParser::nonMatchCost
     \brief maximum boundary for the matching cost to still be considered as a
    match. For example, if `nonMatchCost = 5.0` then every smaller cost should
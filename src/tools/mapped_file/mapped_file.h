@@ -0,0 +1,65 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#ifndef SRC_TOOLS_MAPPED_FILE_MAPPED_FILE_H_
+#define SRC_TOOLS_MAPPED_FILE_MAPPED_FILE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <memory>
+#include <string>
+
+/**
+ * @brief      Read-only memory mapping of a whole file. The mapping is
+ * released when the object is destroyed.
+ */
+class MappedFile {
+ public:
+  using Ptr = std::shared_ptr<MappedFile>;
+  using ConstPtr = std::shared_ptr<const MappedFile>;
+
+  MappedFile() {}
+  ~MappedFile();
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  /**
+   * @brief      Maps the file into memory.
+   *
+   * @param[in]  filename  The filename
+   *
+   * @return     false if the file cannot be opened or mapped.
+   */
+  bool open(const std::string &filename);
+  void close();
+
+  bool isOpen() const { return _data != nullptr; }
+  const uint8_t *data() const { return _data; }
+  size_t size() const { return _size; }
+
+ private:
+  uint8_t *_data = nullptr;
+  size_t _size = 0;
+};
+
+#endif  // SRC_TOOLS_MAPPED_FILE_MAPPED_FILE_H_
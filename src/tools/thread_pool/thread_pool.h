@@ -0,0 +1,80 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#ifndef SRC_TOOLS_THREAD_POOL_THREAD_POOL_H_
+#define SRC_TOOLS_THREAD_POOL_THREAD_POOL_H_
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief      Fixed set of worker threads that run the iterations of a loop.
+ * The threads are started once and wait between the loops.
+ */
+class ThreadPool {
+ public:
+  using Ptr = std::shared_ptr<ThreadPool>;
+  using ConstPtr = std::shared_ptr<const ThreadPool>;
+  using Task = std::function<void(int)>;
+
+  /** @param[in]  threads  number of threads including the calling one **/
+  explicit ThreadPool(int threads);
+  ~ThreadPool();
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  int size() const { return _workers.size() + 1; }
+
+  /**
+   * @brief      Runs task(i) for every i in [0, count) and returns when all
+   * of them are done. The calling thread runs iterations as well. Only one
+   * thread may call it at a time.
+   */
+  void parallelFor(int count, const Task &task);
+
+ private:
+  void run();
+  /** runs the iterations that are not taken yet **/
+  void work();
+
+  std::vector<std::thread> _workers;
+  std::mutex _mutex;
+  // signals a new loop or stopping
+  std::condition_variable _started;
+  // signals that the workers are done with the loop
+  std::condition_variable _finished;
+  const Task *_task = nullptr;
+  int _count = 0;
+  std::atomic<int> _next{0};
+  int _busyWorkers = 0;
+  uint64_t _generation = 0;
+  bool _stop = false;
+};
+
+#endif  // SRC_TOOLS_THREAD_POOL_THREAD_POOL_H_
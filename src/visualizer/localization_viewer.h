@@ -70,7 +70,7 @@ class LocalizationViewer : public QGraphicsView {
 
  public slots:
   void receivedPath(const std::vector<PathElement> &path);
-  void receivedFrontier(const std::unordered_set<Node> &frontier);
+  void receivedFrontier(const NodeSet &frontier);
   void receivedExpansion(NodeSet expansion);
   void receivedLocalizationFinished();
 
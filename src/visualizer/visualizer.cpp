@@ -54,16 +54,16 @@ bool Visualizer::setLocalizationViewer(LocalizationViewer *locViewer) {
   show();
 
   qRegisterMetaType<std::vector<PathElement> >("Path");
-  qRegisterMetaType<std::unordered_set<Node>>("Frontier");
+  qRegisterMetaType<NodeSet>("Frontier");
   qRegisterMetaType<NodeSet>("Expansion");
 
   QObject::connect(
       this, SIGNAL(drawPath_signal(const std::vector<PathElement> &)),
       _locViewer, SLOT(receivedPath(const std::vector<PathElement> &)));
 
-  QObject::connect(this, SIGNAL(drawFrontier_signal(const std::unordered_set<Node> &)),
+  QObject::connect(this, SIGNAL(drawFrontier_signal(const NodeSet &)),
                    _locViewer,
-                   SLOT(receivedFrontier(const std::unordered_set<Node> &)));
+                   SLOT(receivedFrontier(const NodeSet &)));
   QObject::connect(this, SIGNAL(drawExpansion_signal(NodeSet)),
                    _locViewer, SLOT(receivedExpansion(NodeSet)));
   printf("[INFO][Visualizer] Localization Viewer is set\n");
@@ -55,7 +55,7 @@ class Visualizer : public QWidget, public iLocVisualizer {
   bool setLocalizationViewer(LocalizationViewer *loc_viewer);
 
   void drawPath(const std::vector<PathElement> &path) override;
-  void drawFrontier(const std::unordered_set<Node> &frontier) override;
+  void drawFrontier(const NodeSet &frontier) override;
   void drawExpansion(NodeSet expansion) override;
   void processFinished() override {}
 
@@ -64,7 +64,7 @@ class Visualizer : public QWidget, public iLocVisualizer {
  signals:
   void drawPath_signal(const std::vector<PathElement> &path);
   void showPathImage(int quId, int refId, bool hidden);
-  void drawFrontier_signal(const std::unordered_set<Node> &frontier);
+  void drawFrontier_signal(const NodeSet &frontier);
   void drawExpansion_signal(const NodeSet &expansion);
 
  private:
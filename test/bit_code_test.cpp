@@ -0,0 +1,73 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include <vector>
+#include "features/bit_code.h"
+#include "gtest/gtest.h"
+
+TEST(BitCode, fromVector) {
+  std::vector<bool> bits(130, false);
+  bits[0] = bits[5] = bits[63] = bits[64] = bits[129] = true;
+  BitCode code = bits;
+  EXPECT_EQ(code.size(), 130);
+  EXPECT_EQ(code.numWords(), 3);
+  EXPECT_EQ(code.count(), 5);
+  for (size_t i = 0; i < bits.size(); ++i) {
+    EXPECT_EQ(code[i], bits[i]);
+  }
+  EXPECT_EQ(code.toVector(), bits);
+
+  std::vector<size_t> setBits;
+  code.forEachSetBit([&setBits](size_t i) { setBits.push_back(i); });
+  std::vector<size_t> expected = {0, 5, 63, 64, 129};
+  EXPECT_EQ(setBits, expected);
+}
+
+TEST(BitCode, setAndAssign) {
+  BitCode code(70, true);
+  EXPECT_EQ(code.count(), 70);
+  // unused bits of the last word stay 0
+  EXPECT_EQ(code.words()[1], (uint64_t(1) << 6) - 1);
+  code.set(3, false);
+  code.set(69, false);
+  EXPECT_FALSE(code[3]);
+  EXPECT_FALSE(code[69]);
+  EXPECT_EQ(code.count(), 68);
+
+  BitCode copy;
+  copy.assignWords(code.words(), code.size());
+  EXPECT_TRUE(copy == code);
+  code.clear();
+  EXPECT_TRUE(code.empty());
+  EXPECT_TRUE(copy != code);
+}
+
+TEST(BitCode, distances) {
+  BitCode lhs = std::vector<bool>{1, 1, 1, 0, 0, 0, 0, 0};
+  BitCode rhs = std::vector<bool>{1, 1, 0, 0, 0, 1, 0, 1};
+  EXPECT_EQ(hammingDistance(lhs, rhs), 3);
+  EXPECT_EQ(hammingDistance(lhs, lhs), 0);
+  EXPECT_NEAR(jaccardSimilarity(lhs, rhs), 2.0 / 5.0, 1e-12);
+  BitCode empty(8);
+  EXPECT_NEAR(jaccardSimilarity(empty, empty), 1.0, 1e-12);
+}
@@ -0,0 +1,78 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include <string>
+#include <vector>
+#include "database/list_dir.h"
+#include "database/online_database.h"
+#include "features/cnn_feature.h"
+#include "features/cnn_feature_sparse.h"
+#include "gtest/gtest.h"
+
+TEST(CnnFeatureSparse, sameAsDense) {
+  std::vector<std::string> names =
+      listDir("../test/test_data/ref_features/");
+  ASSERT_FALSE(names.empty());
+  CnnFeature::Ptr denseQuery = std::make_shared<CnnFeature>();
+  CnnFeatureSparse::Ptr sparseQuery = std::make_shared<CnnFeatureSparse>();
+  std::string queryName = "../test/test_data/query_features/image_0-feature.txt";
+  denseQuery->loadFromFile(queryName);
+  sparseQuery->loadFromFile(queryName);
+
+  for (const std::string &name : names) {
+    CnnFeature::Ptr dense = std::make_shared<CnnFeature>();
+    CnnFeatureSparse::Ptr sparse = std::make_shared<CnnFeatureSparse>();
+    dense->loadFromFile(name);
+    sparse->loadFromFile(name);
+    ASSERT_EQ(sparse->size(), dense->dim.size());
+    EXPECT_LT(sparse->nnz(), dense->dim.size() / 4);
+    EXPECT_TRUE(sparse->bits == dense->bits);
+    EXPECT_NEAR(sparseQuery->computeSimilarityScore(sparse),
+                denseQuery->computeSimilarityScore(dense), 1e-09);
+  }
+}
+
+TEST(CnnFeatureSparse, sparseDot) {
+  CnnFeatureSparse::Ptr lhs = std::make_shared<CnnFeatureSparse>();
+  CnnFeatureSparse::Ptr rhs = std::make_shared<CnnFeatureSparse>();
+  lhs->setValues({0.0, 1.0, 0.0, 2.0, 3.0, 0.0});
+  rhs->setValues({4.0, 1.0, 5.0, 0.0, 2.0, 0.0});
+  EXPECT_EQ(lhs->nnz(), 3);
+  EXPECT_EQ(rhs->nnz(), 4);
+  EXPECT_DOUBLE_EQ(sparseDot(lhs->indices.data(), lhs->values.data(),
+                             lhs->nnz(), rhs->indices.data(),
+                             rhs->values.data(), rhs->nnz()),
+                   7.0);
+  EXPECT_NEAR(lhs->computeSimilarityScore(lhs), 1.0, 1e-12);
+}
+
+TEST(CnnFeatureSparse, onlineDatabase) {
+  OnlineDatabase database;
+  database.setRefFeaturesFolder("../test/test_data/ref_features/");
+  database.setQuFeaturesFolder("../test/test_data/query_features/");
+  database.setFeatureType(FeatureFactory::FeatureType::Cnn_Feature_Sparse);
+  EXPECT_NEAR(database.getCost(0, 0), 6.68232, 1e-05);
+  EXPECT_NEAR(database.getCost(0, 2), 9.22337, 1e-05);
+  EXPECT_NEAR(database.getCost(2, 1), 5.88258, 1e-05);
+  EXPECT_NEAR(database.getCost(3, 2), 5.79083, 1e-05);
+}
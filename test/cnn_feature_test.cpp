@@ -0,0 +1,91 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include <math.h>
+#include <numeric>
+#include <string>
+#include <vector>
+#include "database/list_dir.h"
+#include "features/cnn_feature.h"
+#include "features/vgg_feature.h"
+#include "gtest/gtest.h"
+
+namespace {
+// the score as it was computed before the norms were cached
+double referenceScore(const std::vector<double> &lhs,
+                      const std::vector<double> &rhs) {
+  double norm_qr =
+      sqrt(std::inner_product(lhs.begin(), lhs.end(), lhs.begin(), 0.0L));
+  double norm_db =
+      sqrt(std::inner_product(rhs.begin(), rhs.end(), rhs.begin(), 0.0L));
+  double prod_qr_db =
+      std::inner_product(rhs.begin(), rhs.end(), lhs.begin(), 0.0L);
+  return prod_qr_db / (norm_qr * norm_db);
+}
+}  // namespace
+
+TEST(CnnFeature, cachedNormScore) {
+  std::vector<std::string> quNames =
+      listDir("../test/test_data/query_features/");
+  std::vector<std::string> refNames =
+      listDir("../test/test_data/ref_features/");
+  std::vector<CnnFeature::Ptr> refs;
+  for (const std::string &name : refNames) {
+    refs.push_back(std::make_shared<CnnFeature>());
+    refs.back()->loadFromFile(name);
+  }
+  for (const std::string &name : quNames) {
+    CnnFeature::Ptr query = std::make_shared<CnnFeature>();
+    query->loadFromFile(name);
+    for (const auto &ref : refs) {
+      EXPECT_NEAR(query->computeSimilarityScore(ref),
+                  referenceScore(query->dim, ref->dim), 1e-12);
+    }
+  }
+}
+
+TEST(CnnFeature, manuallySetDim) {
+  CnnFeature::Ptr f0 = std::make_shared<CnnFeature>();
+  CnnFeature::Ptr f1 = std::make_shared<CnnFeature>();
+  f0->dim = {1, 2, 3};
+  f1->dim = {3, 0, 4};
+  EXPECT_NEAR(f0->computeSimilarityScore(f1),
+              referenceScore(f0->dim, f1->dim), 1e-12);
+  f0->updateNorm();
+  EXPECT_NEAR(f0->norm(), sqrt(14.0), 1e-12);
+  f1->dim = {0, 0, 2};
+  f1->updateNorm();
+  EXPECT_NEAR(f0->computeSimilarityScore(f1),
+              referenceScore(f0->dim, f1->dim), 1e-12);
+}
+
+TEST(VggFeature, cachedNormScore) {
+  VggFeature::Ptr f0 = std::make_shared<VggFeature>();
+  VggFeature::Ptr f1 = std::make_shared<VggFeature>();
+  f0->dim = {0.5, 0.0, 1.25, 2.0};
+  f1->dim = {1.0, 3.0, 0.0, 0.5};
+  f0->updateNorm();
+  f1->updateNorm();
+  EXPECT_NEAR(f0->computeSimilarityScore(f1),
+              referenceScore(f0->dim, f1->dim), 1e-12);
+}
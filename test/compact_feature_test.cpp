@@ -0,0 +1,91 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include <math.h>
+#include <stdio.h>
+#include <string>
+#include "database/online_database.h"
+#include "features/compact_feature.h"
+#include "features/feature_factory.h"
+#include "gtest/gtest.h"
+
+namespace {
+/** max relative cost error over the test sequences **/
+double maxCostError(FeatureFactory::StorageType storage) {
+  std::string path2qu = "../test/test_data/query_features/";
+  std::string path2ref = "../test/test_data/ref_features/";
+  OnlineDatabase exact, compact;
+  exact.setQuFeaturesFolder(path2qu);
+  exact.setRefFeaturesFolder(path2ref);
+  compact.setQuFeaturesFolder(path2qu);
+  compact.setRefFeaturesFolder(path2ref);
+  compact.setStorageType(storage);
+  double maxError = 0.0;
+  for (int qu = 0; qu < 4; ++qu) {
+    for (int ref = 0; ref < exact.refSize(); ++ref) {
+      double expected = exact.getCost(qu, ref);
+      double error = fabs(compact.getCost(qu, ref) - expected) / expected;
+      maxError = std::max(maxError, error);
+    }
+  }
+  return maxError;
+}
+}  // namespace
+
+TEST(CompactFeature, factory) {
+  FeatureFactory factory;
+  EXPECT_TRUE(std::dynamic_pointer_cast<CompactFeature>(
+                  factory.createFeature()) == nullptr);
+  factory.setStorageType(FeatureFactory::Int8);
+  auto featurePtr =
+      std::dynamic_pointer_cast<CompactFeature>(factory.createFeature());
+  ASSERT_TRUE(featurePtr != nullptr);
+  EXPECT_EQ(featurePtr->storage(), CompactFeature::INT8);
+  featurePtr->loadFromFile(
+      "../test/test_data/query_features/image_0-feature.txt");
+  EXPECT_EQ(featurePtr->size(), 512 * 18 * 24);
+  EXPECT_EQ(featurePtr->bits.size(), 512 * 18 * 24);
+}
+
+TEST(CompactFeature, accuracy) {
+  double float32Error = maxCostError(FeatureFactory::Float32);
+  double int8Error = maxCostError(FeatureFactory::Int8);
+  printf("[INFO] Max relative cost error float32: %g int8: %g\n",
+         float32Error, int8Error);
+  EXPECT_LT(float32Error, 1e-06);
+  EXPECT_LT(int8Error, 1e-02);
+}
+
+TEST(CompactFeature, exactRescoring) {
+  OnlineDatabase database;
+  database.setQuFeaturesFolder("../test/test_data/query_features/");
+  database.setRefFeaturesFolder("../test/test_data/ref_features/");
+  database.setStorageType(FeatureFactory::Int8);
+  database.setExactRescoring(6.7, 0.1);
+  // borderline cost, recomputed exactly
+  EXPECT_NEAR(database.getCost(0, 0), 6.68232, 1e-05);
+  EXPECT_EQ(database.rescoredCount(), 1);
+  // far from the non matching cost, stays approximate
+  EXPECT_NEAR(database.getCost(0, 2), 9.22337, 1e-01);
+  EXPECT_EQ(database.rescoredCount(), 1);
+}
@@ -0,0 +1,209 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+#include "database/feature_cache.h"
+#include "database/online_database.h"
+#include "features/cnn_feature.h"
+#include "gtest/gtest.h"
+
+namespace {
+const int kThreads = 8;
+
+void runThreads(const std::function<void(int)> &work) {
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back(work, t);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+}  // namespace
+
+TEST(MatchMap, concurrentAccess) {
+  MatchMap matchMap(64);
+  std::atomic<int> wrong(0);
+  runThreads([&](int t) {
+    for (int i = 0; i < 20000; ++i) {
+      int quId = (i / 50) % 64;
+      int refId = (i * 7 + t) % 500;
+      double expected = quId * 1000 + refId;
+      matchMap.addMatchCost(quId, refId, expected);
+      // a stored cost is either missing or correct, never torn
+      double cost = matchMap.getMatchCost(quId, (refId + 3) % 500);
+      if (cost != -1.0 && cost != quId * 1000 + (refId + 3) % 500) {
+        wrong++;
+      }
+    }
+  });
+  EXPECT_EQ(wrong.load(), 0);
+  matchMap.addMatchCost(100, 5, 1.5);
+  EXPECT_NEAR(matchMap.getMatchCost(100, 5), 1.5, 1e-09);
+  // out of the retention window
+  EXPECT_NEAR(matchMap.getMatchCost(30, 5), -1.0, 1e-09);
+}
+
+TEST(MatchMap, droppedCosts) {
+  // one slot per shard, at most 64 costs fit
+  MatchMap matchMap(1, 1);
+  for (int refId = 0; refId < 1000; ++refId) {
+    matchMap.addMatchCost(0, refId, refId + 0.5);
+  }
+  int stored = 0;
+  for (int refId = 0; refId < 1000; ++refId) {
+    double cost = matchMap.getMatchCost(0, refId);
+    if (cost != -1.0) {
+      EXPECT_NEAR(cost, refId + 0.5, 1e-09);
+      stored++;
+    }
+  }
+  EXPECT_LE(stored, 64);
+  EXPECT_EQ(matchMap.droppedCount(), size_t(1000 - stored));
+}
+
+TEST(OnlineDatabase, droppedCostsAreRecomputed) {
+  OnlineDatabase reference;
+  reference.setRefFeaturesFolder("../test/test_data/ref_features/");
+  reference.setQuFeaturesFolder("../test/test_data/query_features/");
+  reference.setBufferSize(10);
+
+  OnlineDatabase crowded(reference);
+  // 64 slots, one per shard, some of the 16 costs collide
+  crowded.setMatchMap(MatchMap(4, 1));
+  for (int round = 0; round < 2; ++round) {
+    for (int quId = 0; quId < 4; ++quId) {
+      for (int refId = 0; refId < 4; ++refId) {
+        EXPECT_NEAR(crowded.getCost(quId, refId),
+                    reference.getCost(quId, refId), 1e-09);
+      }
+    }
+  }
+  EXPECT_GT(crowded.droppedCostCount(), 0u);
+}
+
+TEST(FeatureCache, singleFlight) {
+  FeatureCache cache(4);
+  std::map<int, int> loads;
+  std::mutex loadsMutex;
+  FeatureCache::Loader loader = [&](int id) {
+    {
+      std::lock_guard<std::mutex> lock(loadsMutex);
+      loads[id]++;
+    }
+    // slow loading, so the threads ask for the feature at the same time
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    return iFeature::ConstPtr(new CnnFeature);
+  };
+  runThreads([&](int t) {
+    for (int id = 0; id < 16; ++id) {
+      EXPECT_TRUE(cache.getFeature(id, loader) != nullptr);
+      cache.prefetch((id + t) % 16, loader);
+    }
+  });
+  for (int id = 0; id < 16; ++id) {
+    EXPECT_EQ(loads[id], 1);
+  }
+  EXPECT_EQ(cache.size(), 16);
+  FeatureBuffer::Stats stats = cache.stats();
+  EXPECT_EQ(stats.hits + stats.misses, kThreads * 16);
+  // the prefetched features are not counted
+  EXPECT_LE(stats.misses, 16);
+  EXPECT_EQ(stats.evictions, 0);
+}
+
+TEST(FeatureCache, bufferSize) {
+  FeatureCache::Loader loader = [](int id) {
+    return iFeature::ConstPtr(new CnnFeature);
+  };
+  for (int size : {1, 10, 16, 37}) {
+    FeatureCache cache;
+    cache.setBufferSize(size);
+    for (int id = 0; id < 200; ++id) {
+      cache.getFeature(id, loader);
+      EXPECT_LE(cache.size(), size);
+    }
+    // the whole buffer is used
+    EXPECT_EQ(cache.size(), size);
+    // the most recent features are kept
+    FeatureBuffer::Stats stats = cache.stats();
+    cache.getFeature(199, loader);
+    EXPECT_EQ(cache.stats().hits, stats.hits + 1);
+  }
+  // shrinking below the number of shards drops the cached features
+  FeatureCache cache;
+  cache.setBufferSize(100);
+  for (int id = 0; id < 50; ++id) {
+    cache.getFeature(id, loader);
+  }
+  cache.setBufferSize(3);
+  EXPECT_EQ(cache.size(), 0);
+  for (int id = 0; id < 50; ++id) {
+    cache.getFeature(id, loader);
+  }
+  EXPECT_EQ(cache.size(), 3);
+}
+
+TEST(OnlineDatabase, concurrentCosts) {
+  OnlineDatabase database;
+  database.setRefFeaturesFolder("../test/test_data/ref_features/");
+  database.setQuFeaturesFolder("../test/test_data/query_features/");
+  database.setBufferSize(2);
+  // computed by one thread
+  OnlineDatabase reference(database);
+  std::vector<double> expected;
+  for (int qu = 0; qu < 4; ++qu) {
+    for (int ref = 0; ref < 4; ++ref) {
+      expected.push_back(reference.getCost(qu, ref));
+    }
+  }
+
+  database.setPrefetching(2);
+  std::atomic<int> wrong(0);
+  runThreads([&](int t) {
+    std::vector<int> refIds = {3, 2, 1, 0};
+    std::vector<double> costs(refIds.size());
+    for (int i = 0; i < 200; ++i) {
+      int qu = (i + t) % 4;
+      int ref = (i * 3 + t) % 4;
+      if (t == 0) {
+        database.setSearchFocus(qu, ref, 1);
+      }
+      if (database.getCost(qu, ref) != expected[qu * 4 + ref]) {
+        wrong++;
+      }
+      database.getCosts(qu, refIds.data(), refIds.size(), costs.data());
+      for (size_t r = 0; r < refIds.size(); ++r) {
+        if (costs[r] != expected[qu * 4 + refIds[r]]) {
+          wrong++;
+        }
+      }
+    }
+  });
+  EXPECT_EQ(wrong.load(), 0);
+}
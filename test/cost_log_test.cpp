@@ -0,0 +1,147 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include <stdio.h>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "database/cost_log.h"
+#include "database/list_dir.h"
+#include "database/online_database.h"
+#include "features/cnn_feature.h"
+#include "gtest/gtest.h"
+
+namespace {
+size_t fileSize(const std::string &name) {
+  std::ifstream in(name, std::ios::binary | std::ios::ate);
+  return in.tellg();
+}
+}  // namespace
+
+TEST(CostLog, reopen) {
+  std::string name = "cost_log_test.log";
+  remove(name.c_str());
+  {
+    CostLog log;
+    ASSERT_TRUE(log.open(name, 42));
+    EXPECT_EQ(log.loadedCount(), 0);
+    log.append(0, 1, 1.5);
+    log.append(2, 3, 2.5);
+    log.append(0, 1, 3.5);
+  }
+  {
+    CostLog log;
+    ASSERT_TRUE(log.open(name, 42));
+    EXPECT_EQ(log.loadedCount(), 2);
+    double cost;
+    ASSERT_TRUE(log.find(0, 1, &cost));
+    // the last record wins
+    EXPECT_DOUBLE_EQ(cost, 3.5);
+    ASSERT_TRUE(log.find(2, 3, &cost));
+    EXPECT_DOUBLE_EQ(cost, 2.5);
+    EXPECT_FALSE(log.find(1, 0, &cost));
+
+    for (int i = 0; i < 10; ++i) {
+      log.append(0, 1, 3.5);
+    }
+    log.flush();
+    size_t before = fileSize(name);
+    ASSERT_TRUE(log.compact());
+    EXPECT_EQ(fileSize(name),
+              sizeof(CostLogHeader) + 2 * sizeof(CostLogRecord));
+    EXPECT_LT(fileSize(name), before);
+  }
+  {
+    // other features, the costs are dropped
+    CostLog log;
+    ASSERT_TRUE(log.open(name, 43));
+    EXPECT_EQ(log.loadedCount(), 0);
+  }
+  remove(name.c_str());
+}
+
+TEST(OnlineDatabase, costCache) {
+  std::string name = "cost_cache_test.log";
+  remove(name.c_str());
+  double expected;
+  {
+    OnlineDatabase database;
+    database.setRefFeaturesFolder("../test/test_data/ref_features/");
+    database.setQuFeaturesFolder("../test/test_data/query_features/");
+    ASSERT_TRUE(database.setCostCache(name));
+    expected = database.getCost(0, 1);
+  }
+  OnlineDatabase database;
+  database.setRefFeaturesFolder("../test/test_data/ref_features/");
+  database.setQuFeaturesFolder("../test/test_data/query_features/");
+  ASSERT_TRUE(database.setCostCache(name));
+  EXPECT_DOUBLE_EQ(database.getCost(0, 1), expected);
+  // the features were not needed
+  EXPECT_EQ(database.quBufferStats().misses, 0);
+  EXPECT_EQ(database.refBufferStats().misses, 0);
+  database.getCost(1, 1);
+  EXPECT_EQ(database.refBufferStats().misses, 1);
+
+  // the costs of other features are not reused
+  OnlineDatabase other;
+  other.setRefFeaturesFolder("../test/test_data/ref_features/");
+  other.setQuFeaturesFolder("../test/test_data/query_features/");
+  other.setStorageType(FeatureFactory::Float32);
+  ASSERT_TRUE(other.setCostCache(name));
+  other.getCost(0, 1);
+  EXPECT_EQ(other.refBufferStats().misses, 1);
+  remove(name.c_str());
+}
+
+TEST(OnlineDatabase, costCacheWithStreams) {
+  std::string name = "cost_cache_stream_test.log";
+  remove(name.c_str());
+  std::vector<std::string> quNames =
+      listDir("../test/test_data/query_features/");
+  std::vector<std::string> refNames =
+      listDir("../test/test_data/ref_features/");
+  // two streams with different features and the same (empty) names
+  for (const auto &names : {quNames, refNames}) {
+    OnlineDatabase database;
+    database.setRefFeaturesFolder("../test/test_data/ref_features/");
+    ASSERT_TRUE(database.setCostCache(name));
+    OnlineDatabase exact;
+    exact.setRefFeaturesFolder("../test/test_data/ref_features/");
+    for (const std::string &featureName : names) {
+      auto feature = std::make_shared<CnnFeature>();
+      feature->loadFromFile(featureName);
+      database.addQueryFeature(feature);
+      exact.addQueryFeature(feature);
+    }
+    for (int qu = 0; qu < static_cast<int>(names.size()); ++qu) {
+      for (int ref = 0; ref < database.refSize(); ++ref) {
+        EXPECT_DOUBLE_EQ(database.getCost(qu, ref), exact.getCost(qu, ref));
+      }
+    }
+    database.flushCostCache();
+    // the cache cannot be enabled again for the stream
+    EXPECT_FALSE(database.setCostCache(name));
+  }
+  remove(name.c_str());
+}
@@ -0,0 +1,215 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+#include "database/cost_matrix_database.h"
+#include "database/cost_matrix_file.h"
+#include "gtest/gtest.h"
+
+TEST(CostMatrixFile, half) {
+  std::vector<float> values = {0.f, 1.f, -2.5f, 0.1f, 65504.f, 6.1e-5f, 3e-7f};
+  for (float v : values) {
+    float restored = halfToFloat(floatToHalf(v));
+    EXPECT_NEAR(restored, v, fabs(v) * 1e-3 + 1e-7);
+  }
+  EXPECT_EQ(floatToHalf(1.f), 0x3c00);
+  EXPECT_EQ(floatToHalf(-2.f), 0xc000);
+  EXPECT_EQ(floatToHalf(1e6f), 0x7c00);
+  // ties round to even
+  EXPECT_EQ(floatToHalf(1.f + 1.f / 2048), 0x3c00);
+  EXPECT_EQ(floatToHalf(1.f + 3.f / 2048), 0x3c02);
+}
+
+TEST(CostMatrixFile, saveAndOpen) {
+  int rows = 3, cols = 5;
+  std::vector<float> costs;
+  for (int i = 0; i < rows * cols; ++i) {
+    costs.push_back(0.05f * i);
+  }
+  std::string f32 = "cost_matrix_test_f32.bin";
+  std::string f16 = "cost_matrix_test_f16.bin";
+  std::string npy = "cost_matrix_test.npy";
+  ASSERT_TRUE(saveCostMatrix(f32, costs.data(), rows, cols));
+  ASSERT_TRUE(saveCostMatrix(f16, costs.data(), rows, cols, COST_FLOAT16));
+  ASSERT_TRUE(saveCostMatrixNpy(npy, costs.data(), rows, cols));
+
+  for (const std::string &name : {f32, f16, npy}) {
+    EXPECT_TRUE(CostMatrixFile::isCostMatrixFile(name));
+    CostMatrixFile file;
+    ASSERT_TRUE(file.open(name));
+    EXPECT_EQ(file.rows(), rows);
+    EXPECT_EQ(file.cols(), cols);
+    double tolerance = file.dtype() == COST_FLOAT16 ? 1e-3 : 1e-9;
+    for (int r = 0; r < rows; ++r) {
+      for (int c = 0; c < cols; ++c) {
+        EXPECT_NEAR(file.at(r, c), costs[r * cols + c], tolerance);
+      }
+    }
+  }
+  EXPECT_FALSE(CostMatrixFile::isCostMatrixFile(
+      "../test/test_data/cost_matrix_3_5.txt"));
+  remove(f32.c_str());
+  remove(f16.c_str());
+  remove(npy.c_str());
+}
+
+namespace {
+std::string readFile(const std::string &name) {
+  std::ifstream in(name.c_str(), std::ios::binary);
+  return std::string((std::istreambuf_iterator<char>(in)),
+                     std::istreambuf_iterator<char>());
+}
+
+void writeFile(const std::string &name, const std::string &data) {
+  std::ofstream out(name.c_str(), std::ios::binary);
+  out.write(data.data(), data.size());
+}
+}  // namespace
+
+TEST(CostMatrixFile, invalidSize) {
+  int rows = 3, cols = 5;
+  std::vector<float> costs(rows * cols, 1.f);
+  std::string name = "cost_matrix_test_invalid.bin";
+  ASSERT_TRUE(
+      saveCostMatrix(name, costs.data(), rows, cols, COST_UINT8, COST_PER_ROW));
+  std::string data = readFile(name);
+  size_t rowsPos = offsetof(CostMatrixHeader, rows);
+  size_t colsPos = offsetof(CostMatrixHeader, cols);
+  uint64_t kInt = std::numeric_limits<int>::max();
+  std::vector<std::pair<uint64_t, uint64_t> > sizes = {
+      {0, 5}, {3, 0}, {kInt + 1, 5}, {3, uint64_t(1) << 62},
+      {uint64_t(1) << 61, 5}, {kInt, kInt}, {4, 5}};
+  for (const auto &size : sizes) {
+    std::string corrupted = data;
+    memcpy(&corrupted[rowsPos], &size.first, sizeof(uint64_t));
+    memcpy(&corrupted[colsPos], &size.second, sizeof(uint64_t));
+    writeFile(name, corrupted);
+    CostMatrixFile file;
+    EXPECT_FALSE(file.open(name));
+  }
+  writeFile(name, data.substr(0, data.size() - 1));
+  EXPECT_FALSE(CostMatrixFile().open(name));
+
+  ASSERT_TRUE(saveCostMatrixNpy(name, costs.data(), rows, cols));
+  data = readFile(name);
+  size_t shapePos = data.find("(3, 5), }");
+  ASSERT_NE(shapePos, std::string::npos);
+  for (std::string shape :
+       {"(0, 5), }", "(-3, 5), }", "(3, 4294967296), }", "(4, 5), }"}) {
+    // the padding keeps the header length
+    std::string corrupted = data;
+    corrupted.replace(shapePos, shape.size(), shape);
+    writeFile(name, corrupted);
+    CostMatrixFile file;
+    EXPECT_FALSE(file.open(name));
+  }
+  remove(name.c_str());
+}
+
+TEST(CostMatrixFile, loadInDatabase) {
+  CostMatrixDatabase text;
+  ASSERT_TRUE(text.loadFromFile("../test/test_data/cost_matrix.txt"));
+  cv::Mat costs = text.getCosts();
+  std::string f32 = "cost_matrix_db_f32.bin";
+  std::string f16 = "cost_matrix_db_f16.bin";
+  ASSERT_TRUE(saveCostMatrix(f32, costs.ptr<float>(0), costs.rows, costs.cols));
+  ASSERT_TRUE(saveCostMatrix(f16, costs.ptr<float>(0), costs.rows, costs.cols,
+                             COST_FLOAT16));
+
+  CostMatrixDatabase mapped, half;
+  ASSERT_TRUE(mapped.loadFromFile(f32));
+  ASSERT_TRUE(half.loadFromFile(f16));
+  EXPECT_EQ(mapped.refSize(), text.refSize());
+  EXPECT_EQ(half.refSize(), text.refSize());
+  for (int qu = 0; qu < costs.rows; ++qu) {
+    for (int ref = 0; ref < costs.cols; ++ref) {
+      double expected = text.getCost(qu, ref);
+      EXPECT_NEAR(mapped.getCost(qu, ref), expected, 1e-9);
+      EXPECT_NEAR(half.getCost(qu, ref), expected, expected * 1e-3);
+    }
+    // the mapped values are transformed on access in the batches as well
+    std::vector<int> refIds(costs.cols);
+    std::vector<double> rowCosts(costs.cols);
+    for (int ref = 0; ref < costs.cols; ++ref) {
+      refIds[ref] = costs.cols - 1 - ref;
+    }
+    mapped.getCosts(qu, refIds.data(), refIds.size(), rowCosts.data());
+    for (int ref = 0; ref < costs.cols; ++ref) {
+      EXPECT_EQ(rowCosts[ref], mapped.getCost(qu, refIds[ref]));
+    }
+  }
+  EXPECT_EQ(half.getCosts().cols, costs.cols);
+  remove(f32.c_str());
+  remove(f16.c_str());
+}
+
+TEST(CostMatrixFile, quantized) {
+  int rows = 4, cols = 50;
+  std::vector<float> sims;
+  for (int r = 0; r < rows; ++r) {
+    for (int c = 0; c < cols; ++c) {
+      // every row has a different range
+      sims.push_back(0.1f * (r + 1) + 0.013f * c * (r + 1));
+    }
+  }
+  std::string name = "cost_matrix_test_quantized.bin";
+  for (CostDType dtype : {COST_UINT8, COST_UINT16}) {
+    for (CostScaling scaling : {COST_GLOBAL, COST_PER_ROW}) {
+      ASSERT_TRUE(
+          saveCostMatrix(name, sims.data(), rows, cols, dtype, scaling));
+      CostMatrixFile file;
+      ASSERT_TRUE(file.open(name));
+      EXPECT_EQ(file.dtype(), dtype);
+      EXPECT_EQ(file.scaling(), scaling);
+      CostMatrixDatabase database;
+      ASSERT_TRUE(database.loadFromFile(name));
+      EXPECT_EQ(database.refSize(), cols);
+      std::vector<int> refIds;
+      for (int c = 0; c < cols; ++c) {
+        refIds.push_back(c);
+      }
+      std::vector<double> batch(cols);
+      for (int r = 0; r < rows; ++r) {
+        database.getCosts(r, refIds.data(), cols, batch.data());
+        for (int c = 0; c < cols; ++c) {
+          float sim = sims[r * cols + c];
+          // rounding to the nearest level
+          EXPECT_NEAR(file.at(r, c), sim, file.scale(r) * 0.5 + 1e-6);
+          double expected = 1. / file.at(r, c);
+          EXPECT_NEAR(database.getCost(r, c), expected, expected * 1e-6);
+          EXPECT_EQ(batch[c], database.getCost(r, c));
+        }
+      }
+    }
+  }
+  remove(name.c_str());
+}
@@ -21,8 +21,12 @@
 ** SOFTWARE.
 **/
 
+#include <stdlib.h>
+#include <algorithm>
 #include <iostream>
 #include <string>
+#include <utility>
+#include <vector>
 #include "database/cost_matrix_database.h"
 #include "database/online_database.h"
 #include "gtest/gtest.h"
@@ -39,6 +43,76 @@ TEST(MatchMap, getCost) {
   EXPECT_NEAR(cost, -1.0, 1e-09);
 }
 
+TEST(MatchMap, extendRow) {
+  MatchMap matchMap;
+  matchMap.addMatchCost(0, 50, 1.0);
+  matchMap.addMatchCost(0, 10, 2.0);
+  matchMap.addMatchCost(0, 300, 3.0);
+  matchMap.addMatchCost(0, 0, 4.0);
+  EXPECT_NEAR(matchMap.getMatchCost(0, 50), 1.0, 1e-09);
+  EXPECT_NEAR(matchMap.getMatchCost(0, 10), 2.0, 1e-09);
+  EXPECT_NEAR(matchMap.getMatchCost(0, 300), 3.0, 1e-09);
+  EXPECT_NEAR(matchMap.getMatchCost(0, 0), 4.0, 1e-09);
+  EXPECT_NEAR(matchMap.getMatchCost(0, 51), -1.0, 1e-09);
+  EXPECT_NEAR(matchMap.getMatchCost(0, 1000), -1.0, 1e-09);
+  EXPECT_NEAR(matchMap.getMatchCost(1, 50), -1.0, 1e-09);
+}
+
+TEST(MatchMap, retention) {
+  MatchMap matchMap(2);
+  matchMap.addMatchCost(0, 1, 1.0);
+  matchMap.addMatchCost(1, 1, 2.0);
+  matchMap.addMatchCost(2, 1, 3.0);
+  // row 0 was replaced by row 2
+  EXPECT_NEAR(matchMap.getMatchCost(0, 1), -1.0, 1e-09);
+  EXPECT_NEAR(matchMap.getMatchCost(1, 1), 2.0, 1e-09);
+  EXPECT_NEAR(matchMap.getMatchCost(2, 1), 3.0, 1e-09);
+  // older rows do not replace the recent ones
+  matchMap.addMatchCost(0, 2, 4.0);
+  EXPECT_NEAR(matchMap.getMatchCost(0, 2), -1.0, 1e-09);
+  EXPECT_NEAR(matchMap.getMatchCost(2, 1), 3.0, 1e-09);
+
+  size_t bytes = matchMap.memorySize();
+  for (int quId = 3; quId < 1000; ++quId) {
+    matchMap.addMatchCost(quId, quId % 7, 1.0);
+  }
+  EXPECT_EQ(matchMap.memorySize(), bytes);
+}
+
+TEST(MatchMap, localizerLoad) {
+  // the costs of the successors of the expanded nodes with a fan out of 5,
+  // and of the relocalization candidates when the localizer is lost
+  const int kFanOut = 5, kExpanded = 20;
+  const int kCandidates = MatchMap::kDefaultRowCapacity;
+  const int kRefSize = 100000;
+  MatchMap matchMap;
+  srand(3);
+  std::vector<std::pair<int, int> > recent;
+  for (int quId = 0; quId < 3000; ++quId) {
+    recent.clear();
+    int pathRef = quId * 3;
+    for (int node = 0; node < kExpanded; ++node) {
+      int ref = pathRef + node - kExpanded / 2;
+      for (int step = -kFanOut; step <= kFanOut; ++step) {
+        recent.push_back(std::make_pair(quId, std::max(0, ref + step)));
+      }
+    }
+    // lost for 100 query images every 500
+    bool lost = quId % 500 < 100;
+    for (int c = 0; lost && c < kCandidates; ++c) {
+      recent.push_back(std::make_pair(quId, rand() % kRefSize));
+    }
+    for (const auto &match : recent) {
+      matchMap.addMatchCost(match.first, match.second, match.second + 0.5);
+    }
+    for (const auto &match : recent) {
+      ASSERT_EQ(matchMap.getMatchCost(match.first, match.second),
+                match.second + 0.5);
+    }
+  }
+  EXPECT_EQ(matchMap.droppedCount(), 0);
+}
+
 TEST(OnlineDatabase, refSize) {
   OnlineDatabase database;
   std::string path2folder = "../test/test_data/ref_features/";
@@ -86,6 +160,47 @@ TEST(OnlineDatabase, getCost) {
   EXPECT_NEAR(database.getCost(3, 2), 5.79083, 1e-05);
 }
 
+TEST(OnlineDatabase, getCosts) {
+  OnlineDatabase database;
+  database.setRefFeaturesFolder("../test/test_data/ref_features/");
+  database.setQuFeaturesFolder("../test/test_data/query_features/");
+  database.setBufferSize(10);
+
+  std::vector<int> refIds = {3, 1, 0, 2};
+  std::vector<double> costs(refIds.size());
+  database.getCosts(0, refIds.data(), refIds.size(), costs.data());
+  EXPECT_NEAR(costs[0], 7.31119, 1e-05);
+  EXPECT_NEAR(costs[1], 7.31119, 1e-05);
+  EXPECT_NEAR(costs[2], 6.68232, 1e-05);
+  EXPECT_NEAR(costs[3], 9.22337, 1e-05);
+  // the batch stores the costs as getCost does
+  for (size_t i = 0; i < refIds.size(); ++i) {
+    EXPECT_NEAR(database.getMatchMap().getMatchCost(0, refIds[i]), costs[i],
+                1e-09);
+  }
+}
+
+TEST(OnlineDatabase, prefetching) {
+  OnlineDatabase database;
+  database.setRefFeaturesFolder("../test/test_data/ref_features/");
+  database.setQuFeaturesFolder("../test/test_data/query_features/");
+  database.setBufferSize(10);
+  database.setPrefetching(2);
+  database.setSearchFocus(0, 1, 1);
+  database.prefetchRefs({3, 10});
+
+  // the same costs, no matter if the features were already prefetched
+  EXPECT_NEAR(database.getCost(0, 0), 6.68232, 1e-05);
+  EXPECT_NEAR(database.getCost(0, 1), 7.31119, 1e-05);
+  database.setSearchFocus(2, 1, 2);
+  EXPECT_NEAR(database.getCost(2, 1), 5.88258, 1e-05);
+  EXPECT_NEAR(database.getCost(3, 2), 5.79083, 1e-05);
+
+  FeatureBuffer::Stats stats = database.refBufferStats();
+  EXPECT_EQ(stats.hits + stats.misses, 4);
+  EXPECT_LE(database.prefetchedCount(), 8);
+}
+
 class CostMatrixDatabase_TEST : public CostMatrixDatabase {
  public:
   void loadFromTxt(const std::string &filename);
@@ -151,3 +266,27 @@ TEST(CostMatrixDatabase, getCost) {
   EXPECT_NEAR(std::numeric_limits<double>::max(), database.getCost(2, 0),
               1e-06);
 }
+
+TEST(CostMatrixDatabase, getCostUnchecked) {
+  CostMatrixDatabase_TEST database;
+  database.loadFromTxt("../test/test_data/cost_matrix_3_5.txt", 3, 5);
+  for (int qu = 0; qu < 3; ++qu) {
+    for (int ref = 0; ref < database.refSize(); ++ref) {
+      EXPECT_EQ(database.getCost(qu, ref), database.getCostUnchecked(qu, ref));
+    }
+  }
+}
+
+TEST(CostMatrixDatabase, getCosts) {
+  CostMatrixDatabase_TEST database;
+  database.loadFromTxt("../test/test_data/cost_matrix_3_5.txt", 3, 5);
+
+  std::vector<int> refIds = {4, 0, 3, 7};
+  std::vector<double> costs(refIds.size());
+  database.getCosts(1, refIds.data(), refIds.size(), costs.data());
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_NEAR(database.getCost(1, refIds[i]), costs[i], 1e-09);
+  }
+  // out of range
+  EXPECT_NEAR(costs[3], -1.0, 1e-09);
+}
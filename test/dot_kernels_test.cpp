@@ -0,0 +1,106 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+#include "features/dot_kernels.h"
+#include "gtest/gtest.h"
+
+namespace {
+std::vector<double> randomValues(size_t n, unsigned int seed) {
+  srand(seed);
+  std::vector<double> values(n);
+  for (size_t i = 0; i < n; ++i) {
+    // mostly zeros as in relu features
+    values[i] = rand() % 4 == 0 ? rand() / double(RAND_MAX) : 0.0;
+  }
+  return values;
+}
+
+// bound of the rounding error of summing n products in double in any order,
+// the values are non negative so the sum of the absolute products is the sum
+double tolerance(size_t n, double sum) { return 2 * n * DBL_EPSILON * sum; }
+}  // namespace
+
+TEST(DotKernels, allKernelsMatchScalar) {
+  const DotKernelType initial = activeDotKernel();
+  const DotKernelType types[] = {DOT_SCALAR, DOT_SSE2, DOT_AVX2, DOT_AVX512};
+  // sizes which do not fit the vector width to check the tails
+  const size_t sizes[] = {0, 1, 3, 7, 17, 33, 1000, 221184, 600000};
+  for (size_t n : sizes) {
+    std::vector<double> a = randomValues(n, 1), b = randomValues(n, 2);
+    std::vector<float> af(a.begin(), a.end()), bf(b.begin(), b.end());
+    double expected = 0.0, expectedA = 0.0, expectedB = 0.0;
+    double expectedF = 0.0, expectedAF = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+      expected += a[i] * b[i];
+      expectedA += a[i] * a[i];
+      expectedB += b[i] * b[i];
+      expectedF += double(af[i]) * bf[i];
+      expectedAF += double(af[i]) * af[i];
+    }
+    for (DotKernelType type : types) {
+      if (!setDotKernel(type)) {
+        continue;
+      }
+      EXPECT_EQ(activeDotKernel(), type);
+      EXPECT_NEAR(dotProduct(a.data(), b.data(), n), expected,
+                  tolerance(n, expected))
+          << dotKernelName(type) << " " << n;
+      // float inputs are accumulated in double as well
+      EXPECT_NEAR(dotProduct(af.data(), bf.data(), n), expectedF,
+                  tolerance(n, expectedF))
+          << dotKernelName(type) << " " << n;
+      std::vector<int8_t> a8(n), b8(n);
+      int64_t expected8 = 0;
+      for (size_t i = 0; i < n; ++i) {
+        a8[i] = static_cast<int8_t>(int(a[i] * 255) - 128);
+        b8[i] = static_cast<int8_t>(int(b[i] * 255) - 128);
+        expected8 += int64_t(a8[i]) * b8[i];
+      }
+      EXPECT_EQ(dotProduct(a8.data(), b8.data(), n), expected8)
+          << dotKernelName(type) << " " << n;
+      double aa, bb, ab;
+      normDotProduct(a.data(), b.data(), n, &aa, &bb, &ab);
+      EXPECT_NEAR(aa, expectedA, tolerance(n, expectedA));
+      EXPECT_NEAR(bb, expectedB, tolerance(n, expectedB));
+      EXPECT_NEAR(ab, expected, tolerance(n, expected));
+      normDotProduct(af.data(), bf.data(), n, &aa, &bb, &ab);
+      EXPECT_NEAR(aa, expectedAF, tolerance(n, expectedAF))
+          << dotKernelName(type) << " " << n;
+      EXPECT_NEAR(ab, expectedF, tolerance(n, expectedF))
+          << dotKernelName(type) << " " << n;
+    }
+  }
+  setDotKernel(initial);
+}
+
+TEST(DotKernels, cosineSimilarity) {
+  std::vector<double> a = {1, 2, 3}, b = {3, 0, 4};
+  EXPECT_NEAR(cosineSimilarity(a.data(), b.data(), a.size()),
+              15.0 / (sqrt(14.0) * 5.0), 1e-12);
+  EXPECT_NEAR(cosineSimilarity(a.data(), a.data(), a.size()), 1.0, 1e-12);
+  EXPECT_TRUE(dotKernelSupported(DOT_SCALAR));
+}
@@ -0,0 +1,211 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include <stddef.h>
+#include <stdio.h>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "database/list_dir.h"
+#include "database/online_database.h"
+#include "features/cnn_feature.h"
+#include "features/feature_archive.h"
+#include "features/feature_view.h"
+#include "features/vgg_feature.h"
+#include "gtest/gtest.h"
+
+namespace {
+void packFolder(const std::string &path2folder, const std::string &archiveName) {
+  std::vector<std::string> names = listDir(path2folder);
+  FeatureArchiveWriter writer;
+  ASSERT_TRUE(writer.open(archiveName, names.size()));
+  for (const std::string &name : names) {
+    CnnFeature feature;
+    feature.loadFromFile(name);
+    ASSERT_TRUE(writer.add(feature.dim, &feature.bits));
+  }
+  ASSERT_TRUE(writer.close());
+}
+}  // namespace
+
+TEST(FeatureArchive, viewsMatchFeatures) {
+  std::string path2ref = "../test/test_data/ref_features/";
+  std::string archiveName = "feature_archive_test.bin";
+  packFolder(path2ref, archiveName);
+  ASSERT_TRUE(FeatureArchive::isArchive(archiveName));
+  EXPECT_FALSE(FeatureArchive::isArchive(
+      "../test/test_data/ref_features/image_1-feature.txt"));
+
+  auto archive = std::make_shared<FeatureArchive>();
+  ASSERT_TRUE(archive->open(archiveName));
+  std::vector<std::string> names = listDir(path2ref);
+  ASSERT_EQ(archive->size(), names.size());
+
+  CnnFeature::Ptr query = std::make_shared<CnnFeature>();
+  query->loadFromFile("../test/test_data/query_features/image_0-feature.txt");
+  for (int i = 0; i < archive->size(); ++i) {
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(archive->values(i)) %
+                  kFeatureArchiveAlignment,
+              0);
+    CnnFeature::Ptr ref = std::make_shared<CnnFeature>();
+    ref->loadFromFile(names[i]);
+    FeatureView::Ptr view = std::make_shared<FeatureView>(archive, i, true);
+    ASSERT_EQ(view->size(), ref->dim.size());
+    EXPECT_EQ(view->bits, ref->bits);
+    EXPECT_NEAR(view->computeSimilarityScore(query),
+                query->computeSimilarityScore(ref), 1e-09);
+    EXPECT_NEAR(query->computeSimilarityScore(view),
+                query->computeSimilarityScore(ref), 1e-09);
+    EXPECT_NEAR(view->computeSimilarityScore(view), 1.0, 1e-09);
+  }
+  remove(archiveName.c_str());
+}
+
+TEST(FeatureArchive, featureType) {
+  std::string archiveName = "feature_archive_type_test.bin";
+  FeatureArchiveWriter sparse;
+  EXPECT_FALSE(
+      sparse.open(archiveName, 1, FeatureFactory::Cnn_Feature_Sparse));
+
+  std::vector<VggFeature::Ptr> features(3);
+  FeatureArchiveWriter writer;
+  ASSERT_TRUE(writer.open(archiveName, features.size(),
+                          FeatureFactory::Vgg_Feature));
+  for (size_t i = 0; i < features.size(); ++i) {
+    features[i] = std::make_shared<VggFeature>();
+    features[i]->dim = {1.0 + i, 2.0, 0.5 * i, 3.0};
+    features[i]->updateNorm();
+    ASSERT_TRUE(writer.add(features[i]->dim));
+  }
+  ASSERT_TRUE(writer.close());
+
+  auto archive = std::make_shared<FeatureArchive>();
+  ASSERT_TRUE(archive->open(archiveName));
+  EXPECT_EQ(archive->featureType(), FeatureFactory::Vgg_Feature);
+  for (size_t i = 0; i < features.size(); ++i) {
+    FeatureView::Ptr view = std::make_shared<FeatureView>(archive, i);
+    EXPECT_EQ(view->featureType(), FeatureFactory::Vgg_Feature);
+    for (const auto &feature : features) {
+      double expected = feature->computeSimilarityScore(features[i]);
+      // the views are matched the same from both sides
+      EXPECT_NEAR(view->computeSimilarityScore(feature), expected, 1e-12);
+      EXPECT_NEAR(feature->computeSimilarityScore(view), expected, 1e-12);
+      EXPECT_DOUBLE_EQ(view->score2cost(expected),
+                       feature->score2cost(expected));
+    }
+  }
+  remove(archiveName.c_str());
+}
+
+TEST(FeatureArchive, corrupted) {
+  std::string archiveName = "feature_archive_corrupted_test.bin";
+  BitCode bits;
+  bits.assign(4, true);
+  auto writeArchive = [&archiveName, &bits]() {
+    FeatureArchiveWriter writer;
+    ASSERT_TRUE(writer.open(archiveName, 1));
+    ASSERT_TRUE(writer.add({1.0, 2.0, 3.0, 4.0}, &bits));
+    ASSERT_TRUE(writer.close());
+  };
+  // overwrites a field of the header or of the only index entry
+  auto patch = [&archiveName](size_t pos, uint64_t value) {
+    std::fstream file(archiveName.c_str(),
+                      std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(pos);
+    file.write(reinterpret_cast<const char *>(&value), sizeof(value));
+  };
+  const size_t entryPos = sizeof(FeatureArchiveHeader);
+  writeArchive();
+  {
+    FeatureArchive archive;
+    ASSERT_TRUE(archive.open(archiveName));
+  }
+
+  // a count that overflows count * sizeof(entry) to a small number
+  patch(offsetof(FeatureArchiveHeader, count), (uint64_t(1) << 59) + 1);
+  EXPECT_FALSE(FeatureArchive().open(archiveName));
+  writeArchive();
+  // a size that overflows size * sizeof(double)
+  patch(entryPos + offsetof(FeatureArchiveEntry, size),
+        (uint64_t(1) << 61) + 1);
+  EXPECT_FALSE(FeatureArchive().open(archiveName));
+  writeArchive();
+  patch(entryPos + offsetof(FeatureArchiveEntry, bitsOffset), 1 << 20);
+  EXPECT_FALSE(FeatureArchive().open(archiveName));
+  writeArchive();
+  // values that are not aligned to double
+  patch(entryPos + offsetof(FeatureArchiveEntry, offset), 65);
+  EXPECT_FALSE(FeatureArchive().open(archiveName));
+
+  // the bits are the last payload, a truncated file misses them
+  writeArchive();
+  std::ifstream in(archiveName.c_str(), std::ios::binary);
+  std::vector<char> data((std::istreambuf_iterator<char>(in)),
+                         std::istreambuf_iterator<char>());
+  in.close();
+  std::ofstream out(archiveName.c_str(), std::ios::binary);
+  out.write(data.data(), data.size() - 4);
+  out.close();
+  EXPECT_FALSE(FeatureArchive().open(archiveName));
+  remove(archiveName.c_str());
+}
+
+TEST(FeatureArchive, onlineDatabase) {
+  std::string path2qu = "../test/test_data/query_features/";
+  std::string path2ref = "../test/test_data/ref_features/";
+  std::string refArchive = "feature_archive_test_ref.bin";
+  std::string quArchive = "feature_archive_test_qu.bin";
+  packFolder(path2ref, refArchive);
+  packFolder(path2qu, quArchive);
+
+  OnlineDatabase folders;
+  folders.setRefFeaturesFolder(path2ref);
+  folders.setQuFeaturesFolder(path2qu);
+
+  OnlineDatabase mixed;
+  mixed.setRefFeaturesFolder(refArchive);
+  mixed.setQuFeaturesFolder(path2qu);
+  ASSERT_EQ(mixed.refSize(), folders.refSize());
+
+  OnlineDatabase archives;
+  archives.setRefFeaturesFolder(refArchive);
+  archives.setQuFeaturesFolder(quArchive);
+
+  for (int qu = 0; qu < 4; ++qu) {
+    for (int ref = 0; ref < folders.refSize(); ++ref) {
+      double expected = folders.getCost(qu, ref);
+      EXPECT_NEAR(mixed.getCost(qu, ref), expected, 1e-09);
+      EXPECT_NEAR(archives.getCost(qu, ref), expected, 1e-09);
+    }
+  }
+  EXPECT_NEAR(archives.getCost(0, 0), 6.68232, 1e-05);
+  EXPECT_EQ(archives.getRefFeatureName(1), refArchive + ":1");
+  EXPECT_EQ(archives.getRefFeatureName(archives.refSize()), "");
+  auto quView = std::dynamic_pointer_cast<const FeatureView>(
+      archives.getQueryFeature(0));
+  ASSERT_TRUE(quView != nullptr);
+  EXPECT_FALSE(quView->bits.empty());
+  remove(refArchive.c_str());
+  remove(quArchive.c_str());
+}
@@ -42,14 +42,16 @@ TEST(featureBuffer, addFeature) {
   f3.dim = v3;
   buffer.addFeature(0, std::make_shared<CnnFeature>(f0));
   buffer.addFeature(1, std::make_shared<CnnFeature>(f1));
-  EXPECT_EQ(buffer.featureMap.size(), 2);
-  EXPECT_EQ(buffer.ids[0], 0);
-  EXPECT_EQ(buffer.ids[1], 1);
+  EXPECT_EQ(buffer.size(), 2);
+  EXPECT_TRUE(buffer.inBuffer(0));
+  EXPECT_TRUE(buffer.inBuffer(1));
 
   buffer.addFeature(3, std::make_shared<CnnFeature>(f3));
-  EXPECT_EQ(buffer.featureMap.size(), 2);
-  EXPECT_EQ(buffer.ids[0], 1);
-  EXPECT_EQ(buffer.ids[1], 3);
+  EXPECT_EQ(buffer.size(), 2);
+  EXPECT_FALSE(buffer.inBuffer(0));
+  EXPECT_TRUE(buffer.inBuffer(1));
+  EXPECT_TRUE(buffer.inBuffer(3));
+  EXPECT_EQ(buffer.stats().evictions, 1);
 }
 
 TEST(featureBuffer, inBuffer) {
@@ -78,3 +80,66 @@ TEST(featureBuffer, getFeature) {
   EXPECT_NEAR(resPtr->dim[1], 5, 1e-09);
   EXPECT_NEAR(resPtr->dim[2], 6, 1e-09);
 }
+
+TEST(featureBuffer, leastRecentlyUsed) {
+  FeatureBuffer buffer;
+  buffer.setBufferSize(2);
+  CnnFeature f;
+  f.dim = {1, 2, 3};
+  buffer.addFeature(0, std::make_shared<CnnFeature>(f));
+  buffer.addFeature(1, std::make_shared<CnnFeature>(f));
+  // 0 is used again, so 1 is the oldest one
+  EXPECT_TRUE(buffer.getFeature(0) != nullptr);
+  buffer.addFeature(2, std::make_shared<CnnFeature>(f));
+  EXPECT_TRUE(buffer.inBuffer(0));
+  EXPECT_FALSE(buffer.inBuffer(1));
+  EXPECT_TRUE(buffer.inBuffer(2));
+
+  EXPECT_TRUE(buffer.getFeature(1) == nullptr);
+  EXPECT_EQ(buffer.stats().hits, 1);
+  EXPECT_EQ(buffer.stats().misses, 1);
+}
+
+TEST(featureBuffer, memoryBudget) {
+  CnnFeature f;
+  f.dim = std::vector<double>(1000, 1.0);
+  size_t bytes = f.memorySize();
+  EXPECT_GE(bytes, 1000 * sizeof(double));
+
+  FeatureBuffer buffer;
+  buffer.setMemoryBudget(3 * bytes);
+  for (int id = 0; id < 5; ++id) {
+    buffer.addFeature(id, std::make_shared<CnnFeature>(f));
+  }
+  EXPECT_EQ(buffer.size(), 3);
+  EXPECT_EQ(buffer.memoryUsed(), 3 * bytes);
+  EXPECT_FALSE(buffer.inBuffer(1));
+  EXPECT_TRUE(buffer.inBuffer(2));
+  EXPECT_TRUE(buffer.inBuffer(4));
+
+  buffer.setMemoryBudget(bytes);
+  EXPECT_EQ(buffer.size(), 1);
+  EXPECT_TRUE(buffer.inBuffer(4));
+}
+
+TEST(featureBuffer, pinned) {
+  FeatureBuffer buffer;
+  buffer.setBufferSize(2);
+  CnnFeature f;
+  f.dim = {1, 2, 3};
+  buffer.addFeature(0, std::make_shared<CnnFeature>(f));
+  buffer.setPinned({0});
+  for (int id = 1; id < 5; ++id) {
+    buffer.addFeature(id, std::make_shared<CnnFeature>(f));
+  }
+  EXPECT_TRUE(buffer.inBuffer(0));
+  EXPECT_TRUE(buffer.inBuffer(4));
+  EXPECT_EQ(buffer.size(), 2);
+
+  // unpinned features can be evicted again
+  buffer.setPinned({});
+  buffer.addFeature(5, std::make_shared<CnnFeature>(f));
+  EXPECT_FALSE(buffer.inBuffer(0));
+  EXPECT_TRUE(buffer.inBuffer(4));
+  EXPECT_TRUE(buffer.inBuffer(5));
+}
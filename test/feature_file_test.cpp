@@ -0,0 +1,115 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include <stdio.h>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "features/cnn_feature.h"
+#include "features/feature_file.h"
+#include "gtest/gtest.h"
+
+TEST(FeatureFile, binaryRoundTrip) {
+  std::string textFile = "../test/test_data/query_features/image_0-feature.txt";
+  std::vector<double> textValues;
+  FeatureFileHeader textHeader;
+  ASSERT_TRUE(
+      loadFeatureValues(textFile, TEXT_WITH_DIMS, &textValues, &textHeader));
+  EXPECT_EQ(textValues.size(), 512 * 18 * 24);
+
+  const int dims[3] = {512, 18, 24};
+  std::string binFile = "feature_file_test.bin";
+  ASSERT_TRUE(saveBinaryFeature(binFile, textValues, dims));
+
+  std::vector<double> binValues;
+  FeatureFileHeader binHeader;
+  ASSERT_TRUE(
+      loadFeatureValues(binFile, TEXT_WITH_DIMS, &binValues, &binHeader));
+  ASSERT_EQ(binValues.size(), textValues.size());
+  for (size_t i = 0; i < textValues.size(); ++i) {
+    EXPECT_EQ(binValues[i], textValues[i]);
+  }
+  EXPECT_EQ(binHeader.dims[0], 512);
+  EXPECT_EQ(binHeader.dims[1], 18);
+  EXPECT_EQ(binHeader.dims[2], 24);
+  EXPECT_EQ(binHeader.nnz, textHeader.nnz);
+  EXPECT_NEAR(binHeader.norm, textHeader.norm, 1e-09);
+  remove(binFile.c_str());
+}
+
+TEST(FeatureFile, float32) {
+  std::vector<double> values = {0.0, 1.5, -2.25, 0.0, 3.0};
+  const int dims[3] = {1, 1, 5};
+  std::string binFile = "feature_file_test_f32.bin";
+  ASSERT_TRUE(saveBinaryFeature(binFile, values, dims, FLOAT32));
+
+  std::vector<double> loaded;
+  FeatureFileHeader header;
+  ASSERT_TRUE(loadFeatureValues(binFile, TEXT_VALUES_ONLY, &loaded, &header));
+  EXPECT_EQ(header.dtype, FLOAT32);
+  EXPECT_EQ(header.nnz, 3);
+  ASSERT_EQ(loaded.size(), values.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    EXPECT_NEAR(loaded[i], values[i], 1e-06);
+  }
+  remove(binFile.c_str());
+}
+
+TEST(FeatureFile, cnnFeatureFromBinary) {
+  std::string textFile = "../test/test_data/ref_features/image_1-feature.txt";
+  CnnFeature textFeature;
+  textFeature.loadFromFile(textFile);
+
+  const int dims[3] = {512, 18, 24};
+  std::string binFile = "feature_file_test_cnn.bin";
+  ASSERT_TRUE(saveBinaryFeature(binFile, textFeature.dim, dims));
+  CnnFeature binFeature;
+  binFeature.loadFromFile(binFile);
+
+  ASSERT_EQ(binFeature.dim.size(), textFeature.dim.size());
+  for (size_t i = 0; i < textFeature.dim.size(); ++i) {
+    ASSERT_NEAR(binFeature.dim[i], textFeature.dim[i], 1e-12);
+  }
+  EXPECT_TRUE(binFeature.bits == textFeature.bits);
+  remove(binFile.c_str());
+}
+
+TEST(FeatureFile, corruptedSize) {
+  std::vector<double> values = {1.0, 2.0, 3.0};
+  const int dims[3] = {1, 1, 3};
+  std::string binFile = "feature_file_test_corrupted.bin";
+  ASSERT_TRUE(saveBinaryFeature(binFile, values, dims));
+  // a size that overflows size * sizeof(double) to a small number
+  FeatureFileHeader header;
+  std::fstream file(binFile.c_str(),
+                    std::ios::in | std::ios::out | std::ios::binary);
+  file.read(reinterpret_cast<char *>(&header), sizeof(header));
+  header.size = (uint64_t(1) << 61) + 1;
+  file.seekp(0);
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  file.close();
+
+  std::vector<double> loaded;
+  EXPECT_FALSE(loadFeatureValues(binFile, TEXT_VALUES_ONLY, &loaded));
+  remove(binFile.c_str());
+}
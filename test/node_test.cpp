@@ -0,0 +1,83 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include <set>
+#include <vector>
+#include "gtest/gtest.h"
+#include "successor_manager/node.h"
+
+TEST(node, keyRoundTrip) {
+  uint64_t key = nodeKey(-1, 0);
+  EXPECT_EQ(nodeKeyQuId(key), -1);
+  EXPECT_EQ(nodeKeyRefId(key), 0);
+  key = nodeKey(12, 3);
+  EXPECT_NE(key, nodeKey(1, 23));
+  EXPECT_NE(std::hash<Node>()(Node(12, 3, 0.0)),
+            std::hash<Node>()(Node(1, 23, 0.0)));
+}
+
+TEST(node, nodeMap) {
+  NodeMap<double> map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(map.get(0, 0), nullptr);
+  for (int qu = -1; qu < 50; ++qu) {
+    for (int ref = 0; ref < 40; ++ref) {
+      map(qu, ref) = qu * 100 + ref;
+    }
+  }
+  EXPECT_EQ(map.size(), 51 * 40);
+  EXPECT_DOUBLE_EQ(map.at(-1, 0), -100.0);
+  EXPECT_DOUBLE_EQ(map.at(49, 39), 4939.0);
+  EXPECT_EQ(map.count(50, 0), 0);
+
+  size_t visited = 0;
+  for (const auto &entry : map) {
+    EXPECT_DOUBLE_EQ(entry.value, entry.quId() * 100 + entry.refId());
+    ++visited;
+  }
+  EXPECT_EQ(visited, map.size());
+
+  map.clear();
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(map.get(-1, 0), nullptr);
+  EXPECT_TRUE(map.begin() == map.end());
+}
+
+TEST(node, nodeSet) {
+  std::vector<Node> v = {Node(1, 0, 2.0), Node(1, 1, 3.0), Node(1, 0, 5.0)};
+  NodeSet s(v.begin(), v.end());
+  EXPECT_EQ(s.size(), 2);
+  // the first inserted node is kept
+  auto found = s.find(Node(1, 0, 0.0));
+  ASSERT_TRUE(found != s.end());
+  EXPECT_DOUBLE_EQ(found->idvCost, 2.0);
+  EXPECT_TRUE(s.find(Node(0, 1, 0.0)) == s.end());
+  EXPECT_FALSE(s.insert(Node(1, 1, 1.0)));
+  EXPECT_TRUE(s.insert(Node(2, 1, 1.0)));
+
+  std::set<int> refIds;
+  for (const Node &node : s) {
+    refIds.insert(node.quId * 10 + node.refId);
+  }
+  EXPECT_EQ(refIds, std::set<int>({10, 11, 21}));
+}
@@ -32,8 +32,7 @@
 TEST(onlineLocalizer, getProminentSuccessor) {
   OnlineLocalizer localizer;
   std::vector<Node> v = {Node(1, 0, 2.0), Node(1, 1, 3.0), Node(1, 2, 1.5)};
-  std::unordered_set<Node> s(v.begin(), v.end());
-  Node node = localizer.getProminentSuccessor(s);
+  Node node = localizer.getProminentSuccessor(v);
   EXPECT_EQ(node.quId, 1);
   EXPECT_EQ(node.refId, 2);
   EXPECT_NEAR(node.idvCost, 1.5, 1e-06);
@@ -120,6 +119,43 @@ TEST(onlineLocalizer, run) {
   EXPECT_TRUE(path[0].quId == 3 && path[0].refId == 2 && path[0].state == REAL);
 }
 
+TEST(onlineLocalizer, adaptiveFanOut) {
+  std::string path2ref = "../test/test_data/ref_features/";
+  std::string path2qu = "../test/test_data/query_features/";
+  auto onlineDatabasePtr = OnlineDatabase::Ptr(new OnlineDatabase);
+  onlineDatabasePtr->setRefFeaturesFolder(path2ref);
+  onlineDatabasePtr->setQuFeaturesFolder(path2qu);
+  onlineDatabasePtr->setBufferSize(10);
+  iDatabase::Ptr database = onlineDatabasePtr;
+
+  auto relocalizerPtr = DimensionsHashing::Ptr(new DimensionsHashing);
+  relocalizerPtr->loadIndex("../test/test_data/test_ref_hash_dim.txt");
+  relocalizerPtr->weightIndex(onlineDatabasePtr->refSize());
+  relocalizerPtr->setDatabase(onlineDatabasePtr);
+
+  auto successorManagerPtr = SuccessorManager::Ptr(new SuccessorManager);
+  successorManagerPtr->setFanOut(2);
+  successorManagerPtr->setDatabase(database);
+  successorManagerPtr->setRelocalizer(relocalizerPtr);
+
+  OnlineLocalizer localizer;
+  localizer.setQuerySize(4);
+  localizer.setSuccessorManager(successorManagerPtr);
+  localizer.setExpansionRate(0.0);  // expand everything
+  localizer.setNonMatchingCost(6.0);
+  EXPECT_FALSE(localizer.setAdaptiveFanOut(-1));
+  ASSERT_TRUE(localizer.setAdaptiveFanOut(1, 3));
+
+  localizer.run();
+  // the step of 1 ref per image is followed
+  EXPECT_TRUE(successorManagerPtr->hasStepWindow());
+  std::vector<PathElement> path = localizer.getCurrentPath();
+  ASSERT_EQ(path.size(), 4);
+  EXPECT_TRUE(path[2].quId == 1 && path[2].refId == 0 && path[2].state == REAL);
+  EXPECT_TRUE(path[1].quId == 2 && path[1].refId == 1 && path[1].state == REAL);
+  EXPECT_TRUE(path[0].quId == 3 && path[0].refId == 2 && path[0].state == REAL);
+}
+
 TEST(onlineLocalizer, processImage) {
   std::string path2ref = "../test/test_data/ref_features/";
   std::string path2qu = "../test/test_data/query_features/";
@@ -0,0 +1,189 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "database/list_dir.h"
+#include "database/online_database.h"
+#include "database/pq_database.h"
+#include "features/cnn_feature.h"
+#include "features/product_quantizer.h"
+#include "gtest/gtest.h"
+
+TEST(ProductQuantizer, clusters) {
+  std::vector<std::vector<double> > samples = {
+      {1.0, 1.1, 0.0, 0.0}, {0.9, 1.0, 0.0, 0.1}, {0.0, 0.1, 2.0, 2.1},
+      {0.1, 0.0, 1.9, 2.0}};
+  ProductQuantizer quantizer;
+  EXPECT_FALSE(quantizer.setParams(2, 300));
+  ASSERT_TRUE(quantizer.setParams(2, 2));
+  ASSERT_TRUE(quantizer.train(samples));
+  EXPECT_EQ(quantizer.codeSize(), 2);
+
+  uint8_t code0[2], code1[2], code2[2];
+  quantizer.encode(samples[0].data(), code0);
+  quantizer.encode(samples[1].data(), code1);
+  quantizer.encode(samples[2].data(), code2);
+  EXPECT_EQ(code0[0], code1[0]);
+  EXPECT_EQ(code0[1], code1[1]);
+  EXPECT_NE(code0[0], code2[0]);
+
+  std::vector<double> query = {1.0, 1.0, 1.0, 1.0};
+  std::vector<float> table;
+  quantizer.computeTable(query.data(), &table);
+  // centroids are the means of the clusters
+  EXPECT_NEAR(quantizer.innerProduct(table, code0), 2.05, 1e-05);
+  EXPECT_NEAR(quantizer.innerProduct(table, code2), 4.1, 1e-05);
+}
+
+TEST(PqDatabase, costs) {
+  std::string path2qu = "../test/test_data/query_features/";
+  std::string path2ref = "../test/test_data/ref_features/";
+  std::vector<std::string> names = listDir(path2ref);
+  std::vector<std::vector<double> > samples;
+  for (const std::string &name : names) {
+    CnnFeature feature;
+    feature.loadFromFile(name);
+    samples.push_back(feature.dim);
+  }
+  ProductQuantizer quantizer;
+  ASSERT_TRUE(quantizer.setParams(32));
+  ASSERT_TRUE(quantizer.train(samples));
+  PqReferenceStore store;
+  store.setQuantizer(quantizer);
+  for (const auto &sample : samples) {
+    store.add(sample);
+  }
+  EXPECT_EQ(store.bytesPerReference(), 36);
+  std::string storeName = "pq_database_test.pq";
+  ASSERT_TRUE(store.save(storeName));
+
+  OnlineDatabase exact;
+  exact.setQuFeaturesFolder(path2qu);
+  exact.setRefFeaturesFolder(path2ref);
+  PqDatabase database;
+  database.setQuFeaturesFolder(path2qu);
+  ASSERT_TRUE(database.loadReferences(storeName));
+  ASSERT_EQ(database.refSize(), exact.refSize());
+  // as many centroids as references, so every reference is encoded exactly
+  for (int qu = 0; qu < 4; ++qu) {
+    for (int ref = 0; ref < exact.refSize(); ++ref) {
+      EXPECT_NEAR(database.getCost(qu, ref), exact.getCost(qu, ref), 1e-04);
+    }
+  }
+
+  PqDatabase reranked;
+  reranked.setQuFeaturesFolder(path2qu);
+  reranked.setRefFeaturesFolder(path2ref);
+  ASSERT_TRUE(reranked.loadReferences(storeName));
+  reranked.setExactRerank(2);
+  // the same costs are re-ranked in any order of requests
+  PqDatabase reversed;
+  reversed.setQuFeaturesFolder(path2qu);
+  reversed.setRefFeaturesFolder(path2ref);
+  ASSERT_TRUE(reversed.loadReferences(storeName));
+  reversed.setExactRerank(2);
+  std::vector<int> refIds(exact.refSize());
+  for (int ref = 0; ref < exact.refSize(); ++ref) {
+    refIds[ref] = exact.refSize() - 1 - ref;
+  }
+  for (int qu = 0; qu < 4; ++qu) {
+    std::vector<double> costs(refIds.size());
+    reversed.getCosts(qu, refIds.data(), refIds.size(), costs.data());
+    std::vector<double> sorted = costs;
+    std::sort(sorted.begin(), sorted.end());
+    for (int ref = 0; ref < exact.refSize(); ++ref) {
+      double cost = reranked.getCost(qu, ref);
+      EXPECT_EQ(cost, costs[exact.refSize() - 1 - ref]);
+      // the best matches are exact
+      if (cost <= sorted[1]) {
+        EXPECT_NEAR(cost, exact.getCost(qu, ref), 1e-09);
+      }
+    }
+  }
+  EXPECT_EQ(reranked.rerankedCount(), 4 * 2);
+  EXPECT_EQ(reversed.rerankedCount(), 4 * 2);
+
+  // invalid indices are reported as for the other databases
+  EXPECT_EQ(database.getCost(-1, 0), -1);
+  EXPECT_EQ(database.getCost(4, 0), -1);
+  EXPECT_EQ(database.getCost(0, -1), -1);
+  EXPECT_EQ(database.getCost(0, database.refSize()), -1);
+
+  // only the codes are there, nothing to prefetch for the references
+  PqDatabase prefetching;
+  prefetching.setQuFeaturesFolder(path2qu);
+  ASSERT_TRUE(prefetching.loadReferences(storeName));
+  prefetching.setPrefetching(2);
+  for (int qu = 0; qu < 4; ++qu) {
+    prefetching.setSearchFocus(qu, 1, 2);
+    EXPECT_EQ(prefetching.getCost(qu, 1), database.getCost(qu, 1));
+  }
+  EXPECT_EQ(prefetching.refBufferStats().misses, 0);
+  remove(storeName.c_str());
+}
+
+TEST(PqDatabase, corruptedStore) {
+  std::vector<std::vector<double> > samples = {
+      {0.0, 0.1, 1.0, 1.1}, {0.1, 0.0, 1.1, 1.0}, {5.0, 5.1, 0.0, 0.1}};
+  ProductQuantizer quantizer;
+  ASSERT_TRUE(quantizer.setParams(2, 2));
+  ASSERT_TRUE(quantizer.train(samples));
+  PqReferenceStore store;
+  store.setQuantizer(quantizer);
+  for (const auto &sample : samples) {
+    store.add(sample);
+  }
+  std::string storeName = "pq_store_corrupted_test.pq";
+  ASSERT_TRUE(store.save(storeName));
+  std::ifstream in(storeName.c_str(), std::ios::binary);
+  std::vector<char> data((std::istreambuf_iterator<char>(in)),
+                         std::istreambuf_iterator<char>());
+  in.close();
+  ASSERT_TRUE(PqReferenceStore().load(storeName));
+
+  // the count is followed by the norms and the codes
+  size_t countPos =
+      data.size() - samples.size() * store.bytesPerReference() - 8;
+  for (uint64_t count : {uint64_t(1) << 62, uint64_t(4)}) {
+    std::vector<char> corrupted = data;
+    memcpy(corrupted.data() + countPos, &count, sizeof(count));
+    std::ofstream out(storeName.c_str(), std::ios::binary);
+    out.write(corrupted.data(), corrupted.size());
+    out.close();
+    PqReferenceStore loaded;
+    EXPECT_FALSE(loaded.load(storeName));
+    EXPECT_EQ(loaded.size(), 0);
+  }
+  // truncated codes
+  std::ofstream out(storeName.c_str(), std::ios::binary);
+  out.write(data.data(), data.size() - 1);
+  out.close();
+  EXPECT_FALSE(PqReferenceStore().load(storeName));
+  remove(storeName.c_str());
+}
@@ -0,0 +1,112 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include "database/online_database.h"
+#include "gtest/gtest.h"
+#include "online_localizer/online_localizer.h"
+#include "relocalizers/dimensions_hashing.h"
+#include "successor_manager/successor_manager.h"
+#include "tools/thread_pool/thread_pool.h"
+
+namespace {
+std::vector<PathElement> runLocalizer(int threads, bool rowBatching) {
+  auto database = OnlineDatabase::Ptr(new OnlineDatabase);
+  database->setRefFeaturesFolder("../test/test_data/ref_features/");
+  database->setQuFeaturesFolder("../test/test_data/query_features/");
+  database->setBufferSize(10);
+
+  auto relocalizer = DimensionsHashing::Ptr(new DimensionsHashing);
+  relocalizer->loadIndex("../test/test_data/test_ref_hash_dim.txt");
+  relocalizer->weightIndex(database->refSize());
+  relocalizer->setDatabase(database);
+
+  auto successorManager = SuccessorManager::Ptr(new SuccessorManager);
+  successorManager->setFanOut(1);
+  successorManager->setDatabase(database);
+  successorManager->setRelocalizer(relocalizer);
+  successorManager->setNumThreads(threads);
+
+  OnlineLocalizer localizer;
+  localizer.setQuerySize(4);
+  localizer.setSuccessorManager(successorManager);
+  localizer.setExpansionRate(0.0);  // expand everything
+  localizer.setNonMatchingCost(6.0);
+  localizer.setRowBatching(rowBatching);
+  localizer.run();
+  return localizer.getCurrentPath();
+}
+}  // namespace
+
+TEST(ThreadPool, parallelFor) {
+  ThreadPool pool(4);
+  EXPECT_EQ(pool.size(), 4);
+  for (int round = 0; round < 20; ++round) {
+    std::vector<int> visits(1000, 0);
+    std::atomic<int> sum(0);
+    pool.parallelFor(visits.size(), [&](int i) {
+      visits[i]++;
+      sum += i;
+    });
+    EXPECT_EQ(sum, 999 * 1000 / 2);
+    for (int v : visits) {
+      ASSERT_EQ(v, 1);
+    }
+  }
+  pool.parallelFor(0, [](int) { FAIL(); });
+}
+
+TEST(SuccessorManager, precomputeSuccessors) {
+  auto database = OnlineDatabase::Ptr(new OnlineDatabase);
+  database->setRefFeaturesFolder("../test/test_data/ref_features/");
+  database->setQuFeaturesFolder("../test/test_data/query_features/");
+  database->setBufferSize(10);
+  SuccessorManager successorManager;
+  successorManager.setFanOut(1);
+  successorManager.setDatabase(database);
+  successorManager.setNumThreads(3);
+
+  std::vector<Node> parents = {Node(1, 0, 0.0), Node(1, 3, 0.0)};
+  // [0, 1] and [2, 3]
+  EXPECT_EQ(successorManager.precomputeSuccessors(parents), 4);
+  std::vector<Node> successors;
+  successorManager.getSuccessors(Node(1, 2, 0.0), &successors);
+  ASSERT_EQ(successors.size(), 3);
+  for (const Node &node : successors) {
+    EXPECT_DOUBLE_EQ(node.idvCost, database->getCost(2, node.refId));
+  }
+}
+
+TEST(onlineLocalizer, rowBatchingKeepsPath) {
+  std::vector<PathElement> serial = runLocalizer(1, false);
+  std::vector<PathElement> batched = runLocalizer(4, true);
+  ASSERT_EQ(serial.size(), 4);
+  ASSERT_EQ(serial.size(), batched.size());
+  for (size_t i = 0; i < serial.size(); ++i) {
+    EXPECT_EQ(serial[i].quId, batched[i].quId);
+    EXPECT_EQ(serial[i].refId, batched[i].refId);
+    EXPECT_EQ(serial[i].state, batched[i].state);
+  }
+}
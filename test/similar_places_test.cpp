@@ -0,0 +1,79 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include <stdio.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "database/online_database.h"
+#include "gtest/gtest.h"
+#include "successor_manager/similar_places.h"
+#include "successor_manager/successor_manager.h"
+
+TEST(SimilarPlaces, textAndBinary) {
+  SimilarPlaces text;
+  ASSERT_TRUE(text.load("../test/test_data/simPlaces_test.txt"));
+  // 0-2 and 0-3 in both directions, the duplicates are dropped
+  EXPECT_EQ(text.links(), 4);
+  EXPECT_EQ(text.size(), 4);
+  std::vector<uint32_t> sims(text.begin(0), text.end(0));
+  EXPECT_EQ(sims, std::vector<uint32_t>({2, 3}));
+  EXPECT_TRUE(text.begin(1) == text.end(1));
+  EXPECT_TRUE(text.begin(10) == text.end(10));
+  EXPECT_TRUE(text.begin(-1) == text.end(-1));
+
+  std::string filename = "sim_places_test.bin";
+  ASSERT_TRUE(text.save(filename));
+  EXPECT_TRUE(SimilarPlaces::isBinary(filename));
+  EXPECT_FALSE(SimilarPlaces::isBinary("../test/test_data/simPlaces_test.txt"));
+  SimilarPlaces binary;
+  ASSERT_TRUE(binary.load(filename));
+  EXPECT_EQ(binary.links(), text.links());
+  sims.assign(binary.begin(3), binary.end(3));
+  EXPECT_EQ(sims, std::vector<uint32_t>({0}));
+  remove(filename.c_str());
+}
+
+TEST(SimilarPlaces, mergedRanges) {
+  auto database = OnlineDatabase::Ptr(new OnlineDatabase);
+  database->setRefFeaturesFolder("../test/test_data/ref_features/");
+  database->setQuFeaturesFolder("../test/test_data/query_features/");
+  database->setBufferSize(10);
+
+  SuccessorManager successorManager;
+  successorManager.setDatabase(database);
+  successorManager.setFanOut(1);
+  successorManager.setSimilarPlaces("../test/test_data/simPlaces_test.txt");
+  // windows [0, 1], [1, 3] and [2, 4] form one range
+  auto ranges = successorManager.successorRanges(0);
+  ASSERT_EQ(ranges.size(), 1);
+  EXPECT_EQ(ranges[0].first, 0);
+  EXPECT_EQ(ranges[0].second, std::min(4, database->refSize() - 1));
+
+  std::vector<Node> successors;
+  successorManager.getSuccessors(Node(1, 0, 0.0), &successors);
+  ASSERT_EQ(successors.size(), ranges[0].second + 1);
+  for (size_t i = 0; i < successors.size(); ++i) {
+    EXPECT_EQ(successors[i].refId, static_cast<int>(i));
+  }
+}
@@ -0,0 +1,120 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "database/sparse_cost_matrix.h"
+#include "database/sparse_cost_matrix_database.h"
+#include "gtest/gtest.h"
+
+TEST(SparseCostMatrix, saveAndLoad) {
+  int rows = 3, cols = 6;
+  std::vector<float> sims = {0.9f, 0.1f, 0.5f, 0.0f, 0.3f, 0.7f,  //
+                             0.1f, 0.1f, 0.1f, 0.1f, 0.1f, 0.1f,  //
+                             0.4f, 0.6f, 0.2f, 0.8f, 0.3f, 0.5f};
+  SparseCostMatrixBuilder builder(cols, 0.45f);
+  for (int r = 0; r < rows; ++r) {
+    builder.addRow(&sims[r * cols]);
+  }
+  EXPECT_EQ(builder.rows(), rows);
+  EXPECT_EQ(builder.nonZeros(), 6);
+  std::string name = "sparse_cost_matrix_test.csr";
+  ASSERT_TRUE(builder.save(name));
+  EXPECT_TRUE(SparseCostMatrix::isSparseCostMatrix(name));
+  EXPECT_FALSE(SparseCostMatrix::isSparseCostMatrix(
+      "../test/test_data/cost_matrix_3_5.txt"));
+
+  SparseCostMatrixDatabase database;
+  ASSERT_TRUE(database.loadFromFile(name));
+  EXPECT_EQ(database.refSize(), cols);
+  EXPECT_NEAR(database.fallbackCost(), 1. / 0.45, 1e-5);
+  std::vector<int> refIds = {0, 1, 2, 3, 4, 5, 3, 0};
+  std::vector<double> batch(refIds.size());
+  for (int r = 0; r < rows; ++r) {
+    database.getCosts(r, refIds.data(), refIds.size(), batch.data());
+    for (size_t i = 0; i < refIds.size(); ++i) {
+      float sim = sims[r * cols + refIds[i]];
+      double expected = sim >= 0.45f ? 1. / sim : database.fallbackCost();
+      EXPECT_NEAR(database.getCost(r, refIds[i]), expected, 1e-6);
+      EXPECT_EQ(batch[i], database.getCost(r, refIds[i]));
+    }
+  }
+  database.setFallbackCost(10.0);
+  EXPECT_DOUBLE_EQ(database.getCost(1, 2), 10.0);
+  EXPECT_EQ(database.getCost(3, 0), -1);
+  remove(name.c_str());
+}
+
+TEST(SparseCostMatrix, corrupted) {
+  int cols = 6;
+  std::vector<float> sims = {0.9f, 0.1f, 0.5f, 0.0f, 0.3f, 0.7f,  //
+                             0.1f, 0.1f, 0.1f, 0.1f, 0.1f, 0.1f,  //
+                             0.4f, 0.6f, 0.2f, 0.8f, 0.3f, 0.5f};
+  SparseCostMatrixBuilder builder(cols, 0.45f);
+  for (int r = 0; r < 3; ++r) {
+    builder.addRow(&sims[r * cols]);
+  }
+  std::string name = "sparse_cost_matrix_corrupted_test.csr";
+  ASSERT_TRUE(builder.save(name));
+  std::ifstream in(name.c_str(), std::ios::binary);
+  std::string data((std::istreambuf_iterator<char>(in)),
+                   std::istreambuf_iterator<char>());
+  in.close();
+  ASSERT_TRUE(SparseCostMatrix().open(name));
+
+  // the row starts follow the header, then the 6 column ids
+  size_t rowStarts = sizeof(SparseCostMatrixHeader);
+  size_t colIds = rowStarts + 4 * sizeof(uint64_t);
+  struct Patch {
+    size_t pos;
+    uint64_t value;
+    size_t size;
+  };
+  std::vector<Patch> patches = {
+      {offsetof(SparseCostMatrixHeader, rows), uint64_t(1) << 61, 8},
+      {offsetof(SparseCostMatrixHeader, cols), uint64_t(1) << 32, 8},
+      {offsetof(SparseCostMatrixHeader, nonZeros), uint64_t(1) << 62, 8},
+      {rowStarts, 1, 8},
+      {rowStarts + 8, 4, 8},
+      {rowStarts + 3 * 8, 5, 8},
+      {colIds, 6, 4},
+      {colIds + 4, 0, 4}};
+  for (const Patch &patch : patches) {
+    std::string corrupted = data;
+    memcpy(&corrupted[patch.pos], &patch.value, patch.size);
+    std::ofstream out(name.c_str(), std::ios::binary);
+    out.write(corrupted.data(), corrupted.size());
+    out.close();
+    EXPECT_FALSE(SparseCostMatrix().open(name)) << patch.pos;
+  }
+  std::ofstream out(name.c_str(), std::ios::binary);
+  out.write(data.data(), data.size() - 1);
+  out.close();
+  EXPECT_FALSE(SparseCostMatrix().open(name));
+  remove(name.c_str());
+}
@@ -0,0 +1,182 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include "online_localizer/streaming_localizer.h"
+#include <string>
+#include <thread>
+#include <vector>
+#include "database/list_dir.h"
+#include "database/online_database.h"
+#include "features/cnn_feature.h"
+#include "gtest/gtest.h"
+#include "online_localizer/query_stream.h"
+#include "relocalizers/dimensions_hashing.h"
+#include "successor_manager/successor_manager.h"
+
+namespace {
+/** the setup of the onlineLocalizer.run test, without the query features **/
+void setUpLocalizer(StreamingLocalizer *localizer,
+                    OnlineDatabase::Ptr onlineDatabasePtr) {
+  onlineDatabasePtr->setRefFeaturesFolder("../test/test_data/ref_features/");
+  onlineDatabasePtr->setBufferSize(10);
+
+  auto relocalizerPtr = DimensionsHashing::Ptr(new DimensionsHashing);
+  relocalizerPtr->loadIndex("../test/test_data/test_ref_hash_dim.txt");
+  relocalizerPtr->weightIndex(onlineDatabasePtr->refSize());
+  relocalizerPtr->setDatabase(onlineDatabasePtr);
+
+  auto successorManagerPtr = SuccessorManager::Ptr(new SuccessorManager);
+  successorManagerPtr->setFanOut(1);
+  successorManagerPtr->setDatabase(onlineDatabasePtr);
+  successorManagerPtr->setRelocalizer(relocalizerPtr);
+
+  localizer->setDatabase(onlineDatabasePtr);
+  localizer->setSuccessorManager(successorManagerPtr);
+  localizer->setExpansionRate(0.0);  // expand everything
+  localizer->setNonMatchingCost(6.0);
+}
+
+void expectPath(const StreamingLocalizer &localizer) {
+  std::vector<PathElement> path = localizer.getCurrentPath();
+  ASSERT_EQ(path.size(), 4);
+  EXPECT_TRUE(path[3].quId == 0 && path[3].refId == 0 &&
+              path[3].state == HIDDEN);
+  EXPECT_TRUE(path[2].quId == 1 && path[2].refId == 0 && path[2].state == REAL);
+  EXPECT_TRUE(path[1].quId == 2 && path[1].refId == 1 && path[1].state == REAL);
+  EXPECT_TRUE(path[0].quId == 3 && path[0].refId == 2 && path[0].state == REAL);
+}
+}  // namespace
+
+TEST(QueryStream, backpressure) {
+  QueryStream stream(2);
+  EXPECT_TRUE(stream.tryPush("a"));
+  EXPECT_TRUE(stream.tryPush("b"));
+  // full
+  EXPECT_FALSE(stream.tryPush("c"));
+  EXPECT_EQ(stream.size(), 2);
+
+  QueryStream::Query query;
+  ASSERT_TRUE(stream.pop(&query));
+  EXPECT_EQ(query.path, "a");
+  EXPECT_TRUE(stream.tryPush(iFeature::ConstPtr(new CnnFeature)));
+  stream.close();
+  EXPECT_FALSE(stream.push("d"));
+  // the queued queries are still taken
+  ASSERT_TRUE(stream.pop(&query));
+  EXPECT_EQ(query.path, "b");
+  ASSERT_TRUE(stream.pop(&query));
+  EXPECT_TRUE(query.feature != nullptr);
+  EXPECT_FALSE(stream.pop(&query));
+}
+
+TEST(StreamingLocalizer, files) {
+  auto databasePtr = OnlineDatabase::Ptr(new OnlineDatabase);
+  StreamingLocalizer localizer;
+  setUpLocalizer(&localizer, databasePtr);
+  auto stream = std::make_shared<QueryStream>(1);
+  localizer.setQueryStream(stream);
+  std::vector<int> matched;
+  localizer.setMatchCallback(
+      [&matched](const PathElement &match) { matched.push_back(match.quId); });
+
+  // the camera is faster than the localizer, it waits for the queue
+  std::thread camera([stream] {
+    for (const std::string &name :
+         listDir("../test/test_data/query_features/")) {
+      stream->push(name);
+    }
+    stream->close();
+  });
+  localizer.run();
+  camera.join();
+
+  EXPECT_EQ(localizer.processedCount(), 4);
+  EXPECT_EQ(matched, std::vector<int>({0, 1, 2, 3}));
+  expectPath(localizer);
+}
+
+TEST(StreamingLocalizer, features) {
+  auto databasePtr = OnlineDatabase::Ptr(new OnlineDatabase);
+  StreamingLocalizer localizer;
+  setUpLocalizer(&localizer, databasePtr);
+  auto stream = std::make_shared<QueryStream>();
+  localizer.setQueryStream(stream);
+  for (const std::string &name :
+       listDir("../test/test_data/query_features/")) {
+    auto feature = std::make_shared<CnnFeature>();
+    feature->loadFromFile(name);
+    stream->push(feature);
+  }
+  stream->close();
+  localizer.run();
+  expectPath(localizer);
+}
+
+TEST(StreamingLocalizer, boundedHistory) {
+  std::vector<std::string> names =
+      listDir("../test/test_data/query_features/");
+  std::vector<iFeature::ConstPtr> features;
+  for (const std::string &name : names) {
+    auto feature = std::make_shared<CnnFeature>();
+    feature->loadFromFile(name);
+    features.push_back(feature);
+  }
+  const int frames = 60;
+  const int history = 5;
+  size_t unboundedSize = 0;
+  for (int rows : {0, history}) {
+    auto databasePtr = OnlineDatabase::Ptr(new OnlineDatabase);
+    // the costs of the rows within the history are recomputed from the
+    // streamed features
+    databasePtr->setCostRetention(2);
+    StreamingLocalizer localizer;
+    setUpLocalizer(&localizer, databasePtr);
+    ASSERT_TRUE(localizer.setHistory(rows));
+    auto stream = std::make_shared<QueryStream>();
+    localizer.setQueryStream(stream);
+    int matched = 0;
+    localizer.setMatchCallback([&matched](const PathElement &) { ++matched; });
+    std::thread camera([stream, &features, frames] {
+      for (int frame = 0; frame < frames; ++frame) {
+        stream->push(features[frame % features.size()]);
+      }
+      stream->close();
+    });
+    localizer.run();
+    camera.join();
+    EXPECT_EQ(matched, frames);
+    if (rows == 0) {
+      EXPECT_EQ(localizer.oldestRow(), -1);
+      EXPECT_EQ(localizer.getCurrentPath().size(), frames);
+      unboundedSize = localizer.graphSize();
+      continue;
+    }
+    // between history and 2 * history rows are kept
+    EXPECT_GE(localizer.oldestRow(), frames - 1 - 2 * history);
+    EXPECT_LE(localizer.getCurrentPath().size(), 2 * history);
+    EXPECT_GE(localizer.getCurrentPath().size(), history);
+    EXPECT_LT(localizer.graphSize() * 4, unboundedSize);
+  }
+  StreamingLocalizer localizer;
+  EXPECT_FALSE(localizer.setHistory(2));
+}
@@ -22,8 +22,10 @@
 **/
 
 #include "successor_manager/successor_manager.h"
+#include <algorithm>
 #include <iostream>
 #include <string>
+#include <vector>
 #include "database/online_database.h"
 #include "relocalizers/dimensions_hashing.h"
 #include "gtest/gtest.h"
@@ -50,14 +52,14 @@ TEST(successorManager, get_successors_source) {
   SuccessorManager successorManager;
   successorManager.setDatabase(onlineDatabasePtr);
   successorManager.setRelocalizer(relocalizerPtr);
-  std::unordered_set<Node> succes =
-      successorManager.getSuccessorsIfLost(Node(-1, 0, 0.0));
+  std::vector<Node> succes;
+  successorManager.getSuccessorsIfLost(Node(-1, 0, 0.0), &succes);
   for (const Node &node : succes) {
     node.print();
   }
 
   Node node(0, 0, 6.68232);
-  EXPECT_TRUE(succes.find(node) != succes.end());
+  EXPECT_TRUE(std::find(succes.begin(), succes.end(), node) != succes.end());
 }
 
 TEST(successorManager, get_successors) {
@@ -77,32 +79,32 @@ TEST(successorManager, get_successors) {
   SuccessorManager successorManager;
   successorManager.setDatabase(database);
   successorManager.setFanOut(1);
-  std::unordered_set<Node> succes =
-      successorManager.getSuccessors(Node(1, 2, 0.0));
+  std::vector<Node> succes;
+  successorManager.getSuccessors(Node(1, 2, 0.0), &succes);
   for (const Node &node : succes) {
     node.print();
   }
   ASSERT_TRUE(succes.size() > 0);
 
   Node node(2, 1, 5.88258);
-  EXPECT_TRUE(succes.find(node) != succes.end());
+  EXPECT_TRUE(std::find(succes.begin(), succes.end(), node) != succes.end());
 
   node.set(2, 2, 9.01962);
-  EXPECT_TRUE(succes.find(node) != succes.end());
+  EXPECT_TRUE(std::find(succes.begin(), succes.end(), node) != succes.end());
 
   node.set(2, 3, 5.88258);
-  EXPECT_TRUE(succes.find(node) != succes.end());
+  EXPECT_TRUE(std::find(succes.begin(), succes.end(), node) != succes.end());
 
-  succes = successorManager.getSuccessors(Node(0, 0, 0.0));
+  successorManager.getSuccessors(Node(0, 0, 0.0), &succes);
   for (const Node &node : succes) {
     node.print();
   }
 
   node.set(1, 0, 5.18384);
-  EXPECT_TRUE(succes.find(node) != succes.end());
+  EXPECT_TRUE(std::find(succes.begin(), succes.end(), node) != succes.end());
 
   node.set(1, 1, 6.78146);
-  EXPECT_TRUE(succes.find(node) != succes.end());
+  EXPECT_TRUE(std::find(succes.begin(), succes.end(), node) != succes.end());
 }
 
 TEST(successorManager, get_successors_simPlaces) {
@@ -118,16 +120,82 @@ TEST(successorManager, get_successors_simPlaces) {
   successorManager.setDatabase(database);
   successorManager.setFanOut(0);
   successorManager.setSimilarPlaces("../test/test_data/simPlaces_test.txt");
-  std::unordered_set<Node> succes =
-      successorManager.getSuccessors(Node(1, 2, 0.0));
+  std::vector<Node> succes;
+  successorManager.getSuccessors(Node(1, 2, 0.0), &succes);
   for (const Node &node : succes) {
     node.print();
   }
 
   Node node;
   node.set(2, 2, 0.0);
-  EXPECT_TRUE(succes.find(node) != succes.end());
+  EXPECT_TRUE(std::find(succes.begin(), succes.end(), node) != succes.end());
 
   node.set(2, 0, 0.0);
-  EXPECT_TRUE(succes.find(node) != succes.end());
+  EXPECT_TRUE(std::find(succes.begin(), succes.end(), node) != succes.end());
+}
+
+TEST(successorManager, get_successors_reuses_buffer) {
+  std::string path2ref = "../test/test_data/ref_features/";
+  std::string path2qu = "../test/test_data/query_features/";
+  auto onlineDatabasePtr = OnlineDatabase::Ptr(new OnlineDatabase);
+  onlineDatabasePtr->setRefFeaturesFolder(path2ref);
+  onlineDatabasePtr->setQuFeaturesFolder(path2qu);
+  onlineDatabasePtr->setBufferSize(10);
+
+  iDatabase::Ptr database = onlineDatabasePtr;
+  SuccessorManager successorManager;
+  successorManager.setDatabase(database);
+  successorManager.setFanOut(1);
+  // the windows around 0, 2 and 3 overlap
+  successorManager.setSimilarPlaces("../test/test_data/simPlaces_test.txt");
+  std::vector<Node> succes;
+  successorManager.getSuccessors(Node(1, 0, 0.0), &succes);
+  ASSERT_FALSE(succes.empty());
+  for (size_t i = 1; i < succes.size(); ++i) {
+    EXPECT_LT(succes[i - 1].refId, succes[i].refId);
+  }
+  EXPECT_EQ(succes.front().refId, 0);
+
+  const Node *data = succes.data();
+  size_t capacity = succes.capacity();
+  successorManager.getSuccessors(Node(0, 0, 0.0), &succes);
+  ASSERT_FALSE(succes.empty());
+  EXPECT_EQ(succes.data(), data);
+  EXPECT_EQ(succes.capacity(), capacity);
+  for (const Node &node : succes) {
+    EXPECT_EQ(node.quId, 1);
+  }
+}
+
+TEST(successorManager, step_window) {
+  std::string path2ref = "../test/test_data/ref_features/";
+  std::string path2qu = "../test/test_data/query_features/";
+  auto onlineDatabasePtr = OnlineDatabase::Ptr(new OnlineDatabase);
+  onlineDatabasePtr->setRefFeaturesFolder(path2ref);
+  onlineDatabasePtr->setQuFeaturesFolder(path2qu);
+  onlineDatabasePtr->setBufferSize(10);
+
+  SuccessorManager successorManager;
+  successorManager.setDatabase(onlineDatabasePtr);
+  successorManager.setFanOut(3);
+  std::vector<Node> succes;
+  successorManager.getSuccessors(Node(1, 1, 0.0), &succes);
+  EXPECT_EQ(succes.size(), 4);
+
+  // moving forward by 1 or 2 refs
+  successorManager.setStepWindow(1, 2);
+  successorManager.getSuccessors(Node(1, 1, 0.0), &succes);
+  ASSERT_EQ(succes.size(), 2);
+  EXPECT_EQ(succes[0].refId, 2);
+  EXPECT_EQ(succes[1].refId, 3);
+
+  // predicted beyond the fan out, clipped to its border
+  successorManager.setStepWindow(5, 7);
+  successorManager.getSuccessors(Node(1, 0, 0.0), &succes);
+  ASSERT_EQ(succes.size(), 1);
+  EXPECT_EQ(succes[0].refId, 3);
+
+  successorManager.resetStepWindow();
+  successorManager.getSuccessors(Node(1, 1, 0.0), &succes);
+  EXPECT_EQ(succes.size(), 4);
 }
@@ -0,0 +1,123 @@
+/** vpr_relocalization: a library for visual place recognition in changing 
+** environments with efficient relocalization step.
+** Copyright (c) 2017 O. Vysotska, C. Stachniss, University of Bonn
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+** copies of the Software, and to permit persons to whom the Software is
+** furnished to do so, subject to the following conditions:
+**
+** The above copyright notice and this permission notice shall be included in
+** all copies or substantial portions of the Software.
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+** IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+** FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+** AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+** LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+** OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+** SOFTWARE.
+**/
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+#include "database/cost_matrix_database.h"
+#include "database/tiled_cost_matrix_database.h"
+#include "gtest/gtest.h"
+
+TEST(TiledCostMatrix, sameCosts) {
+  int rows = 70, cols = 90;
+  std::vector<float> values(rows * cols);
+  srand(7);
+  for (float &v : values) {
+    v = rand() / float(RAND_MAX);
+  }
+  values[5] = 0.f;
+  std::string binName = "tiled_test.bin";
+  std::string tilesName = "tiled_test.tiles";
+  ASSERT_TRUE(saveCostMatrix(binName, values.data(), rows, cols));
+  CostMatrixFile file;
+  ASSERT_TRUE(file.open(binName));
+  ASSERT_TRUE(saveTiledCostMatrix(file, tilesName, 16));
+  EXPECT_TRUE(TiledCostMatrix::isTiledCostMatrix(tilesName));
+  EXPECT_FALSE(TiledCostMatrix::isTiledCostMatrix(binName));
+
+  CostMatrixDatabase full;
+  ASSERT_TRUE(full.loadFromFile(binName));
+  TiledCostMatrixDatabase tiled;
+  ASSERT_TRUE(tiled.loadFromFile(tilesName));
+  tiled.setCacheSize(3);
+  EXPECT_EQ(tiled.refSize(), cols);
+
+  for (int qu = 0; qu < rows; ++qu) {
+    tiled.setSearchFocus(qu, qu, 5);
+    for (int ref = 0; ref < cols; ++ref) {
+      EXPECT_EQ(tiled.getCost(qu, ref), full.getCost(qu, ref));
+    }
+  }
+  std::vector<int> refIds = {89, 0, 17};
+  std::vector<double> costs(refIds.size());
+  tiled.getCosts(69, refIds.data(), refIds.size(), costs.data());
+  for (size_t i = 0; i < refIds.size(); ++i) {
+    EXPECT_EQ(costs[i], full.getCost(69, refIds[i]));
+  }
+  // 5 x 6 tiles, every row of tiles is read once per query row. The last
+  // tile is still cached for the batch
+  EXPECT_EQ(tiled.tileStats().misses, rows * 6 + 2);
+  EXPECT_GT(tiled.tileStats().hits, tiled.tileStats().misses);
+  remove(binName.c_str());
+  remove(tilesName.c_str());
+}
+
+TEST(TiledCostMatrix, corrupted) {
+  int rows = 20, cols = 30;
+  std::vector<float> values(rows * cols, 0.5f);
+  std::string binName = "tiled_corrupted_test.bin";
+  std::string tilesName = "tiled_corrupted_test.tiles";
+  ASSERT_TRUE(saveCostMatrix(binName, values.data(), rows, cols));
+  CostMatrixFile file;
+  ASSERT_TRUE(file.open(binName));
+  ASSERT_TRUE(saveTiledCostMatrix(file, tilesName, 16));
+  std::ifstream in(tilesName.c_str(), std::ios::binary);
+  std::string data((std::istreambuf_iterator<char>(in)),
+                   std::istreambuf_iterator<char>());
+  in.close();
+  ASSERT_TRUE(TiledCostMatrix().open(tilesName));
+
+  std::vector<std::pair<size_t, uint64_t> > patches = {
+      {offsetof(TiledCostMatrixHeader, rows), uint64_t(1) << 31},
+      {offsetof(TiledCostMatrixHeader, cols), uint64_t(1) << 40},
+      {offsetof(TiledCostMatrixHeader, rows), 33}};
+  for (const auto &patch : patches) {
+    std::string corrupted = data;
+    memcpy(&corrupted[patch.first], &patch.second, sizeof(uint64_t));
+    std::ofstream out(tilesName.c_str(), std::ios::binary);
+    out.write(corrupted.data(), corrupted.size());
+    out.close();
+    EXPECT_FALSE(TiledCostMatrix().open(tilesName));
+  }
+  uint32_t tileSize = 1u << 31;
+  std::string corrupted = data;
+  memcpy(&corrupted[offsetof(TiledCostMatrixHeader, tileSize)], &tileSize,
+         sizeof(tileSize));
+  std::ofstream out(tilesName.c_str(), std::ios::binary);
+  out.write(corrupted.data(), corrupted.size());
+  out.close();
+  EXPECT_FALSE(TiledCostMatrix().open(tilesName));
+  // the last tile is cut
+  out.open(tilesName.c_str(), std::ios::binary);
+  out.write(data.data(), data.size() - sizeof(float));
+  out.close();
+  EXPECT_FALSE(TiledCostMatrix().open(tilesName));
+  remove(binName.c_str());
+  remove(tilesName.c_str());
+}